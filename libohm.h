@@ -1,1239 +1,7125 @@
-/*
- * LibOhm: A Header-Only Ciruit Simulation Library
- * Copyright (C) 2026 H.J.Xie
- * 
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- * 
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- * 
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
- * SOFTWARE.
-*/
-
-/**
-* @file
-* @brief        LibOhm Header File.
-* @details      LibOhm is a lightweight real-time circuit simulation library.
-* @author       H.J.Xie
-* @date         2026/01/15
-* @version      v1.0
-*/
-
-/*===========================================================================*/
-#ifndef LIBOHM_H                        /*| Include Guards allow including  |*/
-#define LIBOHM_H                        /*| this header file multiple times.|*/
-/*===========================================================================*/
-
-/*====================== Part 1. Dependency =================================*/
-
-#include <stdlib.h>                     /** Function Used: malloc(), free()  */
-
-/*====================== Part 2. Macro Defination ===========================*/
-
-#define OMMALLOC(x) malloc(x)           /** Memory allocation function       */
-#define OMFREE(x)   free(x)             /** Memory free function             */
-#define OMABS(x)    ((x)<0?-(x):(x))    /** Absolute value function          */
-#define OMTYP_UN    0                   /** Branch type is unknown           */
-#define OMTYP_X0    1                   /** Branch contains X/E/H            */
-#define OMTYP_X1    2                   /** Branch contains X/E/H/V          */
-#define OMTYP_X2    3                   /** Branch contains X/E/H/V/L/Q      */
-#define OMTYP_X3    4                   /** Branch contains X/E/H/V/L/M/Q/A  */
-#define OMTYP_Y0    5                   /** Branch contains Y/F/G            */
-#define OMTYP_Y1    6                   /** Branch contains Y/F/G/I          */
-#define OMTYP_Y2    7                   /** Branch contains Y/F/G/I/C/P      */
-#define OMTYP_Y3    8                   /** Branch contains Y/F/G/I/C/N/P/B  */
-#define OMTYP_SW    9                   /** Branch contains Y/F/G/I/S        */
-
-/*====================== Part 3. Type Defination ============================*/
-
-typedef int    OmInt;                   /** Integer Type that LibOhm uses    */
-typedef double OmFlt;                   /** Float Type that LibOhm uses      */
-typedef struct OmCir {                  /** Circuit Information Structure    */
-    /*======== Group 0: General Information =================================*/
-    OmInt  numN   ;                     /** Number of nodes (excluding GND)  */
-    OmInt  numB   ;                     /** Number of branches               */
-    OmInt  numM   ;                     /** Number of meters                 */
-    OmInt  numX   ;                     /** Number of X-type branches        */
-    OmInt  numC   ;                     /** Number of branches after cutting */
-    OmFlt  timStp ;                     /** Simulation time step             */
-    /*======== Group 1: Setup Information ===================================*/
-    OmInt* vecBn1 ;                     /** Node 1 of branch           [b]-1 */
-    OmInt* vecBn2 ;                     /** Node 2 of branch           [b]-1 */
-    OmInt* vecMn1 ;                     /** Node 1 of meter            [m]-1 */
-    OmInt* vecMn2 ;                     /** Node 2 of meter            [m]-1 */
-    OmFlt* matPa  ;                     /** Source update matrix      [b,b]0 */
-    OmFlt* matPb  ;                     /** Branch conductance matrix [b,b]0 */
-    /*======== Group 2: Reset Information ===================================*/
-    OmInt* vecBtm ;                     /** Type and method of branch  [b]0  */
-    OmInt* vecLut ;                     /** Lookup table for branches  [b]0  */
-    OmFlt* vecW1c ;                     /** Weight of Xc   (closed)    [b]0  */
-    OmFlt* vecW2c ;                     /** Weight of Qa   (closed)    [b]0  */
-    OmFlt* vecW1o ;                     /** Weight of Xc   (open)      [b]0  */
-    OmFlt* vecW2o ;                     /** Weight of Qa   (open)      [b]0  */
-    OmFlt* vecQa0 ;                     /** Initial value of Qa        [b]0  */
-    OmFlt* vecQs0 ;                     /** Initial value of Qs        [b]0  */
-    /*======== Group 3: Runtime Information =================================*/
-    OmFlt* matC   ;                     /** Matrix to calculate Xc    [c,c]x */
-    OmFlt* matD   ;                     /** Matrix to calculate Xm    [m,c]x */
-    OmFlt* vecW1m ;                     /** Weight of Xc in UpdCr()    [c]x  */
-    OmFlt* vecW2m ;                     /** Weight of Qa in UpdCr()    [c]x  */
-    OmFlt* vecW1s ;                     /** Weight of Xc in UpdSw()    [c]x  */
-    OmFlt* vecW2s ;                     /** Weight of Qa in UpdSw()    [c]x  */
-    OmFlt* vecQa  ;                     /** Associated source vector   [c]x  */
-    OmFlt* vecQs  ;                     /** Independent source vector  [c]x  */
-    OmFlt* vecQtp ;                     /** Vector Qtp = Qs + Qa       [c]x  */
-    OmFlt* vecXm  ;                     /** Meter reading vector       [m]x  */
-    OmFlt* vecXc  ;                     /** Source update vector       [c]x  */
-} OmCir;
-
-/*====================== Part 4. Function Declaration =======================*/
-
-/**
- * @brief       [0] Free an OmCir pointer
- * @param       cr input OmCir pointer (can be NULL)
- */
-void OmDelete(OmCir* cr);
-/**
- * @brief       [1] Create new unstamped circuit
- * @param       n number of nodes (excepting GND) (must >= 0)
- * @param       b number of branches (must >= 0)
- * @param       m number of meters (must >= 0)
- * @param       stp time step (must > 0.0)
- * @retval      return valid pointer if succed, return NULL if failed
- * @note        Remember to use OmDelete() to free memory!
- */
-OmCir* OmCreate(OmInt n, OmInt b, OmInt m, OmFlt stp);
-/**
- * @brief       [2] Stamp circuit, get ready to run
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @note        do not stamp the same circuit more than once
- */
-void OmStamp(OmCir* cr);
-/**
- * @brief       [3] Reset stamped circuit to initial state
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- * @note        Switches are always set to open state after reset
- */
-void OmReset(OmCir* cr);
-/**
- * @brief       [4] Update switch associated source only
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- */
-void OmUpdSw(OmCir* cr);
-/**
- * @brief       [5] Update circuit (both switch and associated source)
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- */
-void OmUpdCr(OmCir* cr);
-/**
- * @brief       [6] Update meter readings
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- */
-void OmUpdMt(OmCir* cr);
-/**
- * @brief       [7] Get meter reading
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- * @param       mt meter index (1-based index, range: 1 to numM)
- * @retval      return meter reading value
- */
-OmFlt OmGetMt(OmCir* cr, OmInt mt);
-/**
- * @brief       [8] Get vector Xc
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- * @param       br branch index (1-based index, range: 1 to numB)
- * @retval      return Xc value
- * @note        for X0/Y0 branch, return 0.0, as they are always cut off
- * @note        for X1/X2 branch, return branch current
- * @note        for Y1/Y2/SW branch, return branch voltage
- */
-OmFlt OmGetXc(OmCir* cr, OmInt br);
-/**
- * @brief       [9] Set independent source vector Qs
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- * @param       br branch index (1-based index, range: 1 to numB)
- * @param       x new Qs value
- * @note        for X0/Y0 branch, do nothing
- * @note        for X1/X2/X3 branch, set voltage source
- * @note        for Y1/Y2/Y3/SW branch, set current source
- */
-void OmSetQs(OmCir* cr, OmInt br, OmFlt x);
-/**
- * @brief       [10] Set switch state
- * @param       cr input stamped OmCir pointer (cannot be NULL)
- * @param       br branch index (1-based index, range: 1 to numB)
- * @param       s new switch state (0: open, 1: closed)
- * @note        only valid for SW-type branch, else will cause error
- */
-void OmSetSw(OmCir* cr, OmInt br, OmInt s);
-/**
- * @brief       [11] Set branch configuration
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       br branch index (1-based index, range: 1 to numB)
- * @param       n1 node 1 index (1-based index, range: 1 to numN, 0 for GND)
- * @param       n2 node 2 index (1-based index, range: 1 to numN, 0 for GND)
- * @param       tm branch type and ode method
- * @note        do not configure one branch more than once
- * @note        tm: use OMTYP_* macros defined in this header file
- * @note        tm: use Trapezoidal rule by default
- * @note        tm: add negative sign to use Backward Euler rule
- */
-void OmBran(OmCir* cr, OmInt br, OmInt n1, OmInt n2, OmInt tm);
-/**
- * @brief       [12] Set voltmeter configuration
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       mt meter index (1-based index, range: 1 to numM)
- * @param       n1 node 1 index (1-based index, range: 1 to numN, 0 for GND)
- * @param       n2 node 2 index (1-based index, range: 1 to numN, 0 for GND)
- */
-void OmMetV(OmCir* cr, OmInt mt, OmInt n1, OmInt n2);
-/**
- * @brief       [13] Set ammeter configuration
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       mt meter index (1-based index, range: 1 to numM)
- * @param       br branch index (1-based index, range: 1 to numB)
- */
-void OmMetA(OmCir* cr, OmInt mt, OmInt br);
-/**
- * @brief       [14] Series connect resistor to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx branch index (1-based index, range: 1 to numB)
- * @param       res value of resistance to be added
- * @note        branch must be X0/X1/X2/X3-type
- * @note        u = res * i
- */
-void OmAddX(OmCir* cr, OmInt bx, OmFlt res);
-/**
- * @brief       [15] Parallel connect conductor to Y/SW-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by branch index (1-based index, range: 1 to numB)
- * @param       con value of conductance to be added
- * @note        branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        j = con * v
- */
-void OmAddY(OmCir* cr, OmInt by, OmFlt con);
-/**
- * @brief       [16] Series connect voltage source to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx branch index (1-based index, range: 1 to numB)
- * @param       vol value of voltage source to be added
- * @note        branch must be X1/X2/X3-type
- * @note        u = vol
- */
-void OmAddV(OmCir* cr, OmInt bx, OmFlt vol);
-/**
- * @brief       [17] Parallel connect current source to Y/SW-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by branch index (1-based index, range: 1 to numB)
- * @param       cur value of current source to be added
- * @note        branch must be Y1/Y2/Y3/SW-type
- * @note        j = cur
- */
-void OmAddI(OmCir* cr, OmInt by, OmFlt cur);
-/**
- * @brief       [18] Series connect inductor to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx branch index (1-based index, range: 1 to numB)
- * @param       ind value of inductance to be added
- * @param       i0 initial current
- * @note        branch must be X2/X3-type
- * @note        u = ind * di / dt
- */
-void OmAddL(OmCir* cr, OmInt bx, OmFlt ind, OmFlt i0);
-/**
- * @brief       [19] Parallel connect capacitor to Y-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by branch index (1-based index, range: 1 to numB)
- * @param       cap value of capacitance to be added
- * @param       v0 initial voltage
- * @note        branch must be Y2/Y3-type
- * @note        j = cap * dv / dt
- */
-void OmAddC(OmCir* cr, OmInt by, OmFlt cap, OmFlt v0);
-/**
- * @brief       [20] Series connect capacitor to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx branch index (1-based index, range: 1 to numB)
- * @param       rpc value of reciprocal of capacitance to be added
- * @param       v0 initial voltage
- * @note        branch must be X2/X3-type
- * @note        u = sum(rpc * i * dt)
- */
-void OmAddQ(OmCir* cr, OmInt bx, OmFlt rpc, OmFlt v0);
-/**
- * @brief       [21] Parallel connect inductor to Y-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by branch index (1-based index, range: 1 to numB)
- * @param       rpi value of reciprocal of inductance to be added
- * @param       i0 initial current
- * @note        branch must be Y2/Y3-type
- * @note        j = sum(rpi * v * dt)
- */
-void OmAddP(OmCir* cr, OmInt by, OmFlt rpi, OmFlt i0);
-/**
- * @brief       [22] Series connect linear VCVS to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx controlled branch index (1-based index, range: 1 to numB)
- * @param       cy controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @note        controlled branch must be X0/X1/X2/X3-type
- * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        u = k * vc
- */
-void OmAddE(OmCir* cr, OmInt bx, OmInt cy, OmFlt k);
-/**
- * @brief       [23] Series connect linear CCVS to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx controlled branch index (1-based index, range: 1 to numB)
- * @param       cx controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @note        controlled branch must be X0/X1/X2/X3-type
- * @note        controlling branch must be X0/X1/X2/X3-type
- * @note        u = k * ic
- */
-void OmAddH(OmCir* cr, OmInt bx, OmInt cx, OmFlt k);
-/**
- * @brief       [24] Parallel connect linear CCCS to Y/SW-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by controlled branch index (1-based index, range: 1 to numB)
- * @param       cx controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @note        controlled branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        controlling branch must be X0/X1/X2/X3-type
- * @note        j = k * ic
- */
-void OmAddF(OmCir* cr, OmInt by, OmInt cx, OmFlt k);
-/**
- * @brief       [25] Parallel connect linear VCCS to Y/SW-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by controlled branch index (1-based index, range: 1 to numB)
- * @param       cy controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @note        controlled branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        j = k * vc
- */
-void OmAddG(OmCir* cr, OmInt by, OmInt cy, OmFlt k);
-/**
- * @brief       [26] Series connect differential CCVS to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx controlled branch index (1-based index, range: 1 to numB)
- * @param       cx controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @param       ic0 initial current of controlling branch
- * @note        controlled branch must be X3-type
- * @note        controlling branch must be X0/X1/X2/X3-type
- * @note        u = k * dic / dt
- */
-void OmAddM(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt ic0);
-/**
- * @brief       [27] Parallel connect differential VCCS to Y-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by controlled branch index (1-based index, range: 1 to numB)
- * @param       cy controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @param       vc0 initial voltage of controlling branch
- * @note        controlled branch must be Y3-type
- * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        j = k * dvc / dt
- */
-void OmAddN(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt vc0);
-/**
- * @brief       [28] Series connect integral CCVS to X-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bx controlled branch index (1-based index, range: 1 to numB)
- * @param       cx controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @param       v0 initial voltage
- * @note        controlled branch must be X3-type
- * @note        controlling branch must be X0/X1/X2/X3-type
- * @note        u = sum(k * ic * dt)
- */
-void OmAddA(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt v0);
-/**
- * @brief       [29] Parallel connect integral VCCS to Y-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       by controlled branch index (1-based index, range: 1 to numB)
- * @param       cy controlling branch index (1-based index, range: 1 to numB)
- * @param       k gain of controlled source
- * @param       i0 initial current
- * @note        controlled branch must be Y3-type
- * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        j = sum(k * vc * dt)
- */
-void OmAddB(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt i0);
-/**
- * @brief       [30] Parallel connect switch to SW-type branch
- * @param       cr input unstamped OmCir pointer (cannot be NULL)
- * @param       bs switch branch index (1-based index, range: 1 to numB)
- * @param       k1 closed state coefficient
- * @param       k2 open state coefficient
- * @param       ysw switch conductance (cannot be 0)
- * @param       ron series connected on-resistance (can be 0)
- * @note        branch must be SW-type
- * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
- * @note        ja(t+dt) = k1 * ysw * v(t) + i(t), ON
- * @note        ja(t+dt) = -ysw * v(t) + k2 * i(t), OFF
- * @note        if you know switch rated voltage (V) and rated current (I)
- * @note        try k1 = 1, k2 = 0.6569, ysw = 0.2929 * I / V
- */
-void OmAddS(OmCir* cr, OmInt bs, OmFlt k1, OmFlt k2, OmFlt ysw, OmFlt ron);
-/**
- * @brief       [31] Get inverse of input square matrix
- * @param       m square matrix row / column length (must >= 0)
- * @param       a input square matrix (cannot be NULL)
- */
-void OmMatInv(OmInt m, OmFlt* a);
-/**
- * @brief       [32] Square matrix-matrix multiplication, C = A @ B
- * @param       m square matrix row / column length (must >= 0)
- * @param       c input square matrix (cannot be NULL, cannot be A or B)
- * @param       a input square matrix (cannot be NULL)
- * @param       b input square matrix (cannot be NULL)
- */
-void OmMatMul(OmInt m, OmFlt* c, OmFlt* a, OmFlt* b);
-/**
- * @brief       [33] Matrix-vector multiplication, y = A @ x
- * @param       m number of rows of matrix A (must >= 0)
- * @param       n number of columns of matrix A (must >= 0)
- * @param       y output vector (cannot be NULL, cannot be x), size = m
- * @param       a input matrix (cannot be NULL), size = m*n
- * @param       x input vector (cannot be NULL), size = n
- */
-void OmVecMul(OmInt m, OmInt n, OmFlt* y, OmFlt* a, OmFlt* x);
-/**
- * @brief       [34] Vector addition, z = x + y
- * @param       m number of elements of vectors (must >= 0)
- * @param       z output vector (cannot be NULL, cannot be x or y)
- * @param       x input vector (cannot be NULL)
- * @param       y input vector (cannot be NULL)
- */
-void OmVecAdd(OmInt m, OmFlt* z, OmFlt* x, OmFlt* y);
-/**
- * @brief       [35] Vector fused multiply-add, y = w1 * x + w2 * y
- * @param       m number of elements of vectors (must >= 0)
- * @param       y output vector (cannot be NULL, cannot be x or w1, w2)
- * @param       w1 input vector (cannot be NULL)
- * @param       x input vector (cannot be NULL)
- * @param       w2 input vector (cannot be NULL)
- */
-void OmVecFma(OmInt m, OmFlt* y, OmFlt* w1, OmFlt* x, OmFlt* w2);
-
-/*===========================================================================*/
-#ifdef LIBOHM_C                         /*| define this in exactly one file |*/
-/*===========================================================================*/
-
-/*====================== Part 5. Function Implementation ====================*/
-
-/*========== OmDelete ================*//** Function [0]                     */
-void OmDelete(OmCir* cr) {
-    if (cr == NULL) return;             /* check if cr is null pointer       */
-    cr->numN    = 0;
-    cr->numB    = 0;
-    cr->numM    = 0;
-    cr->numX    = 0;
-    cr->numC    = 0;
-    cr->timStp  = 1.0;
-    OMFREE(cr->vecBn1 ); cr->vecBn1 = NULL;
-    OMFREE(cr->vecBn2 ); cr->vecBn2 = NULL;
-    OMFREE(cr->vecMn1 ); cr->vecMn1 = NULL;
-    OMFREE(cr->vecMn2 ); cr->vecMn2 = NULL;
-    OMFREE(cr->matPa  ); cr->matPa  = NULL;
-    OMFREE(cr->matPb  ); cr->matPb  = NULL;
-    OMFREE(cr->vecBtm ); cr->vecBtm = NULL;
-    OMFREE(cr->vecLut ); cr->vecLut = NULL;
-    OMFREE(cr->vecW1c ); cr->vecW1c = NULL;
-    OMFREE(cr->vecW2c ); cr->vecW2c = NULL;
-    OMFREE(cr->vecW1o ); cr->vecW1o = NULL;
-    OMFREE(cr->vecW2o ); cr->vecW2o = NULL;
-    OMFREE(cr->vecQa0 ); cr->vecQa0 = NULL;
-    OMFREE(cr->vecQs0 ); cr->vecQs0 = NULL;
-    OMFREE(cr->matC   ); cr->matC   = NULL;
-    OMFREE(cr->matD   ); cr->matD   = NULL;
-    OMFREE(cr->vecW1m ); cr->vecW1m = NULL;
-    OMFREE(cr->vecW2m ); cr->vecW2m = NULL;
-    OMFREE(cr->vecW1s ); cr->vecW1s = NULL;
-    OMFREE(cr->vecW2s ); cr->vecW2s = NULL;
-    OMFREE(cr->vecQa  ); cr->vecQa  = NULL;
-    OMFREE(cr->vecQs  ); cr->vecQs  = NULL;
-    OMFREE(cr->vecQtp ); cr->vecQtp = NULL;
-    OMFREE(cr->vecXm  ); cr->vecXm  = NULL;
-    OMFREE(cr->vecXc  ); cr->vecXc  = NULL;
-}
-/*========== OmCreate ================*//** Function [1]                     */
-OmCir* OmCreate(OmInt n, OmInt b, OmInt m, OmFlt stp) {
-    OmInt  i, j;                        /* used in for-loop                  */
-    OmCir* cir;                         /* new circuit to be created         */
-    /*======== Step 0: Check parameter and Allocate struct ==================*/
-    if (n < 0 || b < 0 || m < 0 || stp <= 0.0) return NULL;
-    cir = (OmCir*)OMMALLOC(sizeof(OmCir));
-    /*======== Step 1: Initialize and Allocate memory for Group 1 & 2 =======*/
-    cir->numN   = n;
-    cir->numB   = b;
-    cir->numM   = m;
-    cir->numX   = 0;
-    cir->numC   = 0;
-    cir->timStp = stp;
-    cir->vecBn1 = (OmInt*)OMMALLOC(b * sizeof(OmInt));
-    cir->vecBn2 = (OmInt*)OMMALLOC(b * sizeof(OmInt));
-    cir->vecMn1 = (OmInt*)OMMALLOC(m * sizeof(OmInt));
-    cir->vecMn2 = (OmInt*)OMMALLOC(m * sizeof(OmInt));
-    cir->matPa  = (OmFlt*)OMMALLOC(b * b * sizeof(OmFlt));
-    cir->matPb  = (OmFlt*)OMMALLOC(b * b * sizeof(OmFlt));
-    cir->vecBtm = (OmInt*)OMMALLOC(b * sizeof(OmInt));
-    cir->vecLut = (OmInt*)OMMALLOC(b * sizeof(OmInt));
-    cir->vecW1c = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
-    cir->vecW2c = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
-    cir->vecW1o = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
-    cir->vecW2o = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
-    cir->vecQa0 = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
-    cir->vecQs0 = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
-    /*======== Step 2: Initialize allocated struct pointer ==================*/
-    for (i=0; i < b; ++i) {
-        for (j=0; j < b; ++j) {
-            cir->matPa[i*b+j] = 0.0;    /* fill Pa with zeros                */
-            cir->matPb[i*b+j] = 0.0;    /* fill Pb with zeros                */
-        }
-        cir->vecBn1[i] = -1;            /* fill node1 of branch with GND(-1) */
-        cir->vecBn2[i] = -1;            /* fill node2 of branch with GND(-1) */
-        cir->vecBtm[i] = OMTYP_UN;      /* fill branch type with UN          */
-        cir->vecLut[i] = 1;             /* fill lookup table with Y-type     */
-        cir->vecW1c[i] = 0.0;           /* fill W1c with zeros               */
-        cir->vecW2c[i] = 0.0;           /* fill W2c with zeros               */
-        cir->vecW1o[i] = 0.0;           /* fill W1o with zeros               */
-        cir->vecW2o[i] = 0.0;           /* fill W2o with zeros               */
-        cir->vecQa0[i] = 0.0;           /* fill Qa0 with zeros               */
-        cir->vecQs0[i] = 0.0;           /* fill Qs0 with zeros               */
-    }
-    for (i=0; i < m; ++i) {
-        cir->vecMn1[i] = -1;            /* fill node1 of meter with GND(-1)  */
-        cir->vecMn2[i] = -1;            /* fill node2 of meter with GND(-1)  */
-    }
-    return cir;
-}
-/*========== OmStamp =================*//** Function [2]                     */
-void OmStamp(OmCir* cr) {
-    OmInt n, b, m, x, c;                /* numN, numB, numM, numX, numC      */
-    OmInt i, j;                         /* used in for-loop                  */
-    OmInt ilut, jlut, idx, jdx;         /* used in lookup table              */
-    OmInt btyp;                         /* branch type                       */
-    OmInt n1, n2, nc1, nc2;             /* node and controlling node         */
-    OmFlt k;                            /* used as factor / coefficient      */
-    OmFlt* matPn;                       /* node conductance matrix [n+x,n+x] */
-    OmFlt* matPtp;                      /* Ptp = (Pn^-1)(Tn)       [n+x,b]   */
-    OmFlt* matTtp;                      /* Ttp = (Tb)(Ptp)         [b,b]     */
-    OmFlt* matRtp;                      /* Rtp = (Pb)(Ttp) + I     [b,b]     */
-    OmFlt* matCtp;                      /* Ctp = (Pa)(Ttp)         [b,b]     */
-    OmFlt* matDtp;                      /* Dtp = (K)(Ptp,Rtp)      [m,b]     */
-    /*======== Step 0: Get Number of nodes and branches =====================*/
-    n = cr->numN;
-    b = cr->numB;
-    m = cr->numM;
-    x = cr->numX;
-    /*======== Step 1: Stamp Pb to Pn =======================================*/
-    matPn  = (OmFlt*)OMMALLOC((n+x) * (n+x) * sizeof(OmFlt));
-    matPtp = (OmFlt*)OMMALLOC((n+x) * b * sizeof(OmFlt));
-    for (i=0; i < (n+x) * (n+x); ++i) matPn[i] = 0.0;
-    for (i=0; i < (n+x) * b; ++i) matPtp[i] = 0.0;
-    for (i=0; i < b; ++i) {
-        ilut = cr->vecLut[i];           /* 0...-x is X-type, 1 is Y-type     */
-        n1 = cr->vecBn1[i];             /* node1 (0-based index)             */
-        n2 = cr->vecBn2[i];             /* node2 (0-based index)             */
-        if (ilut > 0) {                 /* Branch i is Y-type branch         */
-            for (j=0; j < b; ++j) {
-                k = cr->matPb[i*b+j];
-                jlut = cr->vecLut[j];   /* 0...-x is X-type, 1 is Y-type     */
-                nc1 = cr->vecBn1[j];    /* controlling node1 (0-based index) */
-                nc2 = cr->vecBn2[j];    /* controlling node2 (0-based index) */
-                if (jlut > 0) {         /* Branch j is Y-type branch         */
-                    if (n1 >= 0 && nc1 >= 0) matPn[n1*(n+x)+nc1] += k;
-                    if (n1 >= 0 && nc2 >= 0) matPn[n1*(n+x)+nc2] -= k;
-                    if (n2 >= 0 && nc1 >= 0) matPn[n2*(n+x)+nc1] -= k;
-                    if (n2 >= 0 && nc2 >= 0) matPn[n2*(n+x)+nc2] += k;
-                } else {                /* Branch j is X-type branch         */
-                    if (n1 >= 0) matPn[n1*(n+x)+(n-jlut)] += k;
-                    if (n2 >= 0) matPn[n2*(n+x)+(n-jlut)] -= k;
-                }
-            }
-        } else {                        /* Branch i is X-type branch         */
-            if (n1 >= 0) matPn[n1*(n+x)+(n-ilut)] += 1.0;
-            if (n1 >= 0) matPn[(n-ilut)*(n+x)+n1] += 1.0;
-            if (n2 >= 0) matPn[n2*(n+x)+(n-ilut)] -= 1.0;
-            if (n2 >= 0) matPn[(n-ilut)*(n+x)+n2] -= 1.0;
-            for (j=0; j < b; ++j) {
-                k = cr->matPb[i*b+j];
-                jlut = cr->vecLut[j];   /* 0...-x is X-type, 1 is Y-type     */
-                nc1 = cr->vecBn1[j];    /* controlling node1 (0-based index) */
-                nc2 = cr->vecBn2[j];    /* controlling node2 (0-based index) */
-                if (jlut > 0) {         /* Branch j is Y-type branch         */
-                    if (nc1 >= 0) matPn[(n-ilut)*(n+x)+nc1] -= k;
-                    if (nc2 >= 0) matPn[(n-ilut)*(n+x)+nc2] += k;
-                } else {                /* Branch j is X-type branch         */
-                    matPn[(n-ilut)*(n+x)+(n-jlut)] -= k;
-                }
-            }
-        }
-    }
-    OmMatInv(n+x, matPn);               /* calculate Pn^-1                   */
-    for (i=0; i < n+x; ++i) {           /* calculate Ptp = (Pn^-1)(Tn)       */
-        for (j=0; j < b; ++j) {
-            jlut = cr->vecLut[j];       /* 0...-x is X-type, 1 is Y-type     */
-            n1 = cr->vecBn1[j];         /* 0-based index                     */
-            n2 = cr->vecBn2[j];         /* 0-based index                     */
-            if (jlut > 0) {             /* Y-type branch                     */
-                if (n1 >= 0) matPtp[i*b+j] -= matPn[i*(n+x)+n1];
-                if (n2 >= 0) matPtp[i*b+j] += matPn[i*(n+x)+n2];
-            } else {                    /* X-type branch                     */
-                matPtp[i*b+j] += matPn[i*(n+x)+(n-jlut)];
-            }
-        }
-    }
-    OMFREE(matPn);                      /* matPn is not needed anymore       */
-    /*======== Step 2: Calculate Ttp, Rtp, Ctp, Dtp =========================*/
-    matTtp = (OmFlt*)OMMALLOC(b * b * sizeof(OmFlt));
-    matRtp = (OmFlt*)OMMALLOC(b * b * sizeof(OmFlt));
-    matCtp = (OmFlt*)OMMALLOC(b * b * sizeof(OmFlt));
-    matDtp = (OmFlt*)OMMALLOC(m * b * sizeof(OmFlt));
-    for (i=0; i < b * b; ++i) matTtp[i] = 0.0;
-    for (i=0; i < m * b; ++i) matDtp[i] = 0.0;
-    for (i=0; i < b; ++i) {
-        ilut = cr->vecLut[i];
-        if (ilut > 0) {                 /* Y-type branch                     */
-            n1 = cr->vecBn1[i];         /* 0-based index                     */
-            n2 = cr->vecBn2[i];         /* 0-based index                     */
-            if (n1 >= 0) for (j=0; j < b; ++j) {
-                matTtp[i*b+j] += matPtp[n1*b+j];
-            }
-            if (n2 >= 0) for (j=0; j < b; ++j) {
-                matTtp[i*b+j] -= matPtp[n2*b+j];
-            }
-        } else {                        /* X-type branch                     */
-            for (j=0; j < b; ++j) {
-                matTtp[i*b+j] += matPtp[(n-ilut)*b+j];
-            }
-        }
-    }
-    OmMatMul(b, matCtp, cr->matPa, matTtp);
-    OmMatMul(b, matRtp, cr->matPb, matTtp);
-    for (i=0; i < b; ++i) matRtp[i*b+i] += 1.0;
-    for (i=0; i < m; ++i) {             /* calculate Dtp = (K)(Ptp,Rtp)      */
-        n1 = cr->vecMn1[i];             /* 0-based index                     */
-        n2 = cr->vecMn2[i];             /* 0-based index                     */
-        if (n2 < -1) {                  /* ammeter                           */
-            ilut = cr->vecLut[n1];      /* use Rtp if Y-type, Ptp if X-type  */
-            if (ilut > 0) for (j=0; j < b; ++j) {
-                matDtp[i*b+j] += matRtp[n1*b+j];
-            } 
-            else for (j=0; j < b; ++j) {
-                matDtp[i*b+j] += matPtp[(n-ilut)*b+j];
-            }
-        } else {                        /* voltmeter                         */
-            if (n1 >= 0) for (j=0; j < b; ++j) {
-                matDtp[i*b+j] += matPtp[n1*b+j];
-            }
-            if (n2 >= 0) for (j=0; j < b; ++j) {
-                matDtp[i*b+j] -= matPtp[n2*b+j];
-            }
-        }
-    }
-    OMFREE(cr->vecBn1); cr->vecBn1 = NULL;
-    OMFREE(cr->vecBn2); cr->vecBn2 = NULL;
-    OMFREE(cr->vecMn1); cr->vecMn1 = NULL;
-    OMFREE(cr->vecMn2); cr->vecMn2 = NULL;
-    OMFREE(cr->matPa ); cr->matPa  = NULL;
-    OMFREE(cr->matPb ); cr->matPb  = NULL;
-    OMFREE(matPtp);
-    OMFREE(matTtp);
-    OMFREE(matRtp);
-    /*======== Step 3: Count the number of kept branches ====================*/
-    c = 0;
-    for (i=0; i < b; ++i) {             /* detect X0 and Y0 branches         */
-        btyp = OMABS(cr->vecBtm[i]);
-        if (btyp == OMTYP_X0 || btyp == OMTYP_Y0) {
-            cr->vecLut[i] = -1;         /* mark as cut branch                */
-        } else {
-            cr->vecLut[i] = c;          /* mark as kept branch               */
-            c += 1;
-        }
-    }
-    cr->numC   = c;                     /* set numC                          */
-    /*======== Step 4: Simplify Ctp and Dtp (matrix cutting) ================*/
-    cr->matC   = (OmFlt*)OMMALLOC(c * c * sizeof(OmFlt));
-    cr->matD   = (OmFlt*)OMMALLOC(m * c * sizeof(OmFlt));
-    for (i=0; i < m; ++i) {             /* build D matrix                    */
-        jdx = 0;
-        for (j=0; j < b; ++j) {
-            jlut = cr->vecLut[j];
-            if (jlut < 0) continue;     /* cut branch                        */
-            cr->matD[i*c+jdx] = matDtp[i*b+j];
-            jdx += 1;
-        }
-    }
-    idx = 0;
-    for (i=0; i < b; ++i) {             /* build C matrix                    */
-        ilut = cr->vecLut[i];
-        if (ilut < 0) continue;         /* cut branch                        */
-        jdx = 0;
-        for (j=0; j < b; ++j) {
-            jlut = cr->vecLut[j];
-            if (jlut < 0) continue;     /* cut branch                        */
-            cr->matC[idx*c+jdx] = matCtp[i*b+j];
-            jdx += 1;
-        }
-        idx += 1;
-    }
-    OMFREE(matCtp);
-    OMFREE(matDtp);
-    /*======== Step 4: Allocate memory for runtime vectors ==================*/
-    cr->vecW1m = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    cr->vecW2m = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    cr->vecW1s = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    cr->vecW2s = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    cr->vecQa  = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    cr->vecQs  = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    cr->vecQtp = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    cr->vecXm  = (OmFlt*)OMMALLOC(m * sizeof(OmFlt));
-    cr->vecXc  = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
-    OmReset(cr);                        /* reset circuit to initial state    */
-}
-/*========== OmReset =================*//** Function [3]                     */
-void OmReset(OmCir* cr) {
-    OmInt b, c;                         /* numB, numC                        */
-    OmInt i;                            /* used in for-loop                  */
-    OmInt btyp, ilut;                   /* branch type and lut value         */
-    b = cr->numB;
-    c = cr->numC;
-    for (i=0; i < b; ++i) {
-        ilut = cr->vecLut[i];
-        btyp = OMABS(cr->vecBtm[i]);
-        if (ilut < 0) continue;         /* cut branch                        */
-        cr->vecW1m[ilut] = cr->vecW1o[i];
-        cr->vecW2m[ilut] = cr->vecW2o[i];
-        cr->vecQa[ilut] = cr->vecQa0[i];
-        cr->vecQs[ilut] = cr->vecQs0[i];
-        if (btyp == OMTYP_SW) {         /* always reset switch to open state */
-            cr->vecW1s[ilut] = cr->vecW1o[i];
-            cr->vecW2s[ilut] = cr->vecW2o[i];
-        } else {
-            cr->vecW1s[ilut] = 0.0;
-            cr->vecW2s[ilut] = 1.0;     /* keep other branch Qa unchanged    */
-        }
-    }
-    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
-}
-/*========== OmUpdSw =================*//** Function [4]                     */
-void OmUpdSw(OmCir* cr) {
-    OmInt c;                            /* numC                              */
-    c = cr->numC;
-    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
-    OmVecMul(c, c, cr->vecXc, cr->matC, cr->vecQtp);
-    OmVecFma(c, cr->vecQa, cr->vecW1s, cr->vecXc, cr->vecW2s);
-}
-/*========== OmUpdCr =================*//** Function [5]                     */
-void OmUpdCr(OmCir* cr) {
-    OmInt c;                            /* numC                              */
-    c = cr->numC;
-    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
-    OmVecMul(c, c, cr->vecXc, cr->matC, cr->vecQtp);
-    OmVecFma(c, cr->vecQa, cr->vecW1m, cr->vecXc, cr->vecW2m);
-}
-/*========== OmUpdMt =================*//** Function [6]                     */
-void OmUpdMt(OmCir* cr) {
-    OmInt m, c;                         /* numM, numC                        */
-    m = cr->numM;
-    c = cr->numC;
-    OmVecMul(m, c, cr->vecXm, cr->matD, cr->vecQtp);
-}
-/*========== OmGetMt =================*//** Function [7]                     */
-OmFlt OmGetMt(OmCir* cr, OmInt mt) {
-    return cr->vecXm[mt-1];
-}
-/*========== OmGetXc =================*//** Function [8]                     */
-OmFlt OmGetXc(OmCir* cr, OmInt br) {
-    OmInt ilut;                         /* lookup table value                */
-    ilut = cr->vecLut[br-1];
-    if (ilut < 0) return 0.0;           /* cut branch                        */
-    return cr->vecXc[ilut];
-}
-/*========== OmSetQs =================*//** Function [9]                     */
-void OmSetQs(OmCir* cr, OmInt br, OmFlt x) {
-    OmInt ilut;                         /* lookup table value                */
-    ilut = cr->vecLut[br-1];
-    if (ilut < 0) return;               /* cut branch                        */
-    cr->vecQs[ilut] = x;
-}
-/*========== OmSetSw =================*//** Function [10]                    */
-void OmSetSw(OmCir* cr, OmInt br, OmInt s) {
-    OmInt ilut;                         /* lookup table value                */
-    ilut = cr->vecLut[br-1];
-    if (ilut < 0) return;               /* cut branch                        */
-    cr->vecW1m[ilut] = (s == 0) ? cr->vecW1o[br-1] : cr->vecW1c[br-1];
-    cr->vecW2m[ilut] = (s == 0) ? cr->vecW2o[br-1] : cr->vecW2c[br-1];
-    cr->vecW1s[ilut] = cr->vecW1m[ilut];
-    cr->vecW2s[ilut] = cr->vecW2m[ilut];
-}
-/*========== OmBran ==================*//** Function [11]                    */
-void OmBran(OmCir* cr, OmInt br, OmInt n1, OmInt n2, OmInt tm) {
-    OmInt b;                            /* numB                              */
-    OmInt btyp;                         /* branch type                       */
-    cr->vecBn1[br-1] = n1 - 1;
-    cr->vecBn2[br-1] = n2 - 1;
-    cr->vecBtm[br-1] = tm;
-    btyp = OMABS(tm);
-    if (btyp >= OMTYP_Y0) {             /* Y/SW-type branch                  */
-        cr->vecLut[br-1] = 1;
-    } else {
-        cr->vecLut[br-1] = -cr->numX;
-        cr->numX += 1;
-    }
-    if (btyp != OMTYP_X3 && btyp != OMTYP_Y3) {
-        cr->matPa[(br-1)*b+(br-1)] = 1.0;
-    }                                   /* Xc is branch current or voltage   */
-}
-/*========== OmMetV ==================*//** Function [12]                    */
-void OmMetV(OmCir* cr, OmInt mt, OmInt n1, OmInt n2) {
-    cr->vecMn1[mt-1] = n1 - 1;
-    cr->vecMn2[mt-1] = n2 - 1;
-}
-/*========== OmMetA ==================*//** Function [13]                    */
-void OmMetA(OmCir* cr, OmInt mt, OmInt br) {
-    cr->vecMn1[mt-1] = br - 1;
-    cr->vecMn2[mt-1] = -2;
-}
-/*========== OmAddX ==================*//** Function [14]                    */
-void OmAddX(OmCir* cr, OmInt bx, OmFlt res) {
-    OmInt b;                            /* numB                              */
-    b = cr->numB;
-    cr->matPb[(bx-1)*b+(bx-1)] += res;
-}
-/*========== OmAddY ==================*//** Function [15]                    */
-void OmAddY(OmCir* cr, OmInt by, OmFlt con) {
-    OmInt b;                            /* numB                              */
-    b = cr->numB;
-    cr->matPb[(by-1)*b+(by-1)] += con;
-}
-/*========== OmAddV ==================*//** Function [16]                    */
-void OmAddV(OmCir* cr, OmInt bx, OmFlt vol) {
-    cr->vecQs0[bx-1] += vol;
-}
-/*========== OmAddI ==================*//** Function [17]                    */
-void OmAddI(OmCir* cr, OmInt by, OmFlt cur) {
-    cr->vecQs0[by-1] += cur;
-}
-/*========== OmAddL ==================*//** Function [18]                    */
-void OmAddL(OmCir* cr, OmInt bx, OmFlt ind, OmFlt i0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[bx-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPb[(bx-1)*b+(bx-1)] += ind / stp;
-        cr->vecQa0[bx-1] -= (ind * i0) / stp;
-        cr->vecW2o[bx-1] = 0.0;
-        if (btm == -OMTYP_X3) {         /* Level 3 branch                    */
-            cr->matPa[(bx-1)*b+(bx-1)] += ind;
-            cr->vecW1o[bx-1] = -1.0 / stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[bx-1] += (-1.0 * ind) / stp;
-        }
-    } else {                            /* trapezoidal rule                  */
-        cr->matPb[(bx-1)*b+(bx-1)] += (2.0 * ind) / stp;
-        cr->vecQa0[bx-1] -= (2.0 * ind * i0) / stp;
-        cr->vecW2o[bx-1] = -1.0;
-        if (btm == OMTYP_X3) {          /* Level 3 branch                    */
-            cr->matPa[(bx-1)*b+(bx-1)] += ind;
-            cr->vecW1o[bx-1] = -4.0 / stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[bx-1] += (-4.0 * ind) / stp;
-        }
-    }
-}
-/*========== OmAddC ==================*//** Function [19]                    */
-void OmAddC(OmCir* cr, OmInt by, OmFlt cap, OmFlt v0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[by-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPb[(by-1)*b+(by-1)] += cap / stp;
-        cr->vecQa0[by-1] -= (cap * v0) / stp;
-        cr->vecW2o[by-1] = 0.0;
-        if (btm == -OMTYP_Y3) {         /* Level 3 branch                    */
-            cr->matPa[(by-1)*b+(by-1)] += cap;
-            cr->vecW1o[by-1] = -1.0 / stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[by-1] += (-1.0 * cap) / stp;
-        }
-    } else {                            /* trapezoidal rule                  */
-        cr->matPb[(by-1)*b+(by-1)] += (2.0 * cap) / stp;
-        cr->vecQa0[by-1] -= (2.0 * cap * v0) / stp;
-        cr->vecW2o[by-1] = -1.0;
-        if (btm == OMTYP_Y3)  {         /* Level 3 branch                    */
-            cr->matPa[(by-1)*b+(by-1)] += cap;
-            cr->vecW1o[by-1] = -4.0 / stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[by-1] += (-4.0 * cap) / stp;
-        }
-    }
-}
-/*========== OmAddQ ==================*//** Function [20]                    */
-void OmAddQ(OmCir* cr, OmInt bx, OmFlt rpc, OmFlt v0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[bx-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPb[(bx-1)*b+(bx-1)] += rpc * stp;
-        cr->vecQa0[bx-1] += v0;
-        cr->vecW2o[bx-1] = 1.0;
-        if (btm == -OMTYP_X3) {         /* Level 3 branch                    */
-            cr->matPa[(bx-1)*b+(bx-1)] += rpc;
-            cr->vecW1o[bx-1] = stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[bx-1] += rpc * stp;
-        }
-    } else {                            /* trapezoidal rule                  */
-        cr->matPb[(bx-1)*b+(bx-1)] += (rpc * stp) / 2.0;
-        cr->vecQa0[bx-1] += v0;
-        cr->vecW2o[bx-1] = 1.0;
-        if (btm == OMTYP_X3) {          /* Level 3 branch                    */
-            cr->matPa[(bx-1)*b+(bx-1)] += rpc;
-            cr->vecW1o[bx-1] = stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[bx-1] += rpc * stp;
-        }
-    }
-}
-/*========== OmAddP ==================*//** Function [21]                    */
-void OmAddP(OmCir* cr, OmInt by, OmFlt rpi, OmFlt i0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[by-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPb[(by-1)*b+(by-1)] += rpi * stp;
-        cr->vecQa0[by-1] += i0;
-        cr->vecW2o[by-1] = 1.0;
-        if (btm == -OMTYP_Y3) {         /* Level 3 branch                    */
-            cr->matPa[(by-1)*b+(by-1)] += rpi;
-            cr->vecW1o[by-1] = stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[by-1] += rpi * stp;
-        }
-    } else {                            /* trapezoidal rule                  */
-        cr->matPb[(by-1)*b+(by-1)] += (rpi * stp) / 2.0;
-        cr->vecQa0[by-1] += i0;
-        cr->vecW2o[by-1] = 1.0;
-        if (btm == OMTYP_Y3) {          /* Level 3 branch                    */
-            cr->matPa[(by-1)*b+(by-1)] += rpi;
-            cr->vecW1o[by-1] = stp;
-        } else {                        /* Level 2 branch                    */
-            cr->vecW1o[by-1] += rpi * stp;
-        }
-    }
-}
-/*========== OmAddE ==================*//** Function [22]                    */
-void OmAddE(OmCir* cr, OmInt bx, OmInt cy, OmFlt k) {
-    OmInt b;                            /* numB                              */
-    b = cr->numB;
-    cr->matPb[(bx-1)*b+(cy-1)] += k;
-}
-/*========== OmAddH ==================*//** Function [23]                    */
-void OmAddH(OmCir* cr, OmInt bx, OmInt cx, OmFlt k) {
-    OmInt b;                            /* numB                              */
-    b = cr->numB;
-    cr->matPb[(bx-1)*b+(cx-1)] += k;
-}
-/*========== OmAddF ==================*//** Function [24]                    */
-void OmAddF(OmCir* cr, OmInt by, OmInt cx, OmFlt k) {
-    OmInt b;                            /* numB                              */
-    b = cr->numB;
-    cr->matPb[(by-1)*b+(cx-1)] += k;
-}
-/*========== OmAddG ==================*//** Function [25]                    */
-void OmAddG(OmCir* cr, OmInt by, OmInt cy, OmFlt k) {
-    OmInt b;                            /* numB                              */
-    b = cr->numB;
-    cr->matPb[(by-1)*b+(cy-1)] += k;
-}
-/*========== OmAddM ==================*//** Function [26]                    */
-void OmAddM(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt ic0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[bx-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPa[(bx-1)*b+(cx-1)] += k;
-        cr->matPb[(bx-1)*b+(cx-1)] += k / stp;
-        cr->vecQa0[bx-1] -= (k * ic0) / stp;
-        cr->vecW1o[bx-1] = -1.0 / stp;
-        cr->vecW2o[bx-1] = 0.0;
-    } else {                            /* trapezoidal rule                  */
-        cr->matPa[(bx-1)*b+(cx-1)] += k;
-        cr->matPb[(bx-1)*b+(cx-1)] += (2.0 * k) / stp;
-        cr->vecQa0[bx-1] -= (2.0 * k * ic0) / stp;
-        cr->vecW1o[bx-1] = -4.0 / stp;
-        cr->vecW2o[bx-1] = -1.0;
-    }
-}
-/*========== OmAddN ==================*//** Function [27]                    */
-void OmAddN(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt vc0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[by-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPa[(by-1)*b+(cy-1)] += k;
-        cr->matPb[(by-1)*b+(cy-1)] += k / stp;
-        cr->vecQa0[by-1] -= (k * vc0) / stp;
-        cr->vecW1o[by-1] = -1.0 / stp;
-        cr->vecW2o[by-1] = 0.0;
-    } else {                            /* trapezoidal rule                  */
-        cr->matPa[(by-1)*b+(cy-1)] += k;
-        cr->matPb[(by-1)*b+(cy-1)] += (2.0 * k) / stp;
-        cr->vecQa0[by-1] -= (2.0 * k * vc0) / stp;
-        cr->vecW1o[by-1] = -4.0 / stp;
-        cr->vecW2o[by-1] = -1.0;
-    }
-}
-/*========== OmAddA ==================*//** Function [28]                    */
-void OmAddA(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt v0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[bx-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPa[(bx-1)*b+(cx-1)] += k;
-        cr->matPb[(bx-1)*b+(cx-1)] += k * stp;
-        cr->vecQa0[bx-1] += v0;
-        cr->vecW1o[bx-1] = stp;
-        cr->vecW2o[bx-1] = 1.0;
-    } else {                            /* trapezoidal rule                  */
-        cr->matPa[(bx-1)*b+(cx-1)] += k;
-        cr->matPb[(bx-1)*b+(cx-1)] += (k * stp) / 2.0;
-        cr->vecQa0[bx-1] += v0;
-        cr->vecW1o[bx-1] = stp;
-        cr->vecW2o[bx-1] = 1.0;
-    }
-}
-/*========== OmAddB ==================*//** Function [29]                    */
-void OmAddB(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt i0) {
-    OmInt btm;                          /* branch type and ode method        */
-    OmInt b;                            /* numB                              */
-    OmFlt stp;                          /* timStp                            */
-    btm = cr->vecBtm[by-1];
-    b = cr->numB;
-    stp = cr->timStp;
-    if (btm < 0) {                      /* backward euler rule               */
-        cr->matPa[(by-1)*b+(cy-1)] += k;
-        cr->matPb[(by-1)*b+(cy-1)] += k * stp;
-        cr->vecQa0[by-1] += i0;
-        cr->vecW1o[by-1] = stp;
-        cr->vecW2o[by-1] = 1.0;
-    } else {                            /* trapezoidal rule                  */
-        cr->matPa[(by-1)*b+(cy-1)] += k;
-        cr->matPb[(by-1)*b+(cy-1)] += (k * stp) / 2.0;
-        cr->vecQa0[by-1] += i0;
-        cr->vecW1o[by-1] = stp;
-        cr->vecW2o[by-1] = 1.0;
-    }
-}
-/*========== OmAddS ==================*//** Function [30]                    */
-void OmAddS(OmCir* cr, OmInt bs, OmFlt k1, OmFlt k2, OmFlt ysw, OmFlt ron) {
-    OmInt b;                            /* numB                              */
-    OmFlt tmp;                          /* temporary value                   */
-    b = cr->numB;
-    tmp = 1.0 + ysw * ron;
-    cr->matPb[(bs-1)*b+(bs-1)] += ysw / tmp;
-    cr->vecW1c[bs-1] = (k1 + 1.0) * ysw / (tmp * tmp);
-    cr->vecW2c[bs-1] = (1.0 - k1 * ysw * ron) / tmp;
-    cr->vecW1o[bs-1] = (k2 - 1.0) * ysw / (tmp * tmp);
-    cr->vecW2o[bs-1] = (k2 + ysw * ron) / tmp;
-}
-/*========== OmMatInv ================*//** Function [31]                    */
-void OmMatInv(OmInt m, OmFlt* a) {
-    OmInt i, j, k;                      /* used in for-loop                  */
-    OmFlt mv;                           /* max value of row                  */
-    OmFlt cv;                           /* current value                     */
-    OmFlt tmp;                          /* used for swap                     */
-    OmInt* pm;                          /* permute vector [m]                */
-    OmFlt* lu;                          /* LU matrix [m,m]                   */
-    /*======== Step 0: Row permutation (swap diagonal zeros) ================*/
-    pm = (OmInt*)OMMALLOC(m * sizeof(OmInt));
-    lu = (OmFlt*)OMMALLOC(m * m * sizeof(OmFlt));
-    for (i=0; i < m; ++i) {             /* initialize pm with row index      */
-        pm[i] = i;
-    }    
-    for (j=0; j < m; ++j) {             /* sort rows by pivot element        */
-        mv = 0.0;
-        for (i=j; i < m; ++i) {
-            cv = OMABS(a[pm[i]*m+j]);   /* cv = A[pm[i], j]                  */
-            if (cv > mv) {              /* swap rows                         */
-                mv = cv;
-                tmp = pm[j];
-                pm[j] = pm[i];
-                pm[i] = tmp;
-            }
-        }
-    }
-    for (i=0; i < m; ++i) {               /* make matrix G with new row order  */
-        for (j=0; j < m; ++j) { 
-            lu[i*m+j] = a[pm[i]*m+j];
-        }
-    }
-    /*======== Step 2: LU decomposition (save both L & U in lu) =============*/
-    for (i=0; i < m; ++i) {             /* calculate U matrix                */
-        for (j=i; j < m; ++j) {
-            for (k=0; k < i; ++k) {     /* LU[i,j] -= LU[i,k] * LU[k,j]      */
-                lu[i*m+j] -= lu[i*m+k] * lu[k*m+j]; 
-            }
-        }
-        for (k=i+1; k < m; ++k) {       /* calculate L matrix                */
-            for (j=0; j < i; ++j) {     /* LU[k,i] -= LU[k,j] * LU[j,i]      */
-                lu[k*m+i] -= lu[k*m+j] * lu[j*m+i]; 
-            }
-            lu[k*m+i] /= lu[i*m+i];     /* LU[k,i] /= LU[i,i]                */
-        }
-    }
-    /*======== Step 3: LU inversion (save both L^-1 & U^-1 in mat) ==========*/
-    for (i=0; i < m; ++i) {             /* fill matrix with zeros            */
-        for (j=0; j < m; ++j) {
-            a[i*m+j] = 0.0;
-        }
-    }
-    for (i=0; i < m; ++i) {             /* L inverse & U inverse             */
-        a[i*m+i] = 1.0;                 /* L matrix inverse, omit diagonal   */           
-        for (k=i+1; k < m; ++k) {       /* Inv[k,i] -= LU[k,j] * Inv[j,i]    */
-            for (j=i; j <= k - 1; ++j) {
-                a[k*m+i] -= lu[k*m+j] * a[j*m+i];
-            }
-        }
-        a[i*m+i] = 1.0 / lu[i*m+i];     /* U matrix inverse                  */
-        for (k=i-1; k >= 0; --k) {      /* Inv[k,i] -= LU[k,j] * Inv[j,i]    */ 
-            for (j=k+1; j <= i; ++j) {
-                a[k*m+i] -= lu[k*m+j] * a[j*m+i];
-            }
-            a[k*m+i] /= lu[k*m+k];
-        }
-    }
-    /*======== Step 4: Calculate G^-1 = U^-1 * L^-1 (save in lu) ============*/
-    for (i=0; i < m; ++i) {             /* set initial value                 */
-        for (j=0; j < i; ++j) {
-            lu[i*m+j] = 0.0;            /* G[i,j] = 0.0                      */
-        }
-        for (j=i; j < m; ++j) {
-            lu[i*m+j] = a[i*m+j];       /* G[i,j] = Inv[i,j]                 */
-        }
-    }
-    for (i=1; i < m; ++i) {             /* lower part product                */
-        for (k=i; k < m; ++k) {         /* G[i,j] += Inv[i,k] * Inv[k,j]     */
-            for (j=0; j < i; ++j) {
-                lu[i*m+j] += a[i*m+k] * a[k*m+j];
-            }       
-        }
-    }
-    for (i=0; i < m; ++i) {             /* upper part product                */
-        for (j=i; j < m; ++j) {         /* G[i,j] += Inv[i,k] * Inv[k,j]     */
-            for (k=j+1; k < m; ++k) {
-                lu[i*m+j] += a[i*m+k] * a[k*m+j];
-            }
-        }
-    }
-    /*======== Step 5: Permute column back (save in mat) ====================*/
-    for (i=0; i < m; ++i) {
-        for (j=0; j < m; ++j) {
-            a[i*m+pm[j]] = lu[i*m+j];
-        }
-    }
-    free(pm);
-    free(lu);
-}
-/*========== OmMatMul ================*//** Function [32]                    */
-void OmMatMul(OmInt m, OmFlt* c, OmFlt* a, OmFlt* b) {
-    OmInt i, j, k;                      /* used in for-loop                  */
-    OmFlt s;                            /* temporary value                   */
-    for (i=0; i < m; ++i) {
-        for (j=0; j < m; ++j) {
-            c[i*m+j] = 0.0;
-        }
-    }
-    for(i=0; i < m; ++i) {
-        for(k=0; k < m; ++k) {
-            s = a[i*m+k];
-            for (j=0; j < m; ++j) {
-                c[i*m+j] += s * b[k*m+j];
-            }
-        }
-    }
-}
-/*========== OmVecMul ================*//** Function [33]                    */
-void OmVecMul(OmInt m, OmInt n, OmFlt* y, OmFlt* a, OmFlt* x) {
-    OmInt i, j;                         /* used in for-loop                  */
-    OmFlt sum;                          /* used to store summation value     */
-    for (i=0; i < m; ++i) {
-        sum = 0.0;
-        for (j=0; j < n; ++j) {
-            sum += a[i*n+j] * x[j];
-        }
-        y[i] = sum;
-    }
-}
-/*========== OmVecAdd ================*//** Function [34]                    */
-void OmVecAdd(OmInt m, OmFlt* z, OmFlt* x, OmFlt* y) {
-    OmInt i;                            /* used in for-loop                  */
-    for (i=0; i < m; ++i) {
-        z[i] = x[i] + y[i];
-    }
-}
-/*========== OmVecFma ================*//** Function [35]                    */
-void OmVecFma(OmInt m, OmFlt* y, OmFlt* w1, OmFlt* x, OmFlt* w2) {
-    OmInt i;                            /* used in for-loop                  */
-    for (i=0; i < m; ++i) {
-        y[i] = w1[i] * x[i] + w2[i] * y[i];
-    }
-}
-
-/*===========================================================================*/
-#endif                                  /*| #ifdef LIBOHM_C                 |*/
-/*===========================================================================*/
-
-/*====================== Part 6. Undefine Macro =============================*/
-
-#define OMFLG_NC
-#define OMFLG_RI
-#define OMFLG_RH
-#define OMFLG_CB
-#define OMFLG_CT
-#define OMFLG_LB
-#define OMFLG_LT
-#define OMFLG_SW
-#define OMFLG_KB
-#define OMFLG_KT
-
-/*===========================================================================*/
-#endif                                  /*| #ifndef LIBOHM_H                |*/
+/*
+ * LibOhm: A Header-Only Ciruit Simulation Library
+ * Copyright (C) 2026 H.J.Xie
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+* @file
+* @brief        LibOhm Header File.
+* @details      LibOhm is a lightweight real-time circuit simulation library.
+* @author       H.J.Xie
+* @date         2026/01/15
+* @version      v1.0
+*/
+
+/*===========================================================================*/
+#ifndef LIBOHM_H                        /*| Include Guards allow including  |*/
+#define LIBOHM_H                        /*| this header file multiple times.|*/
+/*===========================================================================*/
+
+/*====================== Part 1. Dependency =================================*/
+
+#include <stdlib.h>                     /** Function Used: malloc(), free()  */
+#ifdef LIBOHM_C
+#ifndef LIBOHM_STDIO
+#define LIBOHM_STDIO                    /** Implementation has FILE API      */
+#endif
+#endif
+#ifdef LIBOHM_STDIO
+#include <stdio.h>                      /** Function Used: fprintf()         */
+#endif
+#ifdef LIBOHM_MATH
+#include <math.h>                       /** Function Used: log(), atan2()    */
+#endif
+#ifdef LIBOHM_PTHREAD
+#include <pthread.h>                    /** Function Used: pthread_create()  */
+#endif
+
+/*====================== Part 2. Macro Defination ===========================*/
+
+#define OMMALLOC(x) malloc(x)           /** Memory allocation function       */
+#define OMFREE(x)   free(x)             /** Memory free function             */
+#define OMABS(x)    ((x)<0?-(x):(x))    /** Absolute value function          */
+#define OMTYP_UN    0                   /** Branch type is unknown           */
+#define OMTYP_X0    1                   /** Branch contains X/E/H            */
+#define OMTYP_X1    2                   /** Branch contains X/E/H/V          */
+#define OMTYP_X2    3                   /** Branch contains X/E/H/V/L/Q      */
+#define OMTYP_X3    4                   /** Branch contains X/E/H/V/L/M/Q/A  */
+#define OMTYP_Y0    5                   /** Branch contains Y/F/G            */
+#define OMTYP_Y1    6                   /** Branch contains Y/F/G/I          */
+#define OMTYP_Y2    7                   /** Branch contains Y/F/G/I/C/P      */
+#define OMTYP_Y3    8                   /** Branch contains Y/F/G/I/C/N/P/B  */
+#define OMTYP_SW    9                   /** Branch contains Y/F/G/I/S        */
+#define OMMTD_BD2   16                  /** Add to tm of OmBran() to use BDF2*/
+#define OMCMT_DI    1                   /** Switch commutates as diode       */
+#define OMCMT_TH    2                   /** Switch commutates as thyristor   */
+#define OMNL_BUF    65536               /** Read chunk of netlist loader     */
+#define OMNL_MAG    0x4C4E4D4F          /** Magic of binary netlist "OMNL"   */
+#define OMCMD_QS    1                   /** Command sets source, OmSetQs()   */
+#define OMCMD_SW    2                   /** Command sets switch, OmSetSw()   */
+#define OMCMD_GT    3                   /** Command sets gate, OmSetGt()     */
+#define OMWAV_SIN   1                   /** Generator is sine                */
+#define OMWAV_PWL   2                   /** Generator is piecewise linear    */
+#define OMWAV_TAB   3                   /** Generator is lookup table        */
+#define OMWAV_PWM   4                   /** Generator is PWM comparator      */
+#define OMBAT_BLK   64                  /** Block size of batched GEMM       */
+#define OMENS_LN    8                   /** Lanes of ensemble pack (SIMD)    */
+#define OMEVT_XC    1                   /** Detector watches Xc of branch    */
+#define OMEVT_XM    2                   /** Detector watches Xm of meter     */
+#define OMEVT_UP    1                   /** Event is rising crossing         */
+#define OMEVT_DN    2                   /** Event is falling crossing        */
+#define OMEVT_DV    4                   /** Event is dv/dt over limit        */
+#define OMADV_UNS   1                   /** Mode grows (|z| > 1)             */
+#define OMADV_OSC   2                   /** Mode flips sign (Re z < 0)       */
+#define OMADV_ERR   4                   /** Mode error over tol at timStp    */
+#ifdef LIBOHM_ATOMIC                    /*| GCC/Clang __atomic builtins     |*/
+#define OMLDA(p)    __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define OMLDR(p)    __atomic_load_n(p, __ATOMIC_RELAXED)
+#define OMSTR(p,v)  __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define OMSTX(p,v)  __atomic_store_n(p, v, __ATOMIC_RELAXED)
+#define OMFNA()     __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define OMFNR()     __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+/*====================== Part 3. Type Defination ============================*/
+
+#ifdef __cplusplus                      /*| C linkage when used from C++    |*/
+extern "C" {
+#endif
+typedef int    OmInt;                   /** Integer Type that LibOhm uses    */
+typedef double OmFlt;                   /** Float Type that LibOhm uses      */
+typedef struct OmCir {                  /** Circuit Information Structure    */
+    /*======== Group 0: General Information =================================*/
+    OmInt  numN   ;                     /** Number of nodes (excluding GND)  */
+    OmInt  numB   ;                     /** Number of branches               */
+    OmInt  numM   ;                     /** Number of meters                 */
+    OmInt  numX   ;                     /** Number of X-type branches        */
+    OmInt  numC   ;                     /** Number of branches after cutting */
+    OmFlt  timStp ;                     /** Simulation time step             */
+    /*======== Group 1: Setup Information ===================================*/
+    OmInt* vecBn1 ;                     /** Node 1 of branch           [b]-1 */
+    OmInt* vecBn2 ;                     /** Node 2 of branch           [b]-1 */
+    OmInt* vecMn1 ;                     /** Node 1 of meter            [m]-1 */
+    OmInt* vecMn2 ;                     /** Node 2 of meter            [m]-1 */
+    OmFlt* matPa  ;                     /** Source update matrix      [b,b]0 */
+    OmFlt* matPb  ;                     /** Branch conductance matrix [b,b]0 */
+    /*======== Group 2: Reset Information ===================================*/
+    OmInt* vecBtm ;                     /** Type and method of branch  [b]0  */
+    OmInt* vecLut ;                     /** Lookup table for branches  [b]0  */
+    OmFlt* vecW1c ;                     /** Weight of Xc   (closed)    [b]0  */
+    OmFlt* vecW2c ;                     /** Weight of Qa   (closed)    [b]0  */
+    OmFlt* vecW1o ;                     /** Weight of Xc   (open)      [b]0  */
+    OmFlt* vecW2o ;                     /** Weight of Qa   (open)      [b]0  */
+    OmFlt* vecQa0 ;                     /** Initial value of Qa        [b]0  */
+    OmFlt* vecQs0 ;                     /** Initial value of Qs        [b]0  */
+    /*======== Group 3: Runtime Information =================================*/
+    OmFlt* matC   ;                     /** Matrix to calculate Xc    [c,c]x */
+    OmFlt* matD   ;                     /** Matrix to calculate Xm    [m,c]x */
+    OmFlt* vecW1m ;                     /** Weight of Xc in UpdCr()    [c]x  */
+    OmFlt* vecW2m ;                     /** Weight of Qa in UpdCr()    [c]x  */
+    OmFlt* vecW1s ;                     /** Weight of Xc in UpdSw()    [c]x  */
+    OmFlt* vecW2s ;                     /** Weight of Qa in UpdSw()    [c]x  */
+    OmFlt* vecQa  ;                     /** Associated source vector   [c]x  */
+    OmFlt* vecQs  ;                     /** Independent source vector  [c]x  */
+    OmFlt* vecQtp ;                     /** Vector Qtp = Qs + Qa       [c]x  */
+    OmFlt* vecXm  ;                     /** Meter reading vector       [m]x  */
+    OmFlt* vecXc  ;                     /** Source update vector       [c]x  */
+    /*======== Group 4: Sparse Runtime Information ==========================*/
+    OmInt  numK   ;                     /** Number of independent blocks     */
+    OmInt* vecKb  ;                     /** First row of block       [k+1]x  */
+    OmInt* vecCp  ;                     /** Row pointer of sparse C  [c+1]x  */
+    OmInt* vecCi  ;                     /** Column index of sparse C   [z]x  */
+    OmFlt* vecCv  ;                     /** Value of sparse C          [z]x  */
+    OmInt* vecDp  ;                     /** Row pointer of sparse D  [m+1]x  */
+    OmInt* vecDi  ;                     /** Column index of sparse D   [z]x  */
+    OmFlt* vecDv  ;                     /** Value of sparse D          [z]x  */
+    /*======== Group 5: Commutation Information =============================*/
+    OmInt  numA   ;                     /** Number of auto-commutated SW     */
+    OmInt* vecAb  ;                     /** Branch of auto switch      [b]0  */
+    OmInt* vecAt  ;                     /** Rule of auto switch OMCMT_ [b]0  */
+    OmInt* vecAs  ;                     /** State (0: open, 1: closed) [b]0  */
+    OmInt* vecAe  ;                     /** Gate signal of thyristor   [b]0  */
+    OmFlt* vecAg  ;                     /** Own conductance of switch  [b]0  */
+    OmFlt* vecAv  ;                     /** Voltage to close switch    [b]0  */
+    OmFlt* vecAi  ;                     /** Current to open switch     [b]0  */
+    /*======== Group 6: Sharing Information =================================*/
+    OmInt  numR   ;                     /** Number of extra references       */
+    /*======== Group 7: Fast-forward Information ============================*/
+    OmInt  numP   ;                     /** Number of cached operator powers */
+    OmFlt* matP   ;                     /** G^(2^k) of step operator [p,g,g]x*/
+    OmFlt* vecPk  ;                     /** W1m, W2m, Qs of cached G  [3c]x  */
+    /*======== Group 8: State-space Information =============================*/
+    OmInt  numS   ;                     /** Number of dynamic states (d)     */
+    OmInt  numU   ;                     /** Number of columns, d + inputs (k)*/
+    OmInt* vecSr  ;                     /** Row of column, ascending   [k]x  */
+    OmInt* vecSx  ;                     /** Column of dynamic state    [d]x  */
+    OmFlt* matSc  ;                     /** C of states on columns   [d,k]x  */
+    OmFlt* matSd  ;                     /** D on columns             [m,k]x  */
+    /*======== Group 9: Multistep Information ===============================*/
+    OmInt* vecBd  ;                     /** Branch uses BDF2 rule      [b]0  */
+    OmFlt* vecW3b ;                     /** Weight of Qb for Qa        [b]0  */
+    OmFlt* vecW4b ;                     /** Weight of Xc for Qb        [b]0  */
+    OmFlt* vecW5b ;                     /** Weight of Qa for Qb        [b]0  */
+    OmFlt* vecQb0 ;                     /** Initial value of Qb        [b]0  */
+    OmFlt* vecW3m ;                     /** Weight of Qb in UpdCr()    [c]x  */
+    OmFlt* vecW4m ;                     /** Weight of Xc for new Qb    [c]x  */
+    OmFlt* vecW5m ;                     /** Weight of Qa for new Qb    [c]x  */
+    OmFlt* vecQb  ;                     /** Second history vector      [c]x  */
+    /*======== Group 10: Switch Tuning Information ==========================*/
+    OmInt* vecTa  ;                     /** Switch is tuned at stamp   [b]0  */
+    OmFlt* vecTg  ;                     /** Conductance ysw of switch  [b]0  */
+    OmFlt* vecTr  ;                     /** On-resistance of switch    [b]0  */
+    OmFlt* vecTe  ;                     /** Expected error of switch   [b]0  */
+} OmCir;
+#ifdef LIBOHM_FIX                       /*| fixed-point runtime (opt-in)    |*/
+typedef int OmI32;                      /** 32-bit Integer used in Q-format  */
+#if defined(__GNUC__)
+__extension__
+#endif
+typedef long long OmI64;                /** 64-bit Integer for accumulation  */
+typedef char OmI32Chk[sizeof(OmI32) == 4 ? 1 : -1];
+typedef struct OmFxp {                  /** Fixed-point Runtime Structure    */
+    /*======== Group 0: General Information =================================*/
+    OmCir* cir    ;                     /** Double-precision source circuit  */
+    OmInt  numC   ;                     /** Number of branches after cutting */
+    OmInt  numM   ;                     /** Number of meters                 */
+    OmInt  numCal ;                     /** Number of calibration samples    */
+    OmInt  numSat ;                     /** Number of saturated results      */
+    OmFlt  errXc  ;                     /** Max abs error of Xc vs double    */
+    OmFlt  errXm  ;                     /** Max abs error of Xm vs double    */
+    /*======== Group 1: Scaling Information =================================*/
+    OmFlt* vecRs  ;                     /** Range of independent source [c]  */
+    OmFlt* vecRq  ;                     /** Observed range of Qtp       [c]  */
+    OmFlt* vecRx  ;                     /** Observed range of Xc        [c]  */
+    OmFlt* vecRm  ;                     /** Observed range of Xm        [m]  */
+    OmInt* vecFq  ;                     /** Fraction bits of Qa/Qs/Qtp  [c]  */
+    OmInt* vecFx  ;                     /** Fraction bits of Xc         [c]  */
+    OmInt* vecFm  ;                     /** Fraction bits of Xm         [m]  */
+    OmI32* matCq  ;                     /** Quantized matrix C        [c,c]  */
+    OmInt* vecCs  ;                     /** Row shift of quantized C    [c]  */
+    OmI32* matDq  ;                     /** Quantized matrix D        [m,c]  */
+    OmInt* vecDs  ;                     /** Row shift of quantized D    [m]  */
+    OmI32* matWq  ;                     /** W1c, W2c, W1o, W2o mantissa [c,4]*/
+    OmInt* matWs  ;                     /** W1c, W2c, W1o, W2o shift    [c,4]*/
+    /*======== Group 2: Runtime Information =================================*/
+    OmInt* vecSw  ;                     /** Row is SW-type branch       [c]  */
+    OmI32* vecA1  ;                     /** Mantissa of W1 in UpdCr()   [c]  */
+    OmInt* vecT1  ;                     /** Shift of W1 in UpdCr()      [c]  */
+    OmI32* vecA2  ;                     /** Mantissa of W2 in UpdCr()   [c]  */
+    OmInt* vecT2  ;                     /** Shift of W2 in UpdCr()      [c]  */
+    OmI32* vecQa  ;                     /** Associated source vector    [c]  */
+    OmI32* vecQs  ;                     /** Independent source vector   [c]  */
+    OmI32* vecQtp ;                     /** Vector Qtp = Qs + Qa        [c]  */
+    OmI32* vecXc  ;                     /** Source update vector        [c]  */
+    OmI32* vecXm  ;                     /** Meter reading vector        [m]  */
+} OmFxp;
+#endif                                  /*| #ifdef LIBOHM_FIX               |*/
+typedef OmCir* (*OmBldFn)(OmInt pt, OmFlt* par, void* usr);
+                                        /** Sweep point builder callback     */
+typedef void (*OmRunFn)(OmCir* cr, OmInt pt, OmFlt* par, void* usr);
+                                        /** Sweep point runner callback      */
+typedef struct OmSym {                  /** Symbolic Analysis Structure      */
+    /*======== Group 0: General Information =================================*/
+    OmCir* cir    ;                     /** Circuit that owns this analysis  */
+    OmInt  numZ   ;                     /** Number of nonzeros in Pb pattern */
+    OmInt  numF   ;                     /** Number of fallbacks in Restamp() */
+    /*======== Group 1: Structure Information ===============================*/
+    OmInt* vecLux ;                     /** X/Y lookup table before cut  [b] */
+    OmInt* vecZb  ;                     /** Index of nonzero in Pb       [z] */
+    OmInt* vecZp  ;                     /** Scatter index in Pn        [z,4] */
+    OmFlt* vecZs  ;                     /** Scatter sign in Pn         [z,4] */
+    OmFlt* matPn0 ;                     /** Incidence part of Pn [n+x,n+x]   */
+    OmInt* vecPv  ;                     /** Pivot order, cached + new [2n+2x]*/
+    /*======== Group 2: Workspace ===========================================*/
+    OmFlt* vecW   ;                     /** Scratch of OmStampWs()       [w] */
+} OmSym;
+typedef void (*OmStpFn)(OmCir* cr, OmInt k, void* usr);
+                                        /** Periodic schedule step callback  */
+#ifdef LIBOHM_ATOMIC                    /*| concurrency layer (opt-in)      |*/
+typedef struct OmCmd {                  /** Timestamped command              */
+    OmInt  typ    ;                     /** Type of command, OMCMD_          */
+    OmInt  br     ;                     /** Branch index (1-based)           */
+    OmInt  stp    ;                     /** Step to apply the command at     */
+    OmFlt  val    ;                     /** Source value or switch state     */
+} OmCmd;
+typedef struct OmChn {                  /** Command Ring and State Snapshot  */
+    /*======== Group 0: General Information =================================*/
+    OmCir* cir    ;                     /** Circuit driven by this channel   */
+    OmInt  numQ   ;                     /** Capacity of ring (power of 2)    */
+    OmInt  numS   ;                     /** Size of snapshot (m + c)         */
+    /*======== Group 1: Command Ring (single producer, single consumer) =====*/
+    OmCmd* vecQ   ;                     /** Ring of commands           [q]   */
+    char   padQ[64];                    /** Keeps head and tail apart        */
+    unsigned int idxH;                  /** Next slot to apply (consumer)    */
+    char   padH[64];                    /** Keeps head and tail apart        */
+    unsigned int idxT;                  /** Next slot to fill (producer)     */
+    char   padT[64];                    /** Keeps tail and snapshot apart    */
+    /*======== Group 2: Snapshot (seqlock, one writer) ======================*/
+    unsigned int numSeq;                /** Sequence, odd while writing      */
+    OmInt  numP   ;                     /** Step of published snapshot       */
+    OmFlt* vecP   ;                     /** Published Xm and Xc      [m+c]   */
+} OmChn;
+#endif                                  /*| #ifdef LIBOHM_ATOMIC            |*/
+typedef struct OmWav {                  /** Source Waveform Engine           */
+    /*======== Group 0: General Information =================================*/
+    OmCir* cir    ;                     /** Circuit driven by generators     */
+    OmInt  numW   ;                     /** Capacity of generators           */
+    OmInt  numU   ;                     /** Number of generators in use      */
+    /*======== Group 1: Generator Information ===============================*/
+    OmInt* vecWt  ;                     /** Type of generator, OMWAV_    [w] */
+    OmInt* vecWb  ;                     /** Branch driven (1-based)      [w] */
+    OmInt* vecWn  ;                     /** Points / reference of PWM    [w] */
+    OmInt* vecWi  ;                     /** Cursor / switch state of PWM [w] */
+    OmFlt* vecWv  ;                     /** Value at current step        [w] */
+    OmFlt* vecWl  ;                     /** Value at previous step       [w] */
+    OmFlt* vecWx  ;                     /** sin / local time / phase     [w] */
+    OmFlt* vecWy  ;                     /** cos of sine                  [w] */
+    OmFlt* vecWp  ;                     /** cos(dw) / period / dphase    [w] */
+    OmFlt* vecWq  ;                     /** sin(dw) / repeat / inverted  [w] */
+    OmFlt* vecWa  ;                     /** Amplitude / duty of PWM      [w] */
+    OmFlt* vecWo  ;                     /** Offset of sine               [w] */
+    OmFlt** vecWd ;                     /** Points of PWL / TAB (owned)  [w] */
+    /*======== Group 2: Workspace ===========================================*/
+    OmInt* vecEb  ;                     /** Switches changing in step    [w] */
+    OmInt* vecEs  ;                     /** New states of the switches   [w] */
+    OmFlt* vecEa  ;                     /** Instants of the changes      [w] */
+    OmFlt* vecE   ;                     /** Scratch of event step      [4c]  */
+} OmWav;
+typedef struct OmBat {                  /** Batch of Circuit Instances       */
+    /*======== Group 0: General Information =================================*/
+    OmCir* cir    ;                     /** Shared stamped operator (ref)    */
+    OmInt  numK   ;                     /** Number of instances              */
+    /*======== Group 1: Instance State, column k is instance k ==============*/
+    OmFlt* matW1m ;                     /** Weight of Xc in UpdCr()   [c,K]  */
+    OmFlt* matW2m ;                     /** Weight of Qa in UpdCr()   [c,K]  */
+    OmFlt* matW1s ;                     /** Weight of Xc in UpdSw()   [c,K]  */
+    OmFlt* matW2s ;                     /** Weight of Qa in UpdSw()   [c,K]  */
+    OmFlt* matQa  ;                     /** Associated source         [c,K]  */
+    OmFlt* matQs  ;                     /** Independent source        [c,K]  */
+    OmFlt* matQtp ;                     /** Qtp = Qs + Qa             [c,K]  */
+    OmFlt* matXm  ;                     /** Meter reading             [m,K]  */
+    OmFlt* matXc  ;                     /** Source update             [c,K]  */
+} OmBat;
+typedef struct OmEns {                  /** Ensemble of Circuit Variants     */
+    /*======== Group 0: General Information =================================*/
+    OmInt  numE   ;                     /** Number of instances              */
+    OmInt  numP   ;                     /** Number of packs of OMENS_LN      */
+    OmInt  numB   ;                     /** Number of branches               */
+    OmInt  numM   ;                     /** Number of meters                 */
+    OmInt  numC   ;                     /** Number of branches after cutting */
+    OmInt  numF   ;                     /** Instances stamped one by one     */
+    /*======== Group 1: Reset Information, lane l is instance p*LN+l =======*/
+    OmInt* vecBtm ;                     /** Type and method of branch  [b]   */
+    OmInt* vecLut ;                     /** Lookup table for branches  [b]   */
+    OmFlt* vecW1c ;                     /** Weight of Xc   (closed) [P,b,LN] */
+    OmFlt* vecW2c ;                     /** Weight of Qa   (closed) [P,b,LN] */
+    OmFlt* vecW1o ;                     /** Weight of Xc   (open)   [P,b,LN] */
+    OmFlt* vecW2o ;                     /** Weight of Qa   (open)   [P,b,LN] */
+    OmFlt* vecQa0 ;                     /** Initial value of Qa     [P,b,LN] */
+    OmFlt* vecQs0 ;                     /** Initial value of Qs     [P,b,LN] */
+    /*======== Group 2: Runtime Information (AoSoA) =========================*/
+    OmFlt* matC   ;                     /** Matrix to calculate Xc [P,c,c,LN]*/
+    OmFlt* matD   ;                     /** Matrix to calculate Xm [P,m,c,LN]*/
+    OmFlt* vecW1m ;                     /** Weight of Xc in UpdCr() [P,c,LN] */
+    OmFlt* vecW2m ;                     /** Weight of Qa in UpdCr() [P,c,LN] */
+    OmFlt* vecW1s ;                     /** Weight of Xc in UpdSw() [P,c,LN] */
+    OmFlt* vecW2s ;                     /** Weight of Qa in UpdSw() [P,c,LN] */
+    OmFlt* vecQa  ;                     /** Associated source       [P,c,LN] */
+    OmFlt* vecQs  ;                     /** Independent source      [P,c,LN] */
+    OmFlt* vecQtp ;                     /** Qtp = Qs + Qa           [P,c,LN] */
+    OmFlt* vecXm  ;                     /** Meter reading           [P,m,LN] */
+    OmFlt* vecXc  ;                     /** Source update           [P,c,LN] */
+} OmEns;
+typedef struct OmEvt {                  /** Event Detector Engine            */
+    /*======== Group 0: General Information =================================*/
+    OmCir* cir    ;                     /** Circuit watched by detectors     */
+    OmInt  numW   ;                     /** Capacity of detectors            */
+    OmInt  numU   ;                     /** Number of detectors in use       */
+    OmInt  numS   ;                     /** Number of OmEvtRun() passes      */
+    OmInt  numF   ;                     /** Number of events of last pass    */
+    /*======== Group 1: Detector Information ================================*/
+    OmInt* vecDk  ;                     /** Source, OMEVT_XC / OMEVT_XM  [w] */
+    OmInt* vecDi  ;                     /** Branch / meter (0-based)     [w] */
+    OmInt* vecDm  ;                     /** Reported events, OMEVT_ mask [w] */
+    OmInt* vecDs  ;                     /** State (0: low, 1: high)      [w] */
+    OmInt* vecDq  ;                     /** Over dv/dt limit at last pass [w]*/
+    OmFlt* vecDl  ;                     /** Level of rising event        [w] */
+    OmFlt* vecDh  ;                     /** Hysteresis, falls at Dl - Dh [w] */
+    OmFlt* vecDr  ;                     /** dv/dt limit (0.0: none)      [w] */
+    OmFlt* vecDv  ;                     /** Value at last pass           [w] */
+    /*======== Group 2: Fired Events of Last Pass ===========================*/
+    OmInt* vecFd  ;                     /** Detector of event (1-based) [2w] */
+    OmInt* vecFt  ;                     /** Type of event, OMEVT_       [2w] */
+    OmFlt* vecFa  ;                     /** Time of event, ascending    [2w] */
+    /*======== Group 3: Workspace ===========================================*/
+    OmFlt* vecX   ;                     /** Values of this pass          [w] */
+    OmInt* vecG   ;                     /** Events of this pass, OMEVT_  [w] */
+} OmEvt;
+typedef OmInt (*OmLufFn)(OmInt m, OmFlt* a, OmInt* pm);
+                                        /** LU factorize in place (getrf)    */
+typedef void (*OmLusFn)(OmInt m, OmInt n, OmFlt* lu, OmInt* pm, OmFlt* b);
+                                        /** LU solve in place (getrs)        */
+typedef void (*OmGmmFn)(OmInt m, OmInt n, OmInt k, OmFlt* c, OmFlt* a,
+                        OmFlt* b);      /** C = A @ B (gemm)                 */
+typedef void (*OmGmvFn)(OmInt m, OmInt n, OmFlt* y, OmFlt* a, OmFlt* x);
+                                        /** y = A @ x (gemv)                 */
+typedef struct OmBk {                   /** Linear Algebra Backend Table     */
+    OmInt   minM  ;                     /** Smallest m routed to backend     */
+    OmLufFn matLuf;                     /** LU factorize (NULL: built-in)    */
+    OmLusFn matLus;                     /** LU solve (NULL: matLuf ignored)  */
+    OmGmmFn matGmm;                     /** GEMM (NULL: built-in)            */
+    OmGmvFn vecGmv;                     /** GEMV (NULL: built-in)            */
+} OmBk;
+
+/*====================== Part 4. Function Declaration =======================*/
+
+/**
+ * @brief       [0] Free an OmCir pointer
+ * @param       cr input OmCir pointer (can be NULL)
+ * @note        if shared (numR > 0), only one reference is dropped
+ */
+void OmDelete(OmCir* cr);
+/**
+ * @brief       [1] Create new unstamped circuit
+ * @param       n number of nodes (excepting GND) (must >= 0)
+ * @param       b number of branches (must >= 0)
+ * @param       m number of meters (must >= 0)
+ * @param       stp time step (must > 0.0)
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        Remember to use OmDelete() to free memory!
+ */
+OmCir* OmCreate(OmInt n, OmInt b, OmInt m, OmFlt stp);
+/**
+ * @brief       [2] Stamp circuit, get ready to run
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @note        do not stamp the same circuit more than once
+ */
+void OmStamp(OmCir* cr);
+/**
+ * @brief       [3] Reset stamped circuit to initial state
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @note        Switches are always set to open state after reset
+ */
+void OmReset(OmCir* cr);
+/**
+ * @brief       [4] Update switch associated source only
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ */
+void OmUpdSw(OmCir* cr);
+/**
+ * @brief       [5] Update circuit (both switch and associated source)
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ */
+void OmUpdCr(OmCir* cr);
+/**
+ * @brief       [6] Update meter readings
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ */
+void OmUpdMt(OmCir* cr);
+/**
+ * @brief       [7] Get meter reading
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       mt meter index (1-based index, range: 1 to numM)
+ * @retval      return meter reading value
+ */
+OmFlt OmGetMt(OmCir* cr, OmInt mt);
+/**
+ * @brief       [8] Get vector Xc
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @retval      return Xc value
+ * @note        for X0/Y0 branch, return 0.0, as they are always cut off
+ * @note        for X1/X2 branch, return branch current
+ * @note        for Y1/Y2/SW branch, return branch voltage
+ */
+OmFlt OmGetXc(OmCir* cr, OmInt br);
+/**
+ * @brief       [9] Set independent source vector Qs
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       x new Qs value
+ * @note        for X0/Y0 branch, do nothing
+ * @note        for X1/X2/X3 branch, set voltage source
+ * @note        for Y1/Y2/Y3/SW branch, set current source
+ */
+void OmSetQs(OmCir* cr, OmInt br, OmFlt x);
+/**
+ * @brief       [10] Set switch state
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       s new switch state (0: open, 1: closed)
+ * @note        only valid for SW-type branch, else will cause error
+ */
+void OmSetSw(OmCir* cr, OmInt br, OmInt s);
+/**
+ * @brief       [11] Set branch configuration
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       n1 node 1 index (1-based index, range: 1 to numN, 0 for GND)
+ * @param       n2 node 2 index (1-based index, range: 1 to numN, 0 for GND)
+ * @param       tm branch type and ode method
+ * @note        do not configure one branch more than once
+ * @note        tm: use OMTYP_* macros defined in this header file
+ * @note        tm: use Trapezoidal rule by default
+ * @note        tm: add negative sign to use Backward Euler rule
+ * @note        tm: add OMMTD_BD2 to positive tm to use BDF2 rule
+ *              (L-stable, 2nd order), history starts from constant
+ *              initial values
+ * @note        tm: a type out of range or BE with OMMTD_BD2 (BDF2 has no
+ *              BE variant) is ignored, the branch stays unconfigured
+ */
+void OmBran(OmCir* cr, OmInt br, OmInt n1, OmInt n2, OmInt tm);
+/**
+ * @brief       [12] Set voltmeter configuration
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       mt meter index (1-based index, range: 1 to numM)
+ * @param       n1 node 1 index (1-based index, range: 1 to numN, 0 for GND)
+ * @param       n2 node 2 index (1-based index, range: 1 to numN, 0 for GND)
+ */
+void OmMetV(OmCir* cr, OmInt mt, OmInt n1, OmInt n2);
+/**
+ * @brief       [13] Set ammeter configuration
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       mt meter index (1-based index, range: 1 to numM)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ */
+void OmMetA(OmCir* cr, OmInt mt, OmInt br);
+/**
+ * @brief       [14] Series connect resistor to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx branch index (1-based index, range: 1 to numB)
+ * @param       res value of resistance to be added
+ * @note        branch must be X0/X1/X2/X3-type
+ * @note        u = res * i
+ */
+void OmAddX(OmCir* cr, OmInt bx, OmFlt res);
+/**
+ * @brief       [15] Parallel connect conductor to Y/SW-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by branch index (1-based index, range: 1 to numB)
+ * @param       con value of conductance to be added
+ * @note        branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        j = con * v
+ */
+void OmAddY(OmCir* cr, OmInt by, OmFlt con);
+/**
+ * @brief       [16] Series connect voltage source to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx branch index (1-based index, range: 1 to numB)
+ * @param       vol value of voltage source to be added
+ * @note        branch must be X1/X2/X3-type
+ * @note        u = vol
+ */
+void OmAddV(OmCir* cr, OmInt bx, OmFlt vol);
+/**
+ * @brief       [17] Parallel connect current source to Y/SW-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by branch index (1-based index, range: 1 to numB)
+ * @param       cur value of current source to be added
+ * @note        branch must be Y1/Y2/Y3/SW-type
+ * @note        j = cur
+ */
+void OmAddI(OmCir* cr, OmInt by, OmFlt cur);
+/**
+ * @brief       [18] Series connect inductor to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx branch index (1-based index, range: 1 to numB)
+ * @param       ind value of inductance to be added
+ * @param       i0 initial current
+ * @note        branch must be X2/X3-type
+ * @note        u = ind * di / dt
+ */
+void OmAddL(OmCir* cr, OmInt bx, OmFlt ind, OmFlt i0);
+/**
+ * @brief       [19] Parallel connect capacitor to Y-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by branch index (1-based index, range: 1 to numB)
+ * @param       cap value of capacitance to be added
+ * @param       v0 initial voltage
+ * @note        branch must be Y2/Y3-type
+ * @note        j = cap * dv / dt
+ */
+void OmAddC(OmCir* cr, OmInt by, OmFlt cap, OmFlt v0);
+/**
+ * @brief       [20] Series connect capacitor to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx branch index (1-based index, range: 1 to numB)
+ * @param       rpc value of reciprocal of capacitance to be added
+ * @param       v0 initial voltage
+ * @note        branch must be X2/X3-type
+ * @note        u = sum(rpc * i * dt)
+ */
+void OmAddQ(OmCir* cr, OmInt bx, OmFlt rpc, OmFlt v0);
+/**
+ * @brief       [21] Parallel connect inductor to Y-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by branch index (1-based index, range: 1 to numB)
+ * @param       rpi value of reciprocal of inductance to be added
+ * @param       i0 initial current
+ * @note        branch must be Y2/Y3-type
+ * @note        j = sum(rpi * v * dt)
+ */
+void OmAddP(OmCir* cr, OmInt by, OmFlt rpi, OmFlt i0);
+/**
+ * @brief       [22] Series connect linear VCVS to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx controlled branch index (1-based index, range: 1 to numB)
+ * @param       cy controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @note        controlled branch must be X0/X1/X2/X3-type
+ * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        u = k * vc
+ */
+void OmAddE(OmCir* cr, OmInt bx, OmInt cy, OmFlt k);
+/**
+ * @brief       [23] Series connect linear CCVS to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx controlled branch index (1-based index, range: 1 to numB)
+ * @param       cx controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @note        controlled branch must be X0/X1/X2/X3-type
+ * @note        controlling branch must be X0/X1/X2/X3-type
+ * @note        u = k * ic
+ */
+void OmAddH(OmCir* cr, OmInt bx, OmInt cx, OmFlt k);
+/**
+ * @brief       [24] Parallel connect linear CCCS to Y/SW-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by controlled branch index (1-based index, range: 1 to numB)
+ * @param       cx controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @note        controlled branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        controlling branch must be X0/X1/X2/X3-type
+ * @note        j = k * ic
+ */
+void OmAddF(OmCir* cr, OmInt by, OmInt cx, OmFlt k);
+/**
+ * @brief       [25] Parallel connect linear VCCS to Y/SW-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by controlled branch index (1-based index, range: 1 to numB)
+ * @param       cy controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @note        controlled branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        j = k * vc
+ */
+void OmAddG(OmCir* cr, OmInt by, OmInt cy, OmFlt k);
+/**
+ * @brief       [26] Series connect differential CCVS to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx controlled branch index (1-based index, range: 1 to numB)
+ * @param       cx controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @param       ic0 initial current of controlling branch
+ * @note        controlled branch must be X3-type
+ * @note        controlling branch must be X0/X1/X2/X3-type
+ * @note        u = k * dic / dt
+ */
+void OmAddM(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt ic0);
+/**
+ * @brief       [27] Parallel connect differential VCCS to Y-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by controlled branch index (1-based index, range: 1 to numB)
+ * @param       cy controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @param       vc0 initial voltage of controlling branch
+ * @note        controlled branch must be Y3-type
+ * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        j = k * dvc / dt
+ */
+void OmAddN(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt vc0);
+/**
+ * @brief       [28] Series connect integral CCVS to X-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bx controlled branch index (1-based index, range: 1 to numB)
+ * @param       cx controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @param       v0 initial voltage
+ * @note        controlled branch must be X3-type
+ * @note        controlling branch must be X0/X1/X2/X3-type
+ * @note        u = sum(k * ic * dt)
+ */
+void OmAddA(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt v0);
+/**
+ * @brief       [29] Parallel connect integral VCCS to Y-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       by controlled branch index (1-based index, range: 1 to numB)
+ * @param       cy controlling branch index (1-based index, range: 1 to numB)
+ * @param       k gain of controlled source
+ * @param       i0 initial current
+ * @note        controlled branch must be Y3-type
+ * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        j = sum(k * vc * dt)
+ */
+void OmAddB(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt i0);
+/**
+ * @brief       [30] Parallel connect switch to SW-type branch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bs switch branch index (1-based index, range: 1 to numB)
+ * @param       k1 closed state coefficient
+ * @param       k2 open state coefficient
+ * @param       ysw switch conductance, <= 0 to tune at stamp time
+ * @param       ron series connected on-resistance (can be 0)
+ * @note        branch must be SW-type
+ * @note        controlling branch must be Y0/Y1/Y2/Y3/SW-type
+ * @note        ja(t+dt) = k1 * ysw * v(t) + i(t), ON
+ * @note        ja(t+dt) = -ysw * v(t) + k2 * i(t), OFF
+ * @note        if you know switch rated voltage (V) and rated current (I)
+ * @note        try k1 = 1, k2 = 0.6569, ysw = 0.2929 * I / V
+ * @note        ysw <= 0 lets OmStamp() pick k1 = 1, k2 = 0 and ysw from
+ *              the Norton view of network at the switch, so that error
+ *              left after a step is equal in both states (OmSwErr()),
+ *              -ysw is the starting value (1.0 if ysw = 0)
+ */
+void OmAddS(OmCir* cr, OmInt bs, OmFlt k1, OmFlt k2, OmFlt ysw, OmFlt ron);
+/**
+ * @brief       [31] Get inverse of input square matrix
+ * @param       m square matrix row / column length (must >= 0)
+ * @param       a input square matrix (cannot be NULL)
+ */
+void OmMatInv(OmInt m, OmFlt* a);
+/**
+ * @brief       [32] Square matrix-matrix multiplication, C = A @ B
+ * @param       m square matrix row / column length (must >= 0)
+ * @param       c input square matrix (cannot be NULL, cannot be A or B)
+ * @param       a input square matrix (cannot be NULL)
+ * @param       b input square matrix (cannot be NULL)
+ */
+void OmMatMul(OmInt m, OmFlt* c, OmFlt* a, OmFlt* b);
+/**
+ * @brief       [33] Matrix-vector multiplication, y = A @ x
+ * @param       m number of rows of matrix A (must >= 0)
+ * @param       n number of columns of matrix A (must >= 0)
+ * @param       y output vector (cannot be NULL, cannot be x), size = m
+ * @param       a input matrix (cannot be NULL), size = m*n
+ * @param       x input vector (cannot be NULL), size = n
+ */
+void OmVecMul(OmInt m, OmInt n, OmFlt* y, OmFlt* a, OmFlt* x);
+/**
+ * @brief       [34] Vector addition, z = x + y
+ * @param       m number of elements of vectors (must >= 0)
+ * @param       z output vector (cannot be NULL, cannot be x or y)
+ * @param       x input vector (cannot be NULL)
+ * @param       y input vector (cannot be NULL)
+ */
+void OmVecAdd(OmInt m, OmFlt* z, OmFlt* x, OmFlt* y);
+/**
+ * @brief       [35] Vector fused multiply-add, y = w1 * x + w2 * y
+ * @param       m number of elements of vectors (must >= 0)
+ * @param       y output vector (cannot be NULL, cannot be x or w1, w2)
+ * @param       w1 input vector (cannot be NULL)
+ * @param       x input vector (cannot be NULL)
+ * @param       w2 input vector (cannot be NULL)
+ */
+void OmVecFma(OmInt m, OmFlt* y, OmFlt* w1, OmFlt* x, OmFlt* w2);
+#ifdef LIBOHM_STDIO                     /*| FILE API (opt-in)               |*/
+/**
+ * @brief       [36] Emit specialized C89 step code for stamped circuit
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       fp output file opened for writing (cannot be NULL)
+ * @param       nm prefix of generated identifiers (cannot be NULL)
+ * @note        matC / matD are baked in as constants, exact zeros skipped
+ * @note        loops are fully unrolled, unit weights are folded away
+ * @note        generated API: nmReset, nmSetQs, nmSetSw, nmUpdSw, nmUpdCr,
+ *              nmUpdMt, runtime state is kept in struct nmState
+ * @note        nmUpdSw only refreshes Xc of SW-type branches
+ * @note        circuits with BDF2 branches or non-finite coefficients
+ *              (inf / nan) emit an #error line only
+ */
+void OmEmitC(OmCir* cr, FILE* fp, const char* nm);
+#endif                                  /*| #ifdef LIBOHM_STDIO             |*/
+/**
+ * @brief       [37] Build block-diagonal sparse runtime form of matC / matD
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       tol relative drop threshold (0.0 keeps all nonzeros)
+ * @note        entry is dropped if |x| <= tol * (max |x| of its row)
+ * @note        kept rows are permuted so that every connected component of
+ *              the coupling graph occupies a contiguous block of rows
+ * @note        OmUpdSw() / OmUpdCr() / OmUpdMt() use the sparse form after
+ *              this call, use negative tol to go back to dense matC / matD
+ */
+void OmSparse(OmCir* cr, OmFlt tol);
+/**
+ * @brief       [38] Update one independent block of circuit
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       k block index (1-based index, range: 1 to numK)
+ * @note        same as OmUpdCr() restricted to rows of block k
+ * @note        only valid after OmSparse() with tol >= 0.0
+ */
+void OmUpdBk(OmCir* cr, OmInt k);
+/**
+ * @brief       [39] Sparse matrix-vector multiplication, y = A @ x
+ * @param       m number of rows of matrix A (must >= 0)
+ * @param       y output vector (cannot be NULL, cannot be x), size = m
+ * @param       p row pointer of A in CSR format, size = m+1
+ * @param       ci column index of nonzeros of A, size = p[m]
+ * @param       v value of nonzeros of A, size = p[m]
+ * @param       x input vector (cannot be NULL)
+ */
+void OmSpmMul(OmInt m, OmFlt* y, OmInt* p, OmInt* ci, OmFlt* v, OmFlt* x);
+#ifdef LIBOHM_FIX                       /*| fixed-point runtime (opt-in)    |*/
+/**
+ * @brief       [40] Create fixed-point runtime of stamped circuit
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        scaling is estimated from matC / matD and initial sources,
+ *              use OmFxpRng() / OmFxpCal() then OmFxpBld() to refine it
+ * @note        cr must outlive the returned pointer
+ * @note        circuits with BDF2 branches are not supported (NULL)
+ * @note        Remember to use OmFxpDel() to free memory!
+ */
+OmFxp* OmFxpNew(OmCir* cr);
+/**
+ * @brief       [41] Free an OmFxp pointer
+ * @param       fx input OmFxp pointer (can be NULL)
+ */
+void OmFxpDel(OmFxp* fx);
+/**
+ * @brief       [42] Set range of independent source
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       r max absolute value that will be passed to OmFxpSetQs()
+ * @note        takes effect at next OmFxpBld()
+ */
+void OmFxpRng(OmFxp* fx, OmInt br, OmFlt r);
+/**
+ * @brief       [43] Record ranges from state of double-precision circuit
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @note        call after OmUpdCr() / OmUpdMt() of fx->cir in a calibration
+ *              run, OmFxpBld() then uses observed ranges instead of bounds
+ */
+void OmFxpCal(OmFxp* fx);
+/**
+ * @brief       [44] Choose per-row scaling, quantize and reset state
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @note        Switches are always set to open state after build
+ */
+void OmFxpBld(OmFxp* fx);
+/**
+ * @brief       [45] Set independent source of fixed-point runtime
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       x new Qs value (saturated to the range of its row)
+ */
+void OmFxpSetQs(OmFxp* fx, OmInt br, OmFlt x);
+/**
+ * @brief       [46] Set switch state of fixed-point runtime
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       s new switch state (0: open, 1: closed)
+ */
+void OmFxpSetSw(OmFxp* fx, OmInt br, OmInt s);
+/**
+ * @brief       [47] Update switch associated source only (fixed-point)
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ */
+void OmFxpUpdSw(OmFxp* fx);
+/**
+ * @brief       [48] Update circuit (fixed-point)
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @note        int64 accumulation, results saturate to int32
+ */
+void OmFxpUpdCr(OmFxp* fx);
+/**
+ * @brief       [49] Update meter readings (fixed-point)
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ */
+void OmFxpUpdMt(OmFxp* fx);
+/**
+ * @brief       [50] Get meter reading of fixed-point runtime
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @param       mt meter index (1-based index, range: 1 to numM)
+ * @retval      return meter reading value converted to OmFlt
+ */
+OmFlt OmFxpGetMt(OmFxp* fx, OmInt mt);
+/**
+ * @brief       [51] Get vector Xc of fixed-point runtime
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @retval      return Xc value converted to OmFlt
+ */
+OmFlt OmFxpGetXc(OmFxp* fx, OmInt br);
+/**
+ * @brief       [52] Compare fixed-point runtime with double-precision path
+ * @param       fx input OmFxp pointer (cannot be NULL)
+ * @note        drive fx and fx->cir with the same inputs, then call this
+ *              after each step, max abs errors are kept in errXc / errXm
+ */
+void OmFxpCmp(OmFxp* fx);
+#endif                                  /*| #ifdef LIBOHM_FIX               |*/
+/**
+ * @brief       [53] Get scratch size required by OmStampWs()
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @retval      return number of OmFlt in scratch
+ */
+OmInt OmStampSz(OmCir* cr);
+/**
+ * @brief       [54] Stamp circuit using caller-provided scratch
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       ws scratch of OmStampSz(cr) OmFlt (NULL to use OMMALLOC)
+ * @note        only runtime members of cr are allocated, OmStamp(cr) is
+ *              the same as OmStampWs(cr, NULL)
+ */
+void OmStampWs(OmCir* cr, OmFlt* ws);
+/**
+ * @brief       [55] Get inverse of square matrix using caller scratch
+ * @param       m square matrix row / column length (must >= 0)
+ * @param       a input square matrix (cannot be NULL)
+ * @param       ws scratch of m * m + m OmFlt (NULL to use OMMALLOC)
+ */
+void OmMatInvWs(OmInt m, OmFlt* a, OmFlt* ws);
+/**
+ * @brief       [56] Run parameter sweep over independent circuits
+ * @param       np number of sweep points (must >= 0)
+ * @param       nd number of parameters per point (must >= 0)
+ * @param       par parameter grid [np,nd], row pt is passed to callbacks
+ * @param       nm number of meter readings kept per point (must >= 0)
+ * @param       res preallocated result table [np,nm]
+ * @param       bld builder, returns new circuit of point pt (cannot be NULL)
+ * @param       run runner of stamped circuit (NULL to call OmUpdMt once)
+ * @param       usr user pointer passed to callbacks
+ * @param       nt number of threads (used only with LIBOHM_PTHREAD)
+ * @retval      return number of points whose builder returned NULL
+ * @note        each point is built, stamped, run, read and deleted by one
+ *              thread; points are split into per-thread ranges and idle
+ *              threads steal half of the largest remaining range
+ * @note        builder may return unstamped or stamped circuit, unstamped
+ *              circuits are stamped with a per-thread scratch arena
+ * @note        callbacks run concurrently and must be thread-safe
+ * @note        range of a thread that cannot be created is stolen by the
+ *              calling thread
+ */
+OmInt OmSweep(OmInt np, OmInt nd, OmFlt* par, OmInt nm, OmFlt* res,
+              OmBldFn bld, OmRunFn run, void* usr, OmInt nt);
+/**
+ * @brief       [57] Create symbolic analysis of circuit and stamp it
+ * @param       cr input unstamped OmCir pointer with elements added
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        caches X/Y classification, Pn scatter pattern, pivot order
+ *              and workspace, cr keeps its setup members after stamping
+ * @note        Remember to use OmSymDel() before OmDelete(cr)!
+ */
+OmSym* OmSymNew(OmCir* cr);
+/**
+ * @brief       [58] Free an OmSym pointer
+ * @param       sy input OmSym pointer (can be NULL)
+ */
+void OmSymDel(OmSym* sy);
+/**
+ * @brief       [59] Clear element values of circuit, keep topology
+ * @param       cr input OmCir pointer with setup members (cannot be NULL)
+ * @note        valid for unstamped circuit or circuit passed to OmSymNew()
+ * @note        use OmAddX() ... OmAddS() afterwards to set new values
+ */
+void OmClear(OmCir* cr);
+/**
+ * @brief       [60] Stamp new element values with cached analysis
+ * @param       sy input OmSym pointer (cannot be NULL)
+ * @retval      return 0 if cached pattern and pivot order were used
+ * @retval      return 1 if a new nonzero or another pivot order forced a
+ *              fallback
+ * @note        refills matC / matD of sy->cir in place and resets it,
+ *              nothing is allocated
+ * @note        result is bitwise equal to a fresh OmStamp() of the values,
+ *              pivot order is searched again (cheap) and compared, LU
+ *              is built-in (see LIBOHM_BK)
+ * @note        sparse form is dropped, call OmSparse() again if needed
+ */
+OmInt OmRestamp(OmSym* sy);
+/**
+ * @brief       [61] Find periodic steady state by Newton-shooting
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       np number of steps in one period (must > 0)
+ * @param       fn schedule, sets Qs / switches of step k (cannot be NULL)
+ * @param       usr user pointer passed to fn
+ * @param       tol relative tolerance of |Qa(T) - Qa(0)| (e.g. 1e-9)
+ * @param       itm max number of Newton iterations (e.g. 5)
+ * @retval      return number of Newton iterations if converged, else -1
+ * @note        one step is fn(cr, k, usr) followed by OmUpdCr(cr), fn may
+ *              call OmUpdSw() itself after OmSetSw()
+ * @note        one period is run first so that switch states are those of
+ *              period end, then the period map is linearized by k + 1
+ *              finite-difference period runs (exact as map is affine in Qa)
+ * @note        k counts rows with W1m or W2m != 0 at period end, the other
+ *              rows end every period at Qa = 0 and are kept fixed
+ * @note        on success cr is left at start of a period in steady state,
+ *              on failure its state at entry (after first period) is kept
+ * @note        circuits with BDF2 branches are not supported (return -1)
+ */
+OmInt OmSteady(OmCir* cr, OmInt np, OmStpFn fn, void* usr, OmFlt tol,
+               OmInt itm);
+/**
+ * @brief       [62] Initialize associated sources at DC equilibrium
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @retval      return 0 if succeed, return -1 if no equilibrium exists
+ * @note        solves (I - W1m C - W2m) Qa = W1m C Qs for present sources
+ *              and switch states, then sets Qa, Qtp and Xc = C Qtp
+ * @note        cr is not changed if the system is singular (e.g. a
+ *              capacitor charged by a DC current source), detected by a
+ *              pivot below 1e-12 of its row in a pivoted LU
+ * @note        circuits with BDF2 branches are not supported (return -1)
+ */
+OmInt OmInitDC(OmCir* cr);
+/**
+ * @brief       [63] Get size of runtime snapshot
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @retval      return number of OmFlt in snapshot
+ */
+OmInt OmSnpSz(OmCir* cr);
+/**
+ * @brief       [64] Save runtime state to snapshot
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       sv snapshot of OmSnpSz(cr) OmFlt (cannot be NULL)
+ * @note        saves Qa, Qs, Qtp, Xc, switch weights, Xm, states of
+ *              auto-commutated switches and Qb of BDF2 branches, sv is
+ *              plain data and can be
+ *              written to file as a restart checkpoint
+ */
+void OmSave(OmCir* cr, OmFlt* sv);
+/**
+ * @brief       [65] Restore runtime state from snapshot
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       sv snapshot saved by OmSave() from same circuit
+ */
+void OmRestore(OmCir* cr, OmFlt* sv);
+/**
+ * @brief       [66] Update circuit with switch event inside the step
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       br switch branch index (1-based index, range: 1 to numB)
+ * @param       s new switch state (0: open, 1: closed)
+ * @param       a event instant as fraction of timStp (range: 0.0 to 1.0)
+ * @param       nsw number of OmUpdSw() after switching (like OmSetSw())
+ * @param       ws scratch of OmSnpSz(cr) OmFlt (cannot be NULL)
+ * @note        replaces OmUpdCr() of the step: steps with old state,
+ *              interpolates state at event, switches, steps one timStp
+ *              and interpolates back to step end (re-synchronization)
+ */
+void OmUpdEv(OmCir* cr, OmInt br, OmInt s, OmFlt a, OmInt nsw, OmFlt* ws);
+/**
+ * @brief       [67] Make SW-type branch commutate as diode
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bs branch index (1-based index, range: 1 to numB)
+ * @param       von closes when open and branch voltage > von
+ * @param       ioff opens when closed and branch current < ioff
+ * @note        call OmAddS() of the branch first, anode is node 1
+ * @note        calling it again for the same branch updates the rule
+ */
+void OmAddD(OmCir* cr, OmInt bs, OmFlt von, OmFlt ioff);
+/**
+ * @brief       [68] Make SW-type branch commutate as thyristor
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @param       bs branch index (1-based index, range: 1 to numB)
+ * @param       von closes when open, gated and branch voltage > von
+ * @param       ioff opens when closed and branch current < ioff
+ * @note        call OmAddS() of the branch first, anode is node 1
+ */
+void OmAddT(OmCir* cr, OmInt bs, OmFlt von, OmFlt ioff);
+/**
+ * @brief       [69] Set gate signal of thyristor
+ * @param       cr input OmCir pointer (cannot be NULL)
+ * @param       bs branch index (1-based index, range: 1 to numB)
+ * @param       g gate signal (0: off, 1: on)
+ * @note        thyristor latches, g = 0 does not open a closed thyristor
+ */
+void OmSetGt(OmCir* cr, OmInt bs, OmInt g);
+/**
+ * @brief       [70] Commutate auto switches after OmUpdCr()
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       nsw number of OmUpdSw() after state changes
+ * @retval      return number of state changes
+ * @note        checks every rule in one pass with v = Xc and
+ *              i = g * v + Qtp of the switch row, changed switches are
+ *              set like OmSetSw(), then rules are checked again after
+ *              each OmUpdSw() so that commutation can cascade
+ * @note        a cascaded change restarts the nsw updates (at most numA
+ *              restarts), so nsw updates follow the last change
+ * @note        conductance g of a switch is read from Pb at stamp time
+ * @note        do not call OmSetSw() on auto-commutated switches
+ */
+OmInt OmUpdCm(OmCir* cr, OmInt nsw);
+#ifdef LIBOHM_STDIO                     /*| FILE API (opt-in)               |*/
+/**
+ * @brief       [71] Create circuit from text or binary netlist
+ * @param       fp input netlist file opened for reading (cannot be NULL)
+ * @param       stp simulation time step (must be positive)
+ * @param       ln output line of first error (record if binary), 0 if
+ *              none, -1 if file or header is unreadable (can be NULL)
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        numN, numB and numM are taken from the largest indices,
+ *              the file is read in one pass and binary is detected from
+ *              its header, see doc.txt for the netlist format
+ * @note        returned circuit is not stamped yet
+ */
+OmCir* OmLoad(FILE* fp, OmFlt stp, OmInt* ln);
+/**
+ * @brief       [72] Convert text netlist to binary netlist
+ * @param       fi input text netlist opened for reading (cannot be NULL)
+ * @param       fo output binary file opened for writing (cannot be NULL)
+ * @param       ln output line of first error, 0 if none (can be NULL)
+ * @retval      return number of records written, return -1 if failed
+ * @note        binary netlist uses native byte order and the OmInt and
+ *              OmFlt of this build, OmLoad() rejects a foreign one
+ */
+OmInt OmNetBin(FILE* fi, FILE* fo, OmInt* ln);
+#endif                                  /*| #ifdef LIBOHM_STDIO             |*/
+/**
+ * @brief       [73] Reduce resistive part of circuit before stamping
+ * @param       cr input unstamped OmCir pointer (cannot be NULL)
+ * @retval      return number of branches removed
+ * @note        only X0/Y0 branches holding nothing but X or Y, not
+ *              controlling or controlled and not metered (pure) are
+ *              touched: open ones and dangling ones are removed, shorts
+ *              are contracted, parallel / series ones are merged into a
+ *              neighbour and internal nodes joining three of them are
+ *              eliminated (star-mesh), nodes not used anymore are removed
+ * @note        open means exactly zero conductance, branches with negative
+ *              resistance or conductance are not touched
+ * @note        voltmeter nodes are kept, removed branches stay as empty
+ *              Y0 branches so that branch indices do not change
+ * @note        call after all OmBran()/OmAdd*()/OmMet*() of the circuit
+ */
+OmInt OmReduce(OmCir* cr);
+/**
+ * @brief       [74] Reduce order of linear dynamics (Krylov projection)
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       kb branches to keep as ports (1-based index, can be NULL)
+ * @param       nk number of branches in kb
+ * @param       q max order of reduced dynamics
+ * @param       tol relative tolerance to drop a dependent Krylov vector
+ * @param       map output new branch index of each branch, 0 if reduced
+ *              away or cut (1-based index, [numB], can be NULL)
+ * @param       pol output poles of reduced dynamics as (re, im) pairs
+ *              of the discrete step operator ([2*q], can be NULL)
+ * @retval      return valid pointer if succed, return NULL if failed
+ *              (also if pol is given and its QR did not converge)
+ * @note        SW rows, stateless source rows, rows with Qs0 and kb rows
+ *              are ports and stay exact, the other rows are projected
+ *              onto an orthonormal basis of the block Krylov space of
+ *              (I - A)^-1 B, so low frequency moments are matched
+ * @note        returned circuit is stamped and reset, its first branches
+ *              are the ports in original order followed by the reduced
+ *              states (numC - ports), OmUpdCr()/OmGetMt() work as usual
+ * @note        check that every pole has a magnitude below 1.0
+ * @note        circuits with BDF2 branches are not supported (NULL)
+ */
+OmCir* OmMor(OmCir* cr, OmInt* kb, OmInt nk, OmInt q, OmFlt tol,
+             OmInt* map, OmFlt* pol);
+/**
+ * @brief       [75] Eigenvalues of general real matrix
+ * @param       m order of matrix
+ * @param       a input matrix [m,m], overwritten
+ * @param       wr output real part of eigenvalues [m]
+ * @param       wi output imaginary part of eigenvalues [m]
+ * @retval      return 0 if succeed, return -1 if QR did not converge
+ * @note        Hessenberg reduction and shifted QR iteration
+ */
+OmInt OmMatEig(OmInt m, OmFlt* a, OmFlt* wr, OmFlt* wi);
+#ifdef LIBOHM_ATOMIC                    /*| concurrency layer (opt-in)      |*/
+/**
+ * @brief       [76] Create command ring and snapshot of stamped circuit
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       nq capacity of command ring (rounded up to power of 2)
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        one controller thread may call OmChnPut(), the simulation
+ *              thread calls OmChnRun() and OmChnPub(), any number of
+ *              monitor threads may call OmChnGet(), nobody blocks
+ */
+OmChn* OmChnNew(OmCir* cr, OmInt nq);
+/**
+ * @brief       [77] Delete channel (does not delete its circuit)
+ * @param       ch input OmChn pointer (cannot be NULL)
+ */
+void OmChnDel(OmChn* ch);
+/**
+ * @brief       [78] Queue command (controller thread)
+ * @param       ch input OmChn pointer (cannot be NULL)
+ * @param       typ type of command (OMCMD_QS, OMCMD_SW or OMCMD_GT)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       x source value, or switch / gate state (0.0 or 1.0)
+ * @param       k step to apply the command at (0 for next step)
+ * @retval      return 0 if queued, return -1 if ring is full
+ * @note        steps of queued commands must not decrease
+ */
+OmInt OmChnPut(OmChn* ch, OmInt typ, OmInt br, OmFlt x, OmInt k);
+/**
+ * @brief       [79] Apply due commands at step boundary (simulation thread)
+ * @param       ch input OmChn pointer (cannot be NULL)
+ * @param       k current step, commands with step <= k are applied
+ * @retval      return number of applied OMCMD_SW commands
+ * @note        call OmUpdSw() afterwards if it returns non-zero
+ */
+OmInt OmChnRun(OmChn* ch, OmInt k);
+/**
+ * @brief       [80] Publish Xm and Xc after OmUpdMt() (simulation thread)
+ * @param       ch input OmChn pointer (cannot be NULL)
+ * @param       k current step
+ */
+void OmChnPub(OmChn* ch, OmInt k);
+/**
+ * @brief       [81] Read consistent snapshot (monitor threads)
+ * @param       ch input OmChn pointer (cannot be NULL)
+ * @param       xm output meter readings [numM] (can be NULL)
+ * @param       xc output Xc in row order of vecLut [numC] (can be NULL)
+ * @retval      return step of the snapshot, return -1 if none yet
+ * @note        retries while the simulation thread is publishing
+ */
+OmInt OmChnGet(OmChn* ch, OmFlt* xm, OmFlt* xc);
+#endif                                  /*| #ifdef LIBOHM_ATOMIC            |*/
+/**
+ * @brief       [82] Create waveform engine of stamped circuit
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       nw capacity of generators (must > 0)
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        generators are evaluated in batch by OmWavRun(), which
+ *              replaces OmSetQs() / OmSetSw() / OmUpdCr() of the step loop
+ */
+OmWav* OmWavNew(OmCir* cr, OmInt nw);
+/**
+ * @brief       [83] Delete waveform engine (does not delete its circuit)
+ * @param       wv input OmWav pointer (can be NULL)
+ */
+void OmWavDel(OmWav* wv);
+/**
+ * @brief       [84] Drive source of branch by sine
+ * @param       wv input OmWav pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 0 to numB)
+ * @param       am amplitude
+ * @param       f frequency (Hz)
+ * @param       ph phase at step 0 (rad)
+ * @param       dc offset
+ * @retval      return generator index (1-based), return -1 if failed
+ * @note        br = 0 drives no branch, e.g. reference of OmWavPwm()
+ * @note        x = am * sin(2 * pi * f * t + ph) + dc, advanced by a
+ *              renormalized rotation, sin() / cos() are called here only
+ */
+OmInt OmWavSin(OmWav* wv, OmInt br, OmFlt am, OmFlt f, OmFlt ph, OmFlt dc);
+/**
+ * @brief       [85] Drive source of branch by piecewise linear waveform
+ * @param       wv input OmWav pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 0 to numB)
+ * @param       n number of points (must > 0)
+ * @param       t time of points, ascending [n] (copied)
+ * @param       v value of points [n] (copied)
+ * @param       per period to repeat with (<= 0.0: hold last value)
+ * @retval      return generator index (1-based), return -1 if failed
+ * @note        holds v[0] before t[0], cursor moves forward only
+ */
+OmInt OmWavPwl(OmWav* wv, OmInt br, OmInt n, OmFlt* t, OmFlt* v, OmFlt per);
+/**
+ * @brief       [86] Drive source of branch by lookup table, one per step
+ * @param       wv input OmWav pointer (cannot be NULL)
+ * @param       br branch index (1-based index, range: 0 to numB)
+ * @param       n number of samples (must > 0)
+ * @param       v samples [n] (copied)
+ * @param       rep repeat table (0: hold last sample)
+ * @retval      return generator index (1-based), return -1 if failed
+ */
+OmInt OmWavTab(OmWav* wv, OmInt br, OmInt n, OmFlt* v, OmInt rep);
+/**
+ * @brief       [87] Drive SW-type branch by PWM carrier comparator
+ * @param       wv input OmWav pointer (cannot be NULL)
+ * @param       bs switch branch index (1-based index, range: 1 to numB)
+ * @param       f frequency of triangle carrier in -1.0 to 1.0 (Hz)
+ * @param       ph carrier phase at step 0 (range: 0.0 to 1.0, 0.0 is -1.0)
+ * @param       ref reference generator (1-based, 0: constant d)
+ * @param       d constant reference, or gain of reference generator
+ * @param       inv complemented output (e.g. lower switch of a leg)
+ * @retval      return generator index (1-based), return -1 if failed
+ * @note        switch is closed while reference > carrier (inv = 0),
+ *              initial state is set by OmSetSw(), call OmUpdSw() after
+ * @note        carrier must change by less than half period in one step
+ */
+OmInt OmWavPwm(OmWav* wv, OmInt bs, OmFlt f, OmFlt ph, OmInt ref, OmFlt d,
+               OmInt inv);
+/**
+ * @brief       [88] Evaluate all generators and update circuit by a step
+ * @param       wv input OmWav pointer (cannot be NULL)
+ * @param       nsw number of OmUpdSw() after switching (like OmSetSw())
+ * @retval      return number of switch changes in the step
+ * @note        replaces OmUpdCr() of the step: sources take the value of
+ *              step start, comparators are solved for the crossing instant
+ *              with linear reference and piecewise linear carrier, and
+ *              switch changes are placed inside the step like OmUpdEv()
+ * @note        the step is split at each distinct crossing instant (one
+ *              more OmUpdCr() per instant), changes are applied in order,
+ *              pulses shorter than one step are dropped
+ */
+OmInt OmWavRun(OmWav* wv, OmInt nsw);
+/**
+ * @brief       [89] Create batch of instances sharing stamped circuit
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       nk number of instances (must > 0)
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        every instance starts from current state of cr, matC /
+ *              matD (or sparse form) of cr are shared read-only, and cr
+ *              is referenced (numR) so OmDelete(cr) may be called before
+ * @note        row i of instance k is at [i*K+k], row of branch is vecLut
+ * @note        auto-commutated switches of cr are not batched
+ * @note        circuits with BDF2 branches are not supported (NULL)
+ */
+OmBat* OmBatNew(OmCir* cr, OmInt nk);
+/**
+ * @brief       [90] Delete batch and drop its reference to circuit
+ * @param       bt input OmBat pointer (can be NULL)
+ */
+void OmBatDel(OmBat* bt);
+/**
+ * @brief       [91] Reset all instances to initial state, like OmReset()
+ * @param       bt input OmBat pointer (cannot be NULL)
+ */
+void OmBatReset(OmBat* bt);
+/**
+ * @brief       [92] Set independent source of one instance, like OmSetQs()
+ * @param       bt input OmBat pointer (cannot be NULL)
+ * @param       k instance index (1-based index, range: 1 to numK)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       x new Qs value
+ */
+void OmBatSetQs(OmBat* bt, OmInt k, OmInt br, OmFlt x);
+/**
+ * @brief       [93] Set switch state of one instance, like OmSetSw()
+ * @param       bt input OmBat pointer (cannot be NULL)
+ * @param       k instance index (1-based index, range: 1 to numK)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       s new switch state (0: open, 1: closed)
+ */
+void OmBatSetSw(OmBat* bt, OmInt k, OmInt br, OmInt s);
+/**
+ * @brief       [94] Update switch associated source of all instances
+ * @param       bt input OmBat pointer (cannot be NULL)
+ */
+void OmBatUpdSw(OmBat* bt);
+/**
+ * @brief       [95] Update circuit of all instances, Xc = C @ Qtp as GEMM
+ * @param       bt input OmBat pointer (cannot be NULL)
+ * @note        same sums as OmUpdCr() of each instance, bitwise equal
+ */
+void OmBatUpdCr(OmBat* bt);
+/**
+ * @brief       [96] Update meter readings of all instances, Xm = D @ Qtp
+ * @param       bt input OmBat pointer (cannot be NULL)
+ */
+void OmBatUpdMt(OmBat* bt);
+/**
+ * @brief       [97] Get meter reading of one instance
+ * @param       bt input OmBat pointer (cannot be NULL)
+ * @param       k instance index (1-based index, range: 1 to numK)
+ * @param       mt meter index (1-based index, range: 1 to numM)
+ * @retval      return meter reading value
+ */
+OmFlt OmBatGetMt(OmBat* bt, OmInt k, OmInt mt);
+/**
+ * @brief       [98] Get Xc of one instance, like OmGetXc()
+ * @param       bt input OmBat pointer (cannot be NULL)
+ * @param       k instance index (1-based index, range: 1 to numK)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @retval      return Xc value (0.0 for cut branch)
+ */
+OmFlt OmBatGetXc(OmBat* bt, OmInt k, OmInt br);
+/**
+ * @brief       [99] Stamp variants of one topology as SIMD ensemble
+ * @param       crs input unstamped circuits [ne] (cannot be NULL)
+ * @param       ne number of instances (must > 0)
+ * @retval      return valid pointer if succed, return NULL if topology of
+ *              circuits differs (nodes, branches, types, meters)
+ * @note        element values may differ, instance e takes lane
+ *              (e-1) % OMENS_LN of pack (e-1) / OMENS_LN, and assembly,
+ *              LU inversion, products and steps run across lanes
+ * @note        pivot order of a pack is the one most of its lanes share, a
+ *              lane whose own order differs is stamped alone (numF), so
+ *              every instance is bitwise equal to OmStamp() of it
+ * @note        crs are not changed, auto-commutated switches are ignored
+ * @note        circuits with BDF2 branches or switches tuned at stamp time
+ *              (OmAddS() with ysw <= 0) are not supported (NULL)
+ */
+OmEns* OmEnsNew(OmCir** crs, OmInt ne);
+/**
+ * @brief       [100] Delete ensemble
+ * @param       en input OmEns pointer (can be NULL)
+ */
+void OmEnsDel(OmEns* en);
+/**
+ * @brief       [101] Reset all instances to initial state, like OmReset()
+ * @param       en input OmEns pointer (cannot be NULL)
+ */
+void OmEnsReset(OmEns* en);
+/**
+ * @brief       [102] Set independent source of one instance, like OmSetQs()
+ * @param       en input OmEns pointer (cannot be NULL)
+ * @param       e instance index (1-based index, range: 1 to numE)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       x new Qs value
+ */
+void OmEnsSetQs(OmEns* en, OmInt e, OmInt br, OmFlt x);
+/**
+ * @brief       [103] Set switch state of one instance, like OmSetSw()
+ * @param       en input OmEns pointer (cannot be NULL)
+ * @param       e instance index (1-based index, range: 1 to numE)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @param       s new switch state (0: open, 1: closed)
+ */
+void OmEnsSetSw(OmEns* en, OmInt e, OmInt br, OmInt s);
+/**
+ * @brief       [104] Update switch associated source of all instances
+ * @param       en input OmEns pointer (cannot be NULL)
+ */
+void OmEnsUpdSw(OmEns* en);
+/**
+ * @brief       [105] Update circuit of all instances, lanes in SIMD
+ * @param       en input OmEns pointer (cannot be NULL)
+ */
+void OmEnsUpdCr(OmEns* en);
+/**
+ * @brief       [106] Update meter readings of all instances
+ * @param       en input OmEns pointer (cannot be NULL)
+ */
+void OmEnsUpdMt(OmEns* en);
+/**
+ * @brief       [107] Get meter reading of one instance
+ * @param       en input OmEns pointer (cannot be NULL)
+ * @param       e instance index (1-based index, range: 1 to numE)
+ * @param       mt meter index (1-based index, range: 1 to numM)
+ * @retval      return meter reading value
+ */
+OmFlt OmEnsGetMt(OmEns* en, OmInt e, OmInt mt);
+/**
+ * @brief       [108] Get Xc of one instance, like OmGetXc()
+ * @param       en input OmEns pointer (cannot be NULL)
+ * @param       e instance index (1-based index, range: 1 to numE)
+ * @param       br branch index (1-based index, range: 1 to numB)
+ * @retval      return Xc value (0.0 for cut branch)
+ */
+OmFlt OmEnsGetXc(OmEns* en, OmInt e, OmInt br);
+/**
+ * @brief       [109] Advance circuit by ns steps with sources held
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       ns number of steps (must >= 0)
+ * @retval      return 1 if powers of step operator are used, 0 if stepped
+ * @note        same as ns calls of OmUpdCr() while Qs and switches are
+ *              held, up to rounding, so it fits idle or settling spans
+ * @note        Qa' = G @ [Qa, 1] with G = [W1m*C+W2m, W1m*C@Qs; 0, 1],
+ *              G^(2^k) is cached and reused while W1m, W2m and Qs stay,
+ *              so a span costs O(c^2 log ns) once the cache is built
+ * @note        short spans without cache (ns <= numC) and circuits with
+ *              BDF2 branches are stepped, auto switches of cr are not
+ *              checked inside the span
+ */
+OmInt OmAdvance(OmCir* cr, OmInt ns);
+/**
+ * @brief       [110] Build state-space runtime form on dynamic states only
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       nu number of input branches in vu, 0 to take rows whose Qs
+ *              is nonzero now, negative to go back to full runtime form
+ * @param       vu input branches (1-based index, can be NULL if nu <= 0)
+ * @retval      return number of dynamic states d (numS)
+ * @note        a row is a state if any of its W1/W2 (closed or open) or Qa
+ *              is nonzero, Qa of other rows stays zero, so OmUpdSw() /
+ *              OmUpdCr() / OmUpdMt() only touch d + inputs columns (numU)
+ *              and cost d * numU instead of c * c after this call
+ * @note        Xc is only updated on states, Qs of rows which are neither
+ *              state nor input is ignored, results match the full form
+ * @note        OmSparse() and refilling matC go back to full runtime form
+ */
+OmInt OmSsx(OmCir* cr, OmInt nu, OmInt* vu);
+/**
+ * @brief       [111] Export discrete state-space form of current switches
+ * @param       cr input OmCir pointer with state-space form (OmSsx())
+ * @param       a output A [d,d] (can be NULL)
+ * @param       b output B [d,k] (can be NULL)
+ * @param       cm output Cm [m,d] (can be NULL)
+ * @param       dm output Dm [m,k] (can be NULL)
+ * @param       bx output branch of state [d] (1-based index, can be NULL)
+ * @param       bu output branch of column [k] (1-based index, can be NULL)
+ * @retval      return number of states d, -1 if there is no state-space form
+ *              or the circuit has BDF2 branches (two histories per row)
+ * @note        x is Qa of states, u is Qs of all k = numU columns, then
+ *              OmUpdCr() is x' = A @ x + B @ u, OmUpdMt() is Xm = Cm @ x
+ *              + Dm @ u (x before the update), W1m / W2m are folded in
+ */
+OmInt OmGetSs(OmCir* cr, OmFlt* a, OmFlt* b, OmFlt* cm, OmFlt* dm,
+              OmInt* bx, OmInt* bu);
+/**
+ * @brief       [112] Get expected switching error of SW-type branch
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       bs switch branch index (1-based index, range: 1 to numB)
+ * @retval      return ratio of error left after one step (0.0 to 1.0)
+ * @note        error of switching transient of the associated discrete
+ *              circuit shrinks by this ratio per OmUpdSw() / OmUpdCr(),
+ *              worse one of closed and open state, 0.0 if not SW-type
+ * @note        rated on Norton view of network at the switch (port
+ *              conductance of stamped circuit, with L / C companions)
+ * @note        n OmUpdSw() after a switch change leave ratio^n of the
+ *              jump, i.e. n = log(tol) / log(ratio) for tolerance tol
+ */
+OmFlt OmSwErr(OmCir* cr, OmInt bs);
+/**
+ * @brief       [113] Create event detector engine of stamped circuit
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       nw capacity of detectors (must > 0)
+ * @retval      return valid pointer if succed, return NULL if failed
+ * @note        detectors are evaluated in one pass by OmEvtRun() after
+ *              OmUpdCr() / OmUpdMt() of each step, times of events are
+ *              counted from the first pass (0.0 is value at OmEvtAdd())
+ */
+OmEvt* OmEvtNew(OmCir* cr, OmInt nw);
+/**
+ * @brief       [114] Delete event detector engine (does not delete circuit)
+ * @param       ev input OmEvt pointer (can be NULL)
+ */
+void OmEvtDel(OmEvt* ev);
+/**
+ * @brief       [115] Add level / crossing / dv/dt detector
+ * @param       ev input OmEvt pointer (cannot be NULL)
+ * @param       src watched vector, OMEVT_XC or OMEVT_XM
+ * @param       id branch (OMEVT_XC) or meter (OMEVT_XM) (1-based index)
+ * @param       lv level of rising crossing
+ * @param       hy hysteresis, falling crossing is at lv - hy (must >= 0.0)
+ * @param       msk reported events, OR of OMEVT_UP / OMEVT_DN / OMEVT_DV
+ * @param       dvl limit of |dv/dt| for OMEVT_DV (must >= 0.0)
+ * @retval      return detector index (1-based), return -1 if failed
+ * @note        Schmitt state starts from value now (high if >= lv), it
+ *              flips even if its crossing is not in msk, OMEVT_DV fires
+ *              on the first step over dvl only (edge, not level)
+ * @note        cut branch (vecLut < 0) can not be watched, under OmSsx()
+ *              Xc of rows which are not states is not updated
+ */
+OmInt OmEvtAdd(OmEvt* ev, OmInt src, OmInt id, OmFlt lv, OmFlt hy,
+               OmInt msk, OmFlt dvl);
+/**
+ * @brief       [116] Evaluate all detectors after a step
+ * @param       ev input OmEvt pointer (cannot be NULL)
+ * @retval      return number of fired events (numF)
+ * @note        fired events are vecFd / vecFt / vecFa [numF], in order of
+ *              time, crossing time is interpolated linearly in the step,
+ *              OMEVT_DV is placed at end of the step
+ * @note        values are gathered first, then all detectors are compared
+ *              without branches, only fired ones are visited after
+ */
+OmInt OmEvtRun(OmEvt* ev);
+/**
+ * @brief       [117] Register linear algebra backend of all circuits
+ * @param       bk input backend table (NULL: built-in C89 kernels)
+ * @note        table is not copied and must outlive its use, register
+ *              it before stamping, it is shared by all threads
+ * @note        OmMatInv() / OmMatInvWs() use matLuf + matLus (solve with
+ *              identity), OmMatMul() / OmBatUpdCr() use matGmm, OmVecMul()
+ *              / OmUpdCr() / OmUpdMt() use vecGmv, if m >= minM and the
+ *              slot is not NULL, else the built-in kernels run
+ * @note        matLuf is ignored if matLus is NULL, both or none of them
+ *              are used
+ * @note        matrices are row-major, pm holds m pivots of matLuf only
+ *              read back by matLus, b of matLus is [m,n], matLuf returns
+ *              nonzero on a singular matrix (built-in inverse runs then)
+ * @note        define LIBOHM_BK as name of an extern OmBk object before
+ *              including with LIBOHM_C to register it at compile time
+ * @note        OmVecAdd() / OmVecFma(), sparse / state-space / ensemble
+ *              kernels and OmRestamp() stay built-in
+ */
+void OmSetBk(OmBk* bk);
+/**
+ * @brief       [118] Run long transient parallel in time (Parareal)
+ * @param       crs stamped instances of one circuit [nt] (cannot be NULL)
+ * @param       nt number of instances and threads (LIBOHM_PTHREAD)
+ * @param       np number of time slices (must > 0)
+ * @param       ns number of steps in one slice (must > 0)
+ * @param       fn schedule, sets Qs / switches of step k (cannot be NULL)
+ * @param       usr user pointer passed to fn
+ * @param       tol relative tolerance of Qa change at slice starts
+ * @param       itm max number of iterations (e.g. 5)
+ * @param       u output Qa at slice starts and end [np+1,c] (can be NULL)
+ * @retval      return number of iterations if converged, else -1
+ * @note        runs np * ns steps of fn(cr, k, usr) followed by OmUpdCr()
+ *              from Qa of crs[0], fn must set inputs of step k from k
+ *              alone (slices start anywhere) and is called concurrently
+ *              on different instances, so it must be thread-safe
+ * @note        coarse propagator is G^ns of the step operator of slice
+ *              start (sources and switches held, like OmAdvance()), A^ns
+ *              and S = A^0 + ... + A^(ns-1) of A = W1 * C + W2 are built
+ *              by squaring once per distinct switch state (W1 / W2), held
+ *              sources only enter as S @ b, fine slices run on crs[] in
+ *              parallel by threads created once, then slice starts are
+ *              corrected serially
+ * @note        serial cost is O(c^3 log ns) per distinct switch state
+ *              plus O(c^2) per slice and iteration, a fine slice costs
+ *              O(ns c^2), so speedup needs few switch states compared to
+ *              np (e.g. PWM legs repeat the same states)
+ * @note        iteration i leaves the first i + 1 slices exact, so result
+ *              is the serial one after np - 1 iterations at most, crs[0]
+ *              is left at end of the last slice
+ * @note        slices of a thread that cannot be created run on the
+ *              calling thread
+ * @note        circuits with BDF2 branches are not supported (return -1)
+ */
+OmInt OmParareal(OmCir** crs, OmInt nt, OmInt np, OmInt ns, OmStpFn fn,
+                 void* usr, OmFlt tol, OmInt itm, OmFlt* u);
+#ifdef LIBOHM_MATH                      /*| step advisor, libm (opt-in)     |*/
+/**
+ * @brief       [119] Rate modes of step operator and advise time step
+ * @param       cr input stamped OmCir pointer (cannot be NULL)
+ * @param       sw switch states, -1: present, 0: all open, 1: all closed
+ * @param       tol relative error target of modes (e.g. 1e-3)
+ * @param       wb band of interest |s| (rad/s, <= 0.0: all modes)
+ * @param       hs output largest step meeting tol (0.0: no limit, -1.0:
+ *              not rated, mixed TR / BE)
+ * @param       wr output real part of pole s of modes [numC] (can be NULL)
+ * @param       wi output imaginary part of s of modes [numC] (can be NULL)
+ * @param       fl output OMADV_ flags of modes [numC] (can be NULL)
+ * @retval      return number of modes d, -1 if QR did not converge, the
+ *              circuit has BDF2 branches or allocation failed
+ * @note        eigenvalues z of W1 * C + W2 on rows with nonzero W1 / W2
+ *              are mapped back to poles s by the rule of L / C branches,
+ *              s = 2 / h * (z - 1) / (z + 1) (TR) or s = (1 - 1 / z) / h
+ *              (BE), BE static modes (z = 0) get s = -HUGE_VAL and are
+ *              not rated
+ * @note        a mode of a circuit mixing TR and BE L / C branches has no
+ *              single rule, wr / wi then hold z itself, only OMADV_UNS /
+ *              OMADV_OSC are flagged and hs is -1.0
+ * @note        error of a mode is |ln(z) / (s * h) - 1|, the drift of its
+ *              decay and frequency per unit of its own time, hs is the
+ *              step where it reaches tol for every mode in wb, error grows
+ *              as h^2 (TR) or h (BE), so hs = sqrt(12 tol) / |s| (TR) or
+ *              2 tol / |s| (BE)
+ * @note        modes out of wb are not limiting, under TR the real ones
+ *              ring (OMADV_OSC) once h > 2 / |s|
+ * @note        declared with LIBOHM_MATH only, it uses log() / atan2() of
+ *              <math.h> and needs libm (-lm)
+ */
+OmInt OmStepAdv(OmCir* cr, OmInt sw, OmFlt tol, OmFlt wb, OmFlt* hs,
+                OmFlt* wr, OmFlt* wi, OmInt* fl);
+#endif                                  /*| #ifdef LIBOHM_MATH              |*/
+
+/*===========================================================================*/
+#ifdef LIBOHM_C                         /*| define this in exactly one file |*/
+/*===========================================================================*/
+
+/*====================== Part 5. Function Implementation ====================*/
+
+#ifdef LIBOHM_BK                        /*| backend registered at compile   |*/
+extern OmBk LIBOHM_BK;                  /** Backend table defined by user    */
+static OmBk* omBk = &LIBOHM_BK;         /** Backend table, OmSetBk()         */
+#else
+static OmBk* omBk = NULL;               /** Backend table, OmSetBk()         */
+#endif
+/*========== OmDelete ================*//** Function [0]                     */
+void OmDelete(OmCir* cr) {
+    if (cr == NULL) return;             /* check if cr is null pointer       */
+    if (cr->numR > 0) {                 /* still shared, drop one reference  */
+        cr->numR -= 1;
+        return;
+    }
+    cr->numN    = 0;
+    cr->numB    = 0;
+    cr->numM    = 0;
+    cr->numX    = 0;
+    cr->numC    = 0;
+    cr->timStp  = 1.0;
+    OMFREE(cr->vecBn1 ); cr->vecBn1 = NULL;
+    OMFREE(cr->vecBn2 ); cr->vecBn2 = NULL;
+    OMFREE(cr->vecMn1 ); cr->vecMn1 = NULL;
+    OMFREE(cr->vecMn2 ); cr->vecMn2 = NULL;
+    OMFREE(cr->matPa  ); cr->matPa  = NULL;
+    OMFREE(cr->matPb  ); cr->matPb  = NULL;
+    OMFREE(cr->vecBtm ); cr->vecBtm = NULL;
+    OMFREE(cr->vecLut ); cr->vecLut = NULL;
+    OMFREE(cr->vecW1c ); cr->vecW1c = NULL;
+    OMFREE(cr->vecW2c ); cr->vecW2c = NULL;
+    OMFREE(cr->vecW1o ); cr->vecW1o = NULL;
+    OMFREE(cr->vecW2o ); cr->vecW2o = NULL;
+    OMFREE(cr->vecQa0 ); cr->vecQa0 = NULL;
+    OMFREE(cr->vecQs0 ); cr->vecQs0 = NULL;
+    OMFREE(cr->matC   ); cr->matC   = NULL;
+    OMFREE(cr->matD   ); cr->matD   = NULL;
+    OMFREE(cr->vecW1m ); cr->vecW1m = NULL;
+    OMFREE(cr->vecW2m ); cr->vecW2m = NULL;
+    OMFREE(cr->vecW1s ); cr->vecW1s = NULL;
+    OMFREE(cr->vecW2s ); cr->vecW2s = NULL;
+    OMFREE(cr->vecQa  ); cr->vecQa  = NULL;
+    OMFREE(cr->vecQs  ); cr->vecQs  = NULL;
+    OMFREE(cr->vecQtp ); cr->vecQtp = NULL;
+    OMFREE(cr->vecXm  ); cr->vecXm  = NULL;
+    OMFREE(cr->vecXc  ); cr->vecXc  = NULL;
+    cr->numK    = 0;
+    OMFREE(cr->vecKb  ); cr->vecKb  = NULL;
+    OMFREE(cr->vecCp  ); cr->vecCp  = NULL;
+    OMFREE(cr->vecCi  ); cr->vecCi  = NULL;
+    OMFREE(cr->vecCv  ); cr->vecCv  = NULL;
+    OMFREE(cr->vecDp  ); cr->vecDp  = NULL;
+    OMFREE(cr->vecDi  ); cr->vecDi  = NULL;
+    OMFREE(cr->vecDv  ); cr->vecDv  = NULL;
+    cr->numA    = 0;
+    OMFREE(cr->vecAb  ); cr->vecAb  = NULL;
+    OMFREE(cr->vecAt  ); cr->vecAt  = NULL;
+    OMFREE(cr->vecAs  ); cr->vecAs  = NULL;
+    OMFREE(cr->vecAe  ); cr->vecAe  = NULL;
+    OMFREE(cr->vecAg  ); cr->vecAg  = NULL;
+    OMFREE(cr->vecAv  ); cr->vecAv  = NULL;
+    OMFREE(cr->vecAi  ); cr->vecAi  = NULL;
+    cr->numP    = 0;
+    OMFREE(cr->matP   ); cr->matP   = NULL;
+    OMFREE(cr->vecPk  ); cr->vecPk  = NULL;
+    cr->numS    = 0;
+    cr->numU    = 0;
+    OMFREE(cr->vecSr  ); cr->vecSr  = NULL;
+    OMFREE(cr->vecSx  ); cr->vecSx  = NULL;
+    OMFREE(cr->matSc  ); cr->matSc  = NULL;
+    OMFREE(cr->matSd  ); cr->matSd  = NULL;
+    OMFREE(cr->vecBd  ); cr->vecBd  = NULL;
+    OMFREE(cr->vecW3b ); cr->vecW3b = NULL;
+    OMFREE(cr->vecW4b ); cr->vecW4b = NULL;
+    OMFREE(cr->vecW5b ); cr->vecW5b = NULL;
+    OMFREE(cr->vecQb0 ); cr->vecQb0 = NULL;
+    OMFREE(cr->vecW3m ); cr->vecW3m = NULL;
+    OMFREE(cr->vecW4m ); cr->vecW4m = NULL;
+    OMFREE(cr->vecW5m ); cr->vecW5m = NULL;
+    OMFREE(cr->vecQb  ); cr->vecQb  = NULL;
+    OMFREE(cr->vecTa  ); cr->vecTa  = NULL;
+    OMFREE(cr->vecTg  ); cr->vecTg  = NULL;
+    OMFREE(cr->vecTr  ); cr->vecTr  = NULL;
+    OMFREE(cr->vecTe  ); cr->vecTe  = NULL;
+    OMFREE(cr);                         /* free the struct itself            */
+}
+/*========== OmCreate ================*//** Function [1]                     */
+OmCir* OmCreate(OmInt n, OmInt b, OmInt m, OmFlt stp) {
+    OmInt  i, j;                        /* used in for-loop                  */
+    OmCir* cir;                         /* new circuit to be created         */
+    /*======== Step 0: Check parameter and Allocate struct ==================*/
+    if (n < 0 || b < 0 || m < 0 || stp <= 0.0) return NULL;
+    cir = (OmCir*)OMMALLOC(sizeof(OmCir));
+    /*======== Step 1: Initialize and Allocate memory for Group 1 & 2 =======*/
+    cir->numN   = n;
+    cir->numB   = b;
+    cir->numM   = m;
+    cir->numX   = 0;
+    cir->numC   = 0;
+    cir->timStp = stp;
+    cir->vecBn1 = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+    cir->vecBn2 = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+    cir->vecMn1 = (OmInt*)OMMALLOC(m * sizeof(OmInt));
+    cir->vecMn2 = (OmInt*)OMMALLOC(m * sizeof(OmInt));
+    cir->matPa  = (OmFlt*)OMMALLOC(b * b * sizeof(OmFlt));
+    cir->matPb  = (OmFlt*)OMMALLOC(b * b * sizeof(OmFlt));
+    cir->vecBtm = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+    cir->vecLut = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+    cir->vecW1c = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecW2c = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecW1o = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecW2o = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecQa0 = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecQs0 = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->matC   = NULL;                 /* Group 3 is allocated by OmStamp() */
+    cir->matD   = NULL;
+    cir->vecW1m = NULL;
+    cir->vecW2m = NULL;
+    cir->vecW1s = NULL;
+    cir->vecW2s = NULL;
+    cir->vecQa  = NULL;
+    cir->vecQs  = NULL;
+    cir->vecQtp = NULL;
+    cir->vecXm  = NULL;
+    cir->vecXc  = NULL;
+    cir->numK   = 0;
+    cir->vecKb  = NULL;
+    cir->vecCp  = NULL;
+    cir->vecCi  = NULL;
+    cir->vecCv  = NULL;
+    cir->vecDp  = NULL;
+    cir->vecDi  = NULL;
+    cir->vecDv  = NULL;
+    cir->numA   = 0;
+    cir->vecAb  = NULL;
+    cir->vecAt  = NULL;
+    cir->vecAs  = NULL;
+    cir->vecAe  = NULL;
+    cir->vecAg  = NULL;
+    cir->vecAv  = NULL;
+    cir->vecAi  = NULL;
+    cir->numR   = 0;                    /* owned by caller only              */
+    cir->numP   = 0;                    /* Group 7 is allocated by OmAdvance */
+    cir->matP   = NULL;
+    cir->vecPk  = NULL;
+    cir->numS   = 0;                    /* Group 8 is allocated by OmSsx()   */
+    cir->numU   = 0;
+    cir->vecSr  = NULL;
+    cir->vecSx  = NULL;
+    cir->matSc  = NULL;
+    cir->matSd  = NULL;
+    cir->vecBd  = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+    cir->vecW3b = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecW4b = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecW5b = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecQb0 = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecW3m = NULL;                 /* only if a branch uses BDF2 rule   */
+    cir->vecW4m = NULL;
+    cir->vecW5m = NULL;
+    cir->vecQb  = NULL;
+    cir->vecTa  = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+    cir->vecTg  = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecTr  = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    cir->vecTe  = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    /*======== Step 2: Initialize allocated struct pointer ==================*/
+    for (i=0; i < b; ++i) {
+        for (j=0; j < b; ++j) {
+            cir->matPa[i*b+j] = 0.0;    /* fill Pa with zeros                */
+            cir->matPb[i*b+j] = 0.0;    /* fill Pb with zeros                */
+        }
+        cir->vecBn1[i] = -1;            /* fill node1 of branch with GND(-1) */
+        cir->vecBn2[i] = -1;            /* fill node2 of branch with GND(-1) */
+        cir->vecBtm[i] = OMTYP_UN;      /* fill branch type with UN          */
+        cir->vecLut[i] = 1;             /* fill lookup table with Y-type     */
+        cir->vecW1c[i] = 0.0;           /* fill W1c with zeros               */
+        cir->vecW2c[i] = 0.0;           /* fill W2c with zeros               */
+        cir->vecW1o[i] = 0.0;           /* fill W1o with zeros               */
+        cir->vecW2o[i] = 0.0;           /* fill W2o with zeros               */
+        cir->vecQa0[i] = 0.0;           /* fill Qa0 with zeros               */
+        cir->vecQs0[i] = 0.0;           /* fill Qs0 with zeros               */
+        cir->vecBd [i] = 0;             /* fill BDF2 flag with zeros         */
+        cir->vecW3b[i] = 0.0;           /* fill W3b with zeros               */
+        cir->vecW4b[i] = 0.0;           /* fill W4b with zeros               */
+        cir->vecW5b[i] = 0.0;           /* fill W5b with zeros               */
+        cir->vecQb0[i] = 0.0;           /* fill Qb0 with zeros               */
+        cir->vecTa [i] = 0;             /* fill tuning flag with zeros       */
+        cir->vecTg [i] = 0.0;           /* fill switch conductance with zeros*/
+        cir->vecTr [i] = 0.0;           /* fill on-resistance with zeros     */
+        cir->vecTe [i] = 0.0;           /* fill expected error with zeros    */
+    }
+    for (i=0; i < m; ++i) {
+        cir->vecMn1[i] = -1;            /* fill node1 of meter with GND(-1)  */
+        cir->vecMn2[i] = -1;            /* fill node2 of meter with GND(-1)  */
+    }
+    return cir;
+}
+/*========== OmSqrt ==================*//** Helper of Function [2]           */
+static OmFlt OmSqrt(OmFlt x) {
+    OmFlt r, k;                         /* root of scaled x, scale of root   */
+    OmInt i;                            /* used in for-loop                  */
+    if (!(x > 0.0) || x - x != 0.0) {   /* zero, negative, inf and NaN       */
+        return (x < 0.0) ? (x - x) / (x - x) : x;
+    }
+    k = 1.0;                            /* x = 4^n x', scaling is exact      */
+    while (x > 16777216.0) { x /= 281474976710656.0; k *= 16777216.0; }
+    while (x < 1.0 / 16777216.0) { x *= 281474976710656.0; k /= 16777216.0; }
+    while (x > 4.0)  { x *= 0.25; k *= 2.0; }
+    while (x < 0.25) { x *= 4.0;  k *= 0.5; }
+    r = 0.5 * (1.0 + x);                /* within 25 % for x' in [1/4, 4]    */
+    for (i=0; i < 6; ++i) r = 0.5 * (r + x / r);
+    return r * k;
+}
+/*========== OmStmMap ================*//** Helper of Function [2]           */
+static OmInt OmStmMap(OmCir* cr, OmInt* lut, OmInt i, OmInt j,
+                      OmInt* tp, OmFlt* ts) {
+    OmInt n, x, nz;                     /* numN, numX, number of targets     */
+    OmInt ri, ci, nr, nc;               /* used in for-loop, list lengths    */
+    OmInt rn[2], cn[2];                 /* rows / columns of Pn touched      */
+    OmFlt rs[2], cs[2];                 /* signs of rows / columns           */
+    n = cr->numN;
+    x = cr->numX;
+    if (lut[i] > 0) {                   /* Branch i is Y-type: KCL rows      */
+        rn[0] = cr->vecBn1[i]; rs[0] =  1.0;
+        rn[1] = cr->vecBn2[i]; rs[1] = -1.0;
+        nr = 2;
+    } else {                            /* Branch i is X-type: its own row   */
+        rn[0] = n - lut[i];    rs[0] = -1.0;
+        nr = 1;
+    }
+    if (lut[j] > 0) {                   /* Branch j is Y-type: node voltages */
+        cn[0] = cr->vecBn1[j]; cs[0] =  1.0;
+        cn[1] = cr->vecBn2[j]; cs[1] = -1.0;
+        nc = 2;
+    } else {                            /* Branch j is X-type: its current   */
+        cn[0] = n - lut[j];    cs[0] =  1.0;
+        nc = 1;
+    }
+    nz = 0;
+    for (ri=0; ri < nr; ++ri) {
+        if (rn[ri] < 0) continue;       /* GND                               */
+        for (ci=0; ci < nc; ++ci) {
+            if (cn[ci] < 0) continue;   /* GND                               */
+            tp[nz] = rn[ri] * (n+x) + cn[ci];
+            ts[nz] = rs[ri] * cs[ci];
+            nz += 1;
+        }
+    }
+    return nz;
+}
+/*========== OmStmPn0 ================*//** Helper of Function [2]           */
+static void OmStmPn0(OmCir* cr, OmInt* lut, OmFlt* pn) {
+    OmInt n, b, x;                      /* numN, numB, numX                  */
+    OmInt i, ilut, n1, n2;              /* used in for-loop, lut, nodes      */
+    n = cr->numN;
+    b = cr->numB;
+    x = cr->numX;
+    for (i=0; i < (n+x) * (n+x); ++i) pn[i] = 0.0;
+    for (i=0; i < b; ++i) {             /* incidence of X-type branches      */
+        ilut = lut[i];
+        if (ilut > 0) continue;
+        n1 = cr->vecBn1[i];
+        n2 = cr->vecBn2[i];
+        if (n1 >= 0) pn[n1*(n+x)+(n-ilut)] += 1.0;
+        if (n1 >= 0) pn[(n-ilut)*(n+x)+n1] += 1.0;
+        if (n2 >= 0) pn[n2*(n+x)+(n-ilut)] -= 1.0;
+        if (n2 >= 0) pn[(n-ilut)*(n+x)+n2] -= 1.0;
+    }
+}
+/*========== OmStmPn =================*//** Helper of Function [2]           */
+static void OmStmPn(OmCir* cr, OmInt* lut, OmFlt* pn) {
+    OmInt b;                            /* numB                              */
+    OmInt i, j, t, nz;                  /* used in for-loop, target count    */
+    OmInt tp[4];                        /* target index in Pn                */
+    OmFlt ts[4];                        /* target sign in Pn                 */
+    OmFlt k;                            /* used as factor / coefficient      */
+    b = cr->numB;
+    OmStmPn0(cr, lut, pn);
+    for (i=0; i < b; ++i) {
+        for (j=0; j < b; ++j) {
+            k = cr->matPb[i*b+j];
+            if (k == 0.0) continue;
+            nz = OmStmMap(cr, lut, i, j, tp, ts);
+            for (t=0; t < nz; ++t) pn[tp[t]] += ts[t] * k;
+        }
+    }
+}
+/*========== OmStmTp =================*//** Helper of Function [2]           */
+static void OmStmTp(OmCir* cr, OmInt* lut, OmFlt* ws) {
+    OmInt n, b, m, x;                   /* numN, numB, numM, numX            */
+    OmInt i, j;                         /* used in for-loop                  */
+    OmInt ilut, jlut, n1, n2;           /* lookup table value, nodes         */
+    OmFlt* matPn;                       /* Pn^-1                   [n+x,n+x] */
+    OmFlt* matPtp;                      /* Ptp = (Pn^-1)(Tn)       [n+x,b]   */
+    OmFlt* matTtp;                      /* Ttp = (Tb)(Ptp)         [b,b]     */
+    OmFlt* matRtp;                      /* Rtp = (Pb)(Ttp) + I     [b,b]     */
+    OmFlt* matCtp;                      /* Ctp = (Pa)(Ttp)         [b,b]     */
+    OmFlt* matDtp;                      /* Dtp = (K)(Ptp,Rtp)      [m,b]     */
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    x = cr->numX;
+    matPn  = ws;                        /* slice scratch, see OmStampSz()    */
+    matPtp = matPn  + 2 * (n+x) * (n+x) + (n+x);
+    matTtp = matPtp + (n+x) * b;
+    matRtp = matTtp + b * b;
+    matCtp = matRtp + b * b;
+    matDtp = matCtp + b * b;
+    /*======== Step 1: Calculate Ptp = (Pn^-1)(Tn) ==========================*/
+    for (i=0; i < (n+x) * b; ++i) matPtp[i] = 0.0;
+    for (i=0; i < n+x; ++i) {
+        for (j=0; j < b; ++j) {
+            jlut = lut[j];              /* 0...-x is X-type, 1 is Y-type     */
+            n1 = cr->vecBn1[j];         /* 0-based index                     */
+            n2 = cr->vecBn2[j];         /* 0-based index                     */
+            if (jlut > 0) {             /* Y-type branch                     */
+                if (n1 >= 0) matPtp[i*b+j] -= matPn[i*(n+x)+n1];
+                if (n2 >= 0) matPtp[i*b+j] += matPn[i*(n+x)+n2];
+            } else {                    /* X-type branch                     */
+                matPtp[i*b+j] += matPn[i*(n+x)+(n-jlut)];
+            }
+        }
+    }
+    /*======== Step 2: Calculate Ttp, Rtp, Ctp, Dtp =========================*/
+    for (i=0; i < b * b; ++i) matTtp[i] = 0.0;
+    for (i=0; i < m * b; ++i) matDtp[i] = 0.0;
+    for (i=0; i < b; ++i) {
+        ilut = lut[i];
+        if (ilut > 0) {                 /* Y-type branch                     */
+            n1 = cr->vecBn1[i];         /* 0-based index                     */
+            n2 = cr->vecBn2[i];         /* 0-based index                     */
+            if (n1 >= 0) for (j=0; j < b; ++j) {
+                matTtp[i*b+j] += matPtp[n1*b+j];
+            }
+            if (n2 >= 0) for (j=0; j < b; ++j) {
+                matTtp[i*b+j] -= matPtp[n2*b+j];
+            }
+        } else {                        /* X-type branch                     */
+            for (j=0; j < b; ++j) {
+                matTtp[i*b+j] += matPtp[(n-ilut)*b+j];
+            }
+        }
+    }
+    OmMatMul(b, matCtp, cr->matPa, matTtp);
+    OmMatMul(b, matRtp, cr->matPb, matTtp);
+    for (i=0; i < b; ++i) matRtp[i*b+i] += 1.0;
+    for (i=0; i < m; ++i) {             /* calculate Dtp = (K)(Ptp,Rtp)      */
+        n1 = cr->vecMn1[i];             /* 0-based index                     */
+        n2 = cr->vecMn2[i];             /* 0-based index                     */
+        if (n2 < -1) {                  /* ammeter                           */
+            ilut = lut[n1];             /* use Rtp if Y-type, Ptp if X-type  */
+            if (ilut > 0) for (j=0; j < b; ++j) {
+                matDtp[i*b+j] += matRtp[n1*b+j];
+            } 
+            else for (j=0; j < b; ++j) {
+                matDtp[i*b+j] += matPtp[(n-ilut)*b+j];
+            }
+        } else {                        /* voltmeter                         */
+            if (n1 >= 0) for (j=0; j < b; ++j) {
+                matDtp[i*b+j] += matPtp[n1*b+j];
+            }
+            if (n2 >= 0) for (j=0; j < b; ++j) {
+                matDtp[i*b+j] -= matPtp[n2*b+j];
+            }
+        }
+    }
+}
+/*========== OmStmCut ================*//** Helper of Function [2]           */
+static void OmStmCut(OmCir* cr, OmFlt* ws) {
+    OmInt n, b, m, x, c;                /* numN, numB, numM, numX, numC      */
+    OmInt i, j, ilut, jlut;             /* used in for-loop, lookup value    */
+    OmFlt* matCtp;                      /* Ctp = (Pa)(Ttp)         [b,b]     */
+    OmFlt* matDtp;                      /* Dtp = (K)(Ptp,Rtp)      [m,b]     */
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    x = cr->numX;
+    c = cr->numC;
+    matCtp = ws + 2 * (n+x) * (n+x) + (n+x) + (n+x) * b + 2 * b * b;
+    matDtp = matCtp + b * b;
+    cr->numP = 0;                       /* cached powers of G are stale      */
+    for (j=0; j < b; ++j) {             /* build D matrix                    */
+        jlut = cr->vecLut[j];
+        if (jlut < 0) continue;         /* cut branch                        */
+        for (i=0; i < m; ++i) cr->matD[i*c+jlut] = matDtp[i*b+j];
+    }
+    for (i=0; i < b; ++i) {             /* build C matrix                    */
+        ilut = cr->vecLut[i];
+        if (ilut < 0) continue;         /* cut branch                        */
+        for (j=0; j < b; ++j) {
+            jlut = cr->vecLut[j];
+            if (jlut < 0) continue;     /* cut branch                        */
+            cr->matC[ilut*c+jlut] = matCtp[i*b+j];
+        }
+    }
+}
+/*========== OmAddSw =================*//** Helper of Function [30]          */
+static void OmAddSw(OmCir* cr, OmInt i, OmFlt k1, OmFlt k2, OmFlt ysw,
+                    OmFlt ron) {
+    OmFlt tmp;                          /* temporary value                   */
+    tmp = 1.0 + ysw * ron;
+    cr->vecW1c[i] = (k1 + 1.0) * ysw / (tmp * tmp);
+    cr->vecW2c[i] = (1.0 - k1 * ysw * ron) / tmp;
+    cr->vecW1o[i] = (k2 - 1.0) * ysw / (tmp * tmp);
+    cr->vecW2o[i] = (k2 + ysw * ron) / tmp;
+    cr->vecTg[i] = ysw;
+    cr->vecTr[i] = ron;
+}
+/*========== OmStmSw =================*//** Helper of Function [2]           */
+static OmInt OmStmSw(OmCir* cr, OmFlt* ws, OmInt tn) {
+    OmInt n, b, m, x;                   /* numN, numB, numM, numX            */
+    OmInt i, j, k, l, s, it, chg;       /* used in for-loop, tuned count     */
+    OmFlt *matTtp, *tt, *mi;            /* Ttp, ports [s,s], (I - T dG)^-1   */
+    OmFlt *gv, *g0, *rv;                /* ysw, own conductance, ron   [s]   */
+    OmFlt ge, z, ga, gb, gc, dm;        /* conductances, port Z, max change  */
+    OmFlt e1, e2;                       /* error ratio when closed / open    */
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    x = cr->numX;
+    matTtp = ws + 2 * (n+x) * (n+x) + (n+x) + (n+x) * b;
+    /*======== Step 1: Port impedances of tuned switches ====================*/
+    s = 0;
+    for (i=0; i < b; ++i) {
+        s += tn && cr->vecTa[i] && OMABS(cr->vecBtm[i]) == OMTYP_SW;
+    }
+    gv = matTtp + 3 * b * b + m * b;    /* tail of scratch, see OmStampSz()  */
+    g0 = gv + s;
+    rv = g0 + s;
+    tt = rv + s;
+    mi = tt + s * s;
+    k = 0;
+    for (i=0; i < b && s > 0; ++i) {
+        if (!cr->vecTa[i] || OMABS(cr->vecBtm[i]) != OMTYP_SW) continue;
+        gv[k] = cr->vecTg[i];
+        rv[k] = cr->vecTr[i];
+        g0[k] = gv[k] / (1.0 + gv[k] * rv[k]);
+        l = 0;
+        for (j=0; j < b; ++j) {         /* transfer impedance between ports  */
+            if (!cr->vecTa[j] || OMABS(cr->vecBtm[j]) != OMTYP_SW) continue;
+            tt[k*s+l] = matTtp[i*b+j];
+            l += 1;
+        }
+        k += 1;
+    }
+    /*======== Step 2: Iterate ysw of equal error on ports ==================*/
+    for (it=0; it < 200 && s > 0; ++it) {
+        for (k=0; k < s; ++k) {         /* ports with ysw changed by dG      */
+            for (l=0; l < s; ++l) {
+                ge = gv[l] / (1.0 + gv[l] * rv[l]) - g0[l];
+                mi[k*s+l] = (k == l ? 1.0 : 0.0) - tt[k*s+l] * ge;
+            }
+        }
+        OmMatInvWs(s, mi, mi + s * s);
+        dm = 0.0;
+        for (k=0; k < s; ++k) {
+            z = 0.0;
+            for (l=0; l < s; ++l) z += mi[k*s+l] * tt[l*s+k];
+            z = OMABS(z);               /* port impedance, switch included   */
+            ge = gv[k] / (1.0 + gv[k] * rv[k]);
+            if (z <= 0.0 || 1.0 / z <= ge) continue;
+            ga = 1.0 / z - ge;          /* Norton conductance of network     */
+            gb = 2.0 + rv[k] * ga;      /* equal error when closed and open  */
+            gc = 8.0 * rv[k] * (1.0 + rv[k] * ga) * ga;
+            gc = 2.0 * ga / (gb + OmSqrt(gb * gb + gc));
+            if (OMABS(gc - gv[k]) > dm * gv[k]) dm = OMABS(gc - gv[k]) / gv[k];
+            gv[k] = gc;
+        }
+        if (dm <= 1e-9) break;
+    }
+    /*======== Step 3: Put tuned ysw to Pb, rate error of switches ==========*/
+    chg = 0;
+    k = 0;
+    for (i=0; i < b; ++i) {
+        if (OMABS(cr->vecBtm[i]) != OMTYP_SW) continue;
+        if (s > 0 && cr->vecTa[i]) {
+            if (OMABS(gv[k] - cr->vecTg[i]) > 1e-6 * cr->vecTg[i]) {
+                ge = gv[k] / (1.0 + gv[k] * rv[k]) - g0[k];
+                cr->matPb[i*b+i] += ge; /* replace own conductance           */
+                for (j=0; j < cr->numA; ++j) {
+                    if (cr->vecAb[j] == i) cr->vecAg[j] += ge;
+                }
+                OmAddSw(cr, i, 1.0, 0.0, gv[k], rv[k]);
+                chg += 1;
+            }
+            k += 1;
+        }
+        z = OMABS(matTtp[i*b+i]);
+        e1 = cr->vecW2c[i] - cr->vecW1c[i] * z;
+        e2 = cr->vecW2o[i] - cr->vecW1o[i] * z;
+        cr->vecTe[i] = OMABS(e1) > OMABS(e2) ? OMABS(e1) : OMABS(e2);
+    }
+    return chg;
+}
+/*========== OmStmAg =================*//** Helper of Function [2]           */
+static void OmStmAg(OmCir* cr) {
+    OmInt b;                            /* numB                              */
+    OmInt i, br;                        /* used in for-loop, switch branch   */
+    b = cr->numB;
+    for (i=0; i < cr->numA; ++i) {      /* own conductance of auto switches  */
+        br = cr->vecAb[i];
+        cr->vecAg[i] = cr->matPb[br*b+br];
+    }
+}
+/*========== OmStmRun ================*//** Helper of Function [2]           */
+static void OmStmRun(OmCir* cr, OmFlt* ws, OmInt keep) {
+    OmInt n, b, m, x, c;                /* numN, numB, numM, numX, numC      */
+    OmInt i;                            /* used in for-loop                  */
+    OmInt btyp;                         /* branch type                       */
+    /*======== Step 0: Get Number of nodes and branches =====================*/
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    x = cr->numX;
+    /*======== Step 1: Stamp Pb to Pn and invert ============================*/
+    OmStmAg(cr);                        /* after all OmAddY() / OmAddS()     */
+    OmStmPn(cr, cr->vecLut, ws);
+    OmMatInvWs(n+x, ws, ws + (n+x) * (n+x));
+    /*======== Step 2: Calculate Ttp, Rtp, Ctp, Dtp =========================*/
+    OmStmTp(cr, cr->vecLut, ws);
+    for (i=0; i < 8 && OmStmSw(cr, ws, 1); ++i) {
+        OmStmPn(cr, cr->vecLut, ws);    /* stamp again with tuned switches   */
+        OmMatInvWs(n+x, ws, ws + (n+x) * (n+x));
+        OmStmTp(cr, cr->vecLut, ws);
+    }
+    if (i == 8) OmStmSw(cr, ws, 0);
+    if (!keep) {                        /* setup is not needed anymore       */
+        OMFREE(cr->vecBn1); cr->vecBn1 = NULL;
+        OMFREE(cr->vecBn2); cr->vecBn2 = NULL;
+        OMFREE(cr->vecMn1); cr->vecMn1 = NULL;
+        OMFREE(cr->vecMn2); cr->vecMn2 = NULL;
+        OMFREE(cr->matPa ); cr->matPa  = NULL;
+        OMFREE(cr->matPb ); cr->matPb  = NULL;
+    }
+    /*======== Step 3: Count the number of kept branches ====================*/
+    c = 0;
+    for (i=0; i < b; ++i) {             /* detect X0 and Y0 branches         */
+        btyp = OMABS(cr->vecBtm[i]);
+        if (btyp == OMTYP_X0 || btyp == OMTYP_Y0) {
+            cr->vecLut[i] = -1;         /* mark as cut branch                */
+        } else {
+            cr->vecLut[i] = c;          /* mark as kept branch               */
+            c += 1;
+        }
+    }
+    cr->numC   = c;                     /* set numC                          */
+    /*======== Step 4: Simplify Ctp and Dtp (matrix cutting) ================*/
+    cr->matC   = (OmFlt*)OMMALLOC(c * c * sizeof(OmFlt));
+    cr->matD   = (OmFlt*)OMMALLOC(m * c * sizeof(OmFlt));
+    OmStmCut(cr, ws);
+    /*======== Step 5: Allocate memory for runtime vectors ==================*/
+    cr->vecW1m = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    cr->vecW2m = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    cr->vecW1s = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    cr->vecW2s = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    cr->vecQa  = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    cr->vecQs  = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    cr->vecQtp = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    cr->vecXm  = (OmFlt*)OMMALLOC(m * sizeof(OmFlt));
+    cr->vecXc  = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    for (i=0; i < b; ++i) {             /* second history only for BDF2      */
+        if (cr->vecLut[i] >= 0 && cr->vecBd[i]) break;
+    }
+    if (i < b) {
+        cr->vecW3m = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+        cr->vecW4m = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+        cr->vecW5m = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+        cr->vecQb  = (OmFlt*)OMMALLOC(c * sizeof(OmFlt));
+    }
+    OmReset(cr);                        /* reset circuit to initial state    */
+}
+/*========== OmStamp =================*//** Function [2]                     */
+void OmStamp(OmCir* cr) {
+    OmStampWs(cr, NULL);
+}
+/*========== OmStampWs ===============*//** Function [54]                    */
+void OmStampWs(OmCir* cr, OmFlt* ws) {
+    if (ws != NULL) {
+        OmStmRun(cr, ws, 0);
+        return;
+    }
+    ws = (OmFlt*)OMMALLOC(OmStampSz(cr) * sizeof(OmFlt));
+    OmStmRun(cr, ws, 0);
+    OMFREE(ws);
+}
+/*========== OmReset =================*//** Function [3]                     */
+void OmReset(OmCir* cr) {
+    OmInt b, c;                         /* numB, numC                        */
+    OmInt i;                            /* used in for-loop                  */
+    OmInt btyp, ilut;                   /* branch type and lut value         */
+    b = cr->numB;
+    c = cr->numC;
+    for (i=0; i < b; ++i) {
+        ilut = cr->vecLut[i];
+        btyp = OMABS(cr->vecBtm[i]);
+        if (ilut < 0) continue;         /* cut branch                        */
+        cr->vecW1m[ilut] = cr->vecW1o[i];
+        cr->vecW2m[ilut] = cr->vecW2o[i];
+        cr->vecQa[ilut] = cr->vecQa0[i];
+        cr->vecQs[ilut] = cr->vecQs0[i];
+        if (cr->vecQb != NULL) {        /* BDF2 weights and second history   */
+            cr->vecW3m[ilut] = cr->vecW3b[i];
+            cr->vecW4m[ilut] = cr->vecW4b[i];
+            cr->vecW5m[ilut] = cr->vecW5b[i];
+            cr->vecQb [ilut] = cr->vecQb0[i];
+        }
+        if (btyp == OMTYP_SW) {         /* always reset switch to open state */
+            cr->vecW1s[ilut] = cr->vecW1o[i];
+            cr->vecW2s[ilut] = cr->vecW2o[i];
+        } else {
+            cr->vecW1s[ilut] = 0.0;
+            cr->vecW2s[ilut] = 1.0;     /* keep other branch Qa unchanged    */
+        }
+    }
+    for (i=0; i < cr->numA; ++i) {      /* auto switches are open as well    */
+        cr->vecAs[i] = 0;
+    }
+    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
+}
+/*========== OmBdfFma ================*//** Helper of Function [5]           */
+static void OmBdfFma(OmCir* cr, OmInt i) {
+    OmFlt qb;                           /* Qb of row i before the update     */
+    qb = cr->vecQb[i];                  /* OmVecFma() with second history    */
+    cr->vecQb[i] = cr->vecW4m[i] * cr->vecXc[i] + cr->vecW5m[i] * cr->vecQa[i];
+    cr->vecQa[i] = cr->vecW1m[i] * cr->vecXc[i] + cr->vecW2m[i] * cr->vecQa[i]
+                 + cr->vecW3m[i] * qb;
+}
+/*========== OmSsxUpd ================*//** Helper of Function [110]         */
+static void OmSsxUpd(OmCir* cr, OmFlt* w1, OmFlt* w2, OmInt bd) {
+    OmInt d, k;                         /* numS, numU                        */
+    OmInt i, j, r;                      /* used in for-loop, row             */
+    OmFlt sum;                          /* used to store summation value     */
+    d = cr->numS;
+    k = cr->numU;
+    for (j=0; j < k; ++j) {             /* Qtp of state / input columns      */
+        r = cr->vecSr[j];
+        cr->vecQtp[r] = cr->vecQa[r] + cr->vecQs[r];
+    }
+    for (i=0; i < d; ++i) {             /* same order as OmVecMul()          */
+        sum = 0.0;
+        for (j=0; j < k; ++j) {
+            sum += cr->matSc[i*k+j] * cr->vecQtp[cr->vecSr[j]];
+        }
+        cr->vecXc[cr->vecSr[cr->vecSx[i]]] = sum;
+    }
+    for (i=0; i < d; ++i) {             /* same as OmVecFma() on states      */
+        r = cr->vecSr[cr->vecSx[i]];
+        if (bd && cr->vecQb != NULL) {  /* BDF2 branches, second history     */
+            OmBdfFma(cr, r);
+        } else {
+            cr->vecQa[r] = w1[r] * cr->vecXc[r] + w2[r] * cr->vecQa[r];
+        }
+    }
+}
+/*========== OmSsxMt =================*//** Helper of Function [110]         */
+static void OmSsxMt(OmCir* cr) {
+    OmInt m, k;                         /* numM, numU                        */
+    OmInt i, j;                         /* used in for-loop                  */
+    OmFlt sum;                          /* used to store summation value     */
+    m = cr->numM;
+    k = cr->numU;
+    for (i=0; i < m; ++i) {
+        sum = 0.0;
+        for (j=0; j < k; ++j) {
+            sum += cr->matSd[i*k+j] * cr->vecQtp[cr->vecSr[j]];
+        }
+        cr->vecXm[i] = sum;
+    }
+}
+/*========== OmUpdSw =================*//** Function [4]                     */
+void OmUpdSw(OmCir* cr) {
+    OmInt c;                            /* numC                              */
+    c = cr->numC;
+    if (cr->vecSr != NULL) {            /* state-space runtime form          */
+        OmSsxUpd(cr, cr->vecW1s, cr->vecW2s, 0);
+        return;
+    }
+    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
+    if (cr->vecCp != NULL) {            /* sparse runtime form               */
+        OmSpmMul(c, cr->vecXc, cr->vecCp, cr->vecCi, cr->vecCv, cr->vecQtp);
+    } else {
+        OmVecMul(c, c, cr->vecXc, cr->matC, cr->vecQtp);
+    }
+    OmVecFma(c, cr->vecQa, cr->vecW1s, cr->vecXc, cr->vecW2s);
+}
+/*========== OmUpdCr =================*//** Function [5]                     */
+void OmUpdCr(OmCir* cr) {
+    OmInt c, i;                         /* numC, used in for-loop            */
+    c = cr->numC;
+    if (cr->vecSr != NULL) {            /* state-space runtime form          */
+        OmSsxUpd(cr, cr->vecW1m, cr->vecW2m, 1);
+        return;
+    }
+    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
+    if (cr->vecCp != NULL) {            /* sparse runtime form               */
+        OmSpmMul(c, cr->vecXc, cr->vecCp, cr->vecCi, cr->vecCv, cr->vecQtp);
+    } else {
+        OmVecMul(c, c, cr->vecXc, cr->matC, cr->vecQtp);
+    }
+    if (cr->vecQb != NULL) {            /* BDF2 branches, second history     */
+        for (i=0; i < c; ++i) OmBdfFma(cr, i);
+    } else {
+        OmVecFma(c, cr->vecQa, cr->vecW1m, cr->vecXc, cr->vecW2m);
+    }
+}
+/*========== OmUpdMt =================*//** Function [6]                     */
+void OmUpdMt(OmCir* cr) {
+    OmInt m, c;                         /* numM, numC                        */
+    m = cr->numM;
+    c = cr->numC;
+    if (cr->vecSr != NULL) {            /* state-space runtime form          */
+        OmSsxMt(cr);
+    } else if (cr->vecDp != NULL) {     /* sparse runtime form               */
+        OmSpmMul(m, cr->vecXm, cr->vecDp, cr->vecDi, cr->vecDv, cr->vecQtp);
+    } else {
+        OmVecMul(m, c, cr->vecXm, cr->matD, cr->vecQtp);
+    }
+}
+/*========== OmGetMt =================*//** Function [7]                     */
+OmFlt OmGetMt(OmCir* cr, OmInt mt) {
+    return cr->vecXm[mt-1];
+}
+/*========== OmGetXc =================*//** Function [8]                     */
+OmFlt OmGetXc(OmCir* cr, OmInt br) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = cr->vecLut[br-1];
+    if (ilut < 0) return 0.0;           /* cut branch                        */
+    return cr->vecXc[ilut];
+}
+/*========== OmSetQs =================*//** Function [9]                     */
+void OmSetQs(OmCir* cr, OmInt br, OmFlt x) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = cr->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    cr->vecQs[ilut] = x;
+}
+/*========== OmSetSw =================*//** Function [10]                    */
+void OmSetSw(OmCir* cr, OmInt br, OmInt s) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = cr->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    cr->vecW1m[ilut] = (s == 0) ? cr->vecW1o[br-1] : cr->vecW1c[br-1];
+    cr->vecW2m[ilut] = (s == 0) ? cr->vecW2o[br-1] : cr->vecW2c[br-1];
+    cr->vecW1s[ilut] = cr->vecW1m[ilut];
+    cr->vecW2s[ilut] = cr->vecW2m[ilut];
+}
+/*========== OmBran ==================*//** Function [11]                    */
+void OmBran(OmCir* cr, OmInt br, OmInt n1, OmInt n2, OmInt tm) {
+    OmInt b;                            /* numB                              */
+    OmInt btyp;                         /* branch type                       */
+    OmInt bd;                           /* branch uses BDF2 rule             */
+    b = cr->numB;
+    bd = tm >= OMMTD_BD2;               /* rule flag, only on positive tm    */
+    btyp = bd ? tm - OMMTD_BD2 : OMABS(tm);
+    if (btyp > OMTYP_SW || tm <= -OMMTD_BD2) return;
+    cr->vecBd[br-1] = bd;
+    cr->vecBn1[br-1] = n1 - 1;
+    cr->vecBn2[br-1] = n2 - 1;
+    cr->vecBtm[br-1] = bd ? btyp : tm;
+    if (btyp >= OMTYP_Y0) {             /* Y/SW-type branch                  */
+        cr->vecLut[br-1] = 1;
+    } else {
+        cr->vecLut[br-1] = -cr->numX;
+        cr->numX += 1;
+    }
+    if (btyp != OMTYP_X3 && btyp != OMTYP_Y3) {
+        cr->matPa[(br-1)*b+(br-1)] = 1.0;
+    }                                   /* Xc is branch current or voltage   */
+}
+/*========== OmMetV ==================*//** Function [12]                    */
+void OmMetV(OmCir* cr, OmInt mt, OmInt n1, OmInt n2) {
+    cr->vecMn1[mt-1] = n1 - 1;
+    cr->vecMn2[mt-1] = n2 - 1;
+}
+/*========== OmMetA ==================*//** Function [13]                    */
+void OmMetA(OmCir* cr, OmInt mt, OmInt br) {
+    cr->vecMn1[mt-1] = br - 1;
+    cr->vecMn2[mt-1] = -2;
+}
+/*========== OmAddX ==================*//** Function [14]                    */
+void OmAddX(OmCir* cr, OmInt bx, OmFlt res) {
+    OmInt b;                            /* numB                              */
+    b = cr->numB;
+    cr->matPb[(bx-1)*b+(bx-1)] += res;
+}
+/*========== OmAddY ==================*//** Function [15]                    */
+void OmAddY(OmCir* cr, OmInt by, OmFlt con) {
+    OmInt b;                            /* numB                              */
+    b = cr->numB;
+    cr->matPb[(by-1)*b+(by-1)] += con;
+}
+/*========== OmAddV ==================*//** Function [16]                    */
+void OmAddV(OmCir* cr, OmInt bx, OmFlt vol) {
+    cr->vecQs0[bx-1] += vol;
+}
+/*========== OmAddI ==================*//** Function [17]                    */
+void OmAddI(OmCir* cr, OmInt by, OmFlt cur) {
+    cr->vecQs0[by-1] += cur;
+}
+/*========== OmAddL ==================*//** Function [18]                    */
+void OmAddL(OmCir* cr, OmInt bx, OmFlt ind, OmFlt i0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[bx-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[bx-1]) {              /* BDF2 rule                         */
+        cr->matPb[(bx-1)*b+(bx-1)] += (1.5 * ind) / stp;
+        cr->vecQa0[bx-1] -= (1.5 * ind * i0) / stp;
+        cr->vecW2o[bx-1] = 0.0;
+        cr->vecW4b[bx-1] = 1.0;
+        if (btm == OMTYP_X3) {          /* Level 3 branch                    */
+            cr->matPa[(bx-1)*b+(bx-1)] += ind;
+            cr->vecW1o[bx-1] = -2.0 / stp;
+            cr->vecW3b[bx-1] = 0.5 / stp;
+            cr->vecQb0[bx-1] += ind * i0;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[bx-1] += (-2.0 * ind) / stp;
+            cr->vecW3b[bx-1] += (0.5 * ind) / stp;
+            cr->vecQb0[bx-1] = i0;
+        }
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPb[(bx-1)*b+(bx-1)] += ind / stp;
+        cr->vecQa0[bx-1] -= (ind * i0) / stp;
+        cr->vecW2o[bx-1] = 0.0;
+        if (btm == -OMTYP_X3) {         /* Level 3 branch                    */
+            cr->matPa[(bx-1)*b+(bx-1)] += ind;
+            cr->vecW1o[bx-1] = -1.0 / stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[bx-1] += (-1.0 * ind) / stp;
+        }
+    } else {                            /* trapezoidal rule                  */
+        cr->matPb[(bx-1)*b+(bx-1)] += (2.0 * ind) / stp;
+        cr->vecQa0[bx-1] -= (2.0 * ind * i0) / stp;
+        cr->vecW2o[bx-1] = -1.0;
+        if (btm == OMTYP_X3) {          /* Level 3 branch                    */
+            cr->matPa[(bx-1)*b+(bx-1)] += ind;
+            cr->vecW1o[bx-1] = -4.0 / stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[bx-1] += (-4.0 * ind) / stp;
+        }
+    }
+}
+/*========== OmAddC ==================*//** Function [19]                    */
+void OmAddC(OmCir* cr, OmInt by, OmFlt cap, OmFlt v0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[by-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[by-1]) {              /* BDF2 rule                         */
+        cr->matPb[(by-1)*b+(by-1)] += (1.5 * cap) / stp;
+        cr->vecQa0[by-1] -= (1.5 * cap * v0) / stp;
+        cr->vecW2o[by-1] = 0.0;
+        cr->vecW4b[by-1] = 1.0;
+        if (btm == OMTYP_Y3) {          /* Level 3 branch                    */
+            cr->matPa[(by-1)*b+(by-1)] += cap;
+            cr->vecW1o[by-1] = -2.0 / stp;
+            cr->vecW3b[by-1] = 0.5 / stp;
+            cr->vecQb0[by-1] += cap * v0;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[by-1] += (-2.0 * cap) / stp;
+            cr->vecW3b[by-1] += (0.5 * cap) / stp;
+            cr->vecQb0[by-1] = v0;
+        }
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPb[(by-1)*b+(by-1)] += cap / stp;
+        cr->vecQa0[by-1] -= (cap * v0) / stp;
+        cr->vecW2o[by-1] = 0.0;
+        if (btm == -OMTYP_Y3) {         /* Level 3 branch                    */
+            cr->matPa[(by-1)*b+(by-1)] += cap;
+            cr->vecW1o[by-1] = -1.0 / stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[by-1] += (-1.0 * cap) / stp;
+        }
+    } else {                            /* trapezoidal rule                  */
+        cr->matPb[(by-1)*b+(by-1)] += (2.0 * cap) / stp;
+        cr->vecQa0[by-1] -= (2.0 * cap * v0) / stp;
+        cr->vecW2o[by-1] = -1.0;
+        if (btm == OMTYP_Y3)  {         /* Level 3 branch                    */
+            cr->matPa[(by-1)*b+(by-1)] += cap;
+            cr->vecW1o[by-1] = -4.0 / stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[by-1] += (-4.0 * cap) / stp;
+        }
+    }
+}
+/*========== OmAddQ ==================*//** Function [20]                    */
+void OmAddQ(OmCir* cr, OmInt bx, OmFlt rpc, OmFlt v0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[bx-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[bx-1]) {              /* BDF2 rule                         */
+        cr->matPb[(bx-1)*b+(bx-1)] += (2.0 * rpc * stp) / 3.0;
+        cr->vecQa0[bx-1] += v0;
+        cr->vecQb0[bx-1] += v0;
+        cr->vecW2o[bx-1] = 4.0 / 3.0;
+        cr->vecW3b[bx-1] = -1.0 / 3.0;
+        cr->vecW5b[bx-1] = 1.0;
+        if (btm == OMTYP_X3) {          /* Level 3 branch                    */
+            cr->matPa[(bx-1)*b+(bx-1)] += rpc;
+            cr->vecW1o[bx-1] = (8.0 * stp) / 9.0;
+            cr->vecW4b[bx-1] = (2.0 * stp) / 3.0;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[bx-1] += (8.0 * rpc * stp) / 9.0;
+            cr->vecW4b[bx-1] += (2.0 * rpc * stp) / 3.0;
+        }
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPb[(bx-1)*b+(bx-1)] += rpc * stp;
+        cr->vecQa0[bx-1] += v0;
+        cr->vecW2o[bx-1] = 1.0;
+        if (btm == -OMTYP_X3) {         /* Level 3 branch                    */
+            cr->matPa[(bx-1)*b+(bx-1)] += rpc;
+            cr->vecW1o[bx-1] = stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[bx-1] += rpc * stp;
+        }
+    } else {                            /* trapezoidal rule                  */
+        cr->matPb[(bx-1)*b+(bx-1)] += (rpc * stp) / 2.0;
+        cr->vecQa0[bx-1] += v0;
+        cr->vecW2o[bx-1] = 1.0;
+        if (btm == OMTYP_X3) {          /* Level 3 branch                    */
+            cr->matPa[(bx-1)*b+(bx-1)] += rpc;
+            cr->vecW1o[bx-1] = stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[bx-1] += rpc * stp;
+        }
+    }
+}
+/*========== OmAddP ==================*//** Function [21]                    */
+void OmAddP(OmCir* cr, OmInt by, OmFlt rpi, OmFlt i0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[by-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[by-1]) {              /* BDF2 rule                         */
+        cr->matPb[(by-1)*b+(by-1)] += (2.0 * rpi * stp) / 3.0;
+        cr->vecQa0[by-1] += i0;
+        cr->vecQb0[by-1] += i0;
+        cr->vecW2o[by-1] = 4.0 / 3.0;
+        cr->vecW3b[by-1] = -1.0 / 3.0;
+        cr->vecW5b[by-1] = 1.0;
+        if (btm == OMTYP_Y3) {          /* Level 3 branch                    */
+            cr->matPa[(by-1)*b+(by-1)] += rpi;
+            cr->vecW1o[by-1] = (8.0 * stp) / 9.0;
+            cr->vecW4b[by-1] = (2.0 * stp) / 3.0;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[by-1] += (8.0 * rpi * stp) / 9.0;
+            cr->vecW4b[by-1] += (2.0 * rpi * stp) / 3.0;
+        }
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPb[(by-1)*b+(by-1)] += rpi * stp;
+        cr->vecQa0[by-1] += i0;
+        cr->vecW2o[by-1] = 1.0;
+        if (btm == -OMTYP_Y3) {         /* Level 3 branch                    */
+            cr->matPa[(by-1)*b+(by-1)] += rpi;
+            cr->vecW1o[by-1] = stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[by-1] += rpi * stp;
+        }
+    } else {                            /* trapezoidal rule                  */
+        cr->matPb[(by-1)*b+(by-1)] += (rpi * stp) / 2.0;
+        cr->vecQa0[by-1] += i0;
+        cr->vecW2o[by-1] = 1.0;
+        if (btm == OMTYP_Y3) {          /* Level 3 branch                    */
+            cr->matPa[(by-1)*b+(by-1)] += rpi;
+            cr->vecW1o[by-1] = stp;
+        } else {                        /* Level 2 branch                    */
+            cr->vecW1o[by-1] += rpi * stp;
+        }
+    }
+}
+/*========== OmAddE ==================*//** Function [22]                    */
+void OmAddE(OmCir* cr, OmInt bx, OmInt cy, OmFlt k) {
+    OmInt b;                            /* numB                              */
+    b = cr->numB;
+    cr->matPb[(bx-1)*b+(cy-1)] += k;
+}
+/*========== OmAddH ==================*//** Function [23]                    */
+void OmAddH(OmCir* cr, OmInt bx, OmInt cx, OmFlt k) {
+    OmInt b;                            /* numB                              */
+    b = cr->numB;
+    cr->matPb[(bx-1)*b+(cx-1)] += k;
+}
+/*========== OmAddF ==================*//** Function [24]                    */
+void OmAddF(OmCir* cr, OmInt by, OmInt cx, OmFlt k) {
+    OmInt b;                            /* numB                              */
+    b = cr->numB;
+    cr->matPb[(by-1)*b+(cx-1)] += k;
+}
+/*========== OmAddG ==================*//** Function [25]                    */
+void OmAddG(OmCir* cr, OmInt by, OmInt cy, OmFlt k) {
+    OmInt b;                            /* numB                              */
+    b = cr->numB;
+    cr->matPb[(by-1)*b+(cy-1)] += k;
+}
+/*========== OmAddM ==================*//** Function [26]                    */
+void OmAddM(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt ic0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[bx-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[bx-1]) {              /* BDF2 rule                         */
+        cr->matPa[(bx-1)*b+(cx-1)] += k;
+        cr->matPb[(bx-1)*b+(cx-1)] += (1.5 * k) / stp;
+        cr->vecQa0[bx-1] -= (1.5 * k * ic0) / stp;
+        cr->vecQb0[bx-1] += k * ic0;
+        cr->vecW1o[bx-1] = -2.0 / stp;
+        cr->vecW2o[bx-1] = 0.0;
+        cr->vecW3b[bx-1] = 0.5 / stp;
+        cr->vecW4b[bx-1] = 1.0;
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPa[(bx-1)*b+(cx-1)] += k;
+        cr->matPb[(bx-1)*b+(cx-1)] += k / stp;
+        cr->vecQa0[bx-1] -= (k * ic0) / stp;
+        cr->vecW1o[bx-1] = -1.0 / stp;
+        cr->vecW2o[bx-1] = 0.0;
+    } else {                            /* trapezoidal rule                  */
+        cr->matPa[(bx-1)*b+(cx-1)] += k;
+        cr->matPb[(bx-1)*b+(cx-1)] += (2.0 * k) / stp;
+        cr->vecQa0[bx-1] -= (2.0 * k * ic0) / stp;
+        cr->vecW1o[bx-1] = -4.0 / stp;
+        cr->vecW2o[bx-1] = -1.0;
+    }
+}
+/*========== OmAddN ==================*//** Function [27]                    */
+void OmAddN(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt vc0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[by-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[by-1]) {              /* BDF2 rule                         */
+        cr->matPa[(by-1)*b+(cy-1)] += k;
+        cr->matPb[(by-1)*b+(cy-1)] += (1.5 * k) / stp;
+        cr->vecQa0[by-1] -= (1.5 * k * vc0) / stp;
+        cr->vecQb0[by-1] += k * vc0;
+        cr->vecW1o[by-1] = -2.0 / stp;
+        cr->vecW2o[by-1] = 0.0;
+        cr->vecW3b[by-1] = 0.5 / stp;
+        cr->vecW4b[by-1] = 1.0;
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPa[(by-1)*b+(cy-1)] += k;
+        cr->matPb[(by-1)*b+(cy-1)] += k / stp;
+        cr->vecQa0[by-1] -= (k * vc0) / stp;
+        cr->vecW1o[by-1] = -1.0 / stp;
+        cr->vecW2o[by-1] = 0.0;
+    } else {                            /* trapezoidal rule                  */
+        cr->matPa[(by-1)*b+(cy-1)] += k;
+        cr->matPb[(by-1)*b+(cy-1)] += (2.0 * k) / stp;
+        cr->vecQa0[by-1] -= (2.0 * k * vc0) / stp;
+        cr->vecW1o[by-1] = -4.0 / stp;
+        cr->vecW2o[by-1] = -1.0;
+    }
+}
+/*========== OmAddA ==================*//** Function [28]                    */
+void OmAddA(OmCir* cr, OmInt bx, OmInt cx, OmFlt k, OmFlt v0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[bx-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[bx-1]) {              /* BDF2 rule                         */
+        cr->matPa[(bx-1)*b+(cx-1)] += k;
+        cr->matPb[(bx-1)*b+(cx-1)] += (2.0 * k * stp) / 3.0;
+        cr->vecQa0[bx-1] += v0;
+        cr->vecQb0[bx-1] += v0;
+        cr->vecW1o[bx-1] = (8.0 * stp) / 9.0;
+        cr->vecW2o[bx-1] = 4.0 / 3.0;
+        cr->vecW3b[bx-1] = -1.0 / 3.0;
+        cr->vecW4b[bx-1] = (2.0 * stp) / 3.0;
+        cr->vecW5b[bx-1] = 1.0;
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPa[(bx-1)*b+(cx-1)] += k;
+        cr->matPb[(bx-1)*b+(cx-1)] += k * stp;
+        cr->vecQa0[bx-1] += v0;
+        cr->vecW1o[bx-1] = stp;
+        cr->vecW2o[bx-1] = 1.0;
+    } else {                            /* trapezoidal rule                  */
+        cr->matPa[(bx-1)*b+(cx-1)] += k;
+        cr->matPb[(bx-1)*b+(cx-1)] += (k * stp) / 2.0;
+        cr->vecQa0[bx-1] += v0;
+        cr->vecW1o[bx-1] = stp;
+        cr->vecW2o[bx-1] = 1.0;
+    }
+}
+/*========== OmAddB ==================*//** Function [29]                    */
+void OmAddB(OmCir* cr, OmInt by, OmInt cy, OmFlt k, OmFlt i0) {
+    OmInt btm;                          /* branch type and ode method        */
+    OmInt b;                            /* numB                              */
+    OmFlt stp;                          /* timStp                            */
+    btm = cr->vecBtm[by-1];
+    b = cr->numB;
+    stp = cr->timStp;
+    if (cr->vecBd[by-1]) {              /* BDF2 rule                         */
+        cr->matPa[(by-1)*b+(cy-1)] += k;
+        cr->matPb[(by-1)*b+(cy-1)] += (2.0 * k * stp) / 3.0;
+        cr->vecQa0[by-1] += i0;
+        cr->vecQb0[by-1] += i0;
+        cr->vecW1o[by-1] = (8.0 * stp) / 9.0;
+        cr->vecW2o[by-1] = 4.0 / 3.0;
+        cr->vecW3b[by-1] = -1.0 / 3.0;
+        cr->vecW4b[by-1] = (2.0 * stp) / 3.0;
+        cr->vecW5b[by-1] = 1.0;
+    } else if (btm < 0) {               /* backward euler rule               */
+        cr->matPa[(by-1)*b+(cy-1)] += k;
+        cr->matPb[(by-1)*b+(cy-1)] += k * stp;
+        cr->vecQa0[by-1] += i0;
+        cr->vecW1o[by-1] = stp;
+        cr->vecW2o[by-1] = 1.0;
+    } else {                            /* trapezoidal rule                  */
+        cr->matPa[(by-1)*b+(cy-1)] += k;
+        cr->matPb[(by-1)*b+(cy-1)] += (k * stp) / 2.0;
+        cr->vecQa0[by-1] += i0;
+        cr->vecW1o[by-1] = stp;
+        cr->vecW2o[by-1] = 1.0;
+    }
+}
+/*========== OmAddS ==================*//** Function [30]                    */
+void OmAddS(OmCir* cr, OmInt bs, OmFlt k1, OmFlt k2, OmFlt ysw, OmFlt ron) {
+    OmInt b;                            /* numB                              */
+    b = cr->numB;
+    cr->vecTa[bs-1] = (ysw <= 0.0);
+    if (ysw <= 0.0) {                   /* tuned at stamp, start from -ysw   */
+        ysw = (ysw < 0.0) ? -ysw : 1.0;
+        k1 = 1.0;
+        k2 = 0.0;
+    }
+    cr->matPb[(bs-1)*b+(bs-1)] += ysw / (1.0 + ysw * ron);
+    OmAddSw(cr, bs-1, k1, k2, ysw, ron);
+}
+/*========== OmMatInv ================*//** Function [31]                    */
+void OmMatInv(OmInt m, OmFlt* a) {
+    OmMatInvWs(m, a, NULL);
+}
+/*========== OmMatPiv ================*//** Helper of Function [55]          */
+static void OmMatPiv(OmInt m, OmFlt* a, OmInt* pm) {
+    OmInt i, j;                         /* used in for-loop                  */
+    OmFlt mv;                           /* max value of row                  */
+    OmFlt cv;                           /* current value                     */
+    OmInt tmp;                          /* used for swap                     */
+    for (i=0; i < m; ++i) {             /* initialize pm with row index      */
+        pm[i] = i;
+    }    
+    for (j=0; j < m; ++j) {             /* sort rows by pivot element        */
+        mv = 0.0;
+        for (i=j; i < m; ++i) {
+            cv = OMABS(a[pm[i]*m+j]);   /* cv = A[pm[i], j]                  */
+            if (cv > mv) {              /* swap rows                         */
+                mv = cv;
+                tmp = pm[j];
+                pm[j] = pm[i];
+                pm[i] = tmp;
+            }
+        }
+    }
+}
+/*========== OmMatLuInv ==============*//** Helper of Function [55]          */
+static OmInt OmMatLuInv(OmInt m, OmFlt* a, OmFlt* lu, OmInt* pm, OmFlt tol) {
+    OmInt i, j, k;                      /* used in for-loop                  */
+    OmFlt mv;                           /* max value of row                  */
+    OmFlt cv;                           /* current value                     */
+    /*======== Step 1: Apply row permutation pm =============================*/
+    for (i=0; i < m; ++i) {               /* make matrix G with new row order  */
+        for (j=0; j < m; ++j) { 
+            lu[i*m+j] = a[pm[i]*m+j];
+        }
+    }
+    /*======== Step 2: LU decomposition (save both L & U in lu) =============*/
+    for (i=0; i < m; ++i) {             /* calculate U matrix                */
+        for (j=i; j < m; ++j) {
+            for (k=0; k < i; ++k) {     /* LU[i,j] -= LU[i,k] * LU[k,j]      */
+                lu[i*m+j] -= lu[i*m+k] * lu[k*m+j]; 
+            }
+        }
+        for (k=i+1; k < m; ++k) {       /* calculate L matrix                */
+            for (j=0; j < i; ++j) {     /* LU[k,i] -= LU[k,j] * LU[j,i]      */
+                lu[k*m+i] -= lu[k*m+j] * lu[j*m+i]; 
+            }
+            lu[k*m+i] /= lu[i*m+i];     /* LU[k,i] /= LU[i,i]                */
+        }
+    }
+    if (tol > 0.0) {                    /* reject tiny pivot, a unchanged    */
+        for (i=0; i < m; ++i) {
+            mv = 0.0;
+            for (j=0; j < m; ++j) {
+                cv = OMABS(a[pm[i]*m+j]);
+                if (cv > mv) mv = cv;
+            }
+            if (OMABS(lu[i*m+i]) <= tol * mv) return 1;
+        }
+    }
+    /*======== Step 3: LU inversion (save both L^-1 & U^-1 in mat) ==========*/
+    for (i=0; i < m; ++i) {             /* fill matrix with zeros            */
+        for (j=0; j < m; ++j) {
+            a[i*m+j] = 0.0;
+        }
+    }
+    for (i=0; i < m; ++i) {             /* L inverse & U inverse             */
+        a[i*m+i] = 1.0;                 /* L matrix inverse, omit diagonal   */           
+        for (k=i+1; k < m; ++k) {       /* Inv[k,i] -= LU[k,j] * Inv[j,i]    */
+            for (j=i; j <= k - 1; ++j) {
+                a[k*m+i] -= lu[k*m+j] * a[j*m+i];
+            }
+        }
+        a[i*m+i] = 1.0 / lu[i*m+i];     /* U matrix inverse                  */
+        for (k=i-1; k >= 0; --k) {      /* Inv[k,i] -= LU[k,j] * Inv[j,i]    */ 
+            for (j=k+1; j <= i; ++j) {
+                a[k*m+i] -= lu[k*m+j] * a[j*m+i];
+            }
+            a[k*m+i] /= lu[k*m+k];
+        }
+    }
+    /*======== Step 4: Calculate G^-1 = U^-1 * L^-1 (save in lu) ============*/
+    for (i=0; i < m; ++i) {             /* set initial value                 */
+        for (j=0; j < i; ++j) {
+            lu[i*m+j] = 0.0;            /* G[i,j] = 0.0                      */
+        }
+        for (j=i; j < m; ++j) {
+            lu[i*m+j] = a[i*m+j];       /* G[i,j] = Inv[i,j]                 */
+        }
+    }
+    for (i=1; i < m; ++i) {             /* lower part product                */
+        for (k=i; k < m; ++k) {         /* G[i,j] += Inv[i,k] * Inv[k,j]     */
+            for (j=0; j < i; ++j) {
+                lu[i*m+j] += a[i*m+k] * a[k*m+j];
+            }       
+        }
+    }
+    for (i=0; i < m; ++i) {             /* upper part product                */
+        for (j=i; j < m; ++j) {         /* G[i,j] += Inv[i,k] * Inv[k,j]     */
+            for (k=j+1; k < m; ++k) {
+                lu[i*m+j] += a[i*m+k] * a[k*m+j];
+            }
+        }
+    }
+    /*======== Step 5: Permute column back (save in mat) ====================*/
+    for (i=0; i < m; ++i) {
+        for (j=0; j < m; ++j) {
+            a[i*m+pm[j]] = lu[i*m+j];
+        }
+    }
+    return 0;
+}
+/*========== OmMatInvWs ==============*//** Function [55]                    */
+void OmMatInvWs(OmInt m, OmFlt* a, OmFlt* ws) {
+    OmInt* pm;                          /* permute vector [m]                */
+    OmFlt* lu;                          /* LU matrix [m,m]                   */
+    OmInt i, bk;                        /* used in for-loop, use backend     */
+    /*======== Step 0: Row permutation (swap diagonal zeros) ================*/
+    if (ws != NULL) {                   /* use caller scratch, no allocation */
+        lu = ws;
+        pm = (OmInt*)(ws + m * m);
+    } else {
+        pm = (OmInt*)OMMALLOC(m * sizeof(OmInt));
+        lu = (OmFlt*)OMMALLOC(m * m * sizeof(OmFlt));
+    }
+    bk = omBk != NULL && omBk->matLuf != NULL && omBk->matLus != NULL
+      && m >= omBk->minM;               /* matLuf needs its matLus           */
+    if (bk) {                           /* backend LU, solve A X = I         */
+        for (i=0; i < m * m; ++i) lu[i] = a[i];
+        bk = omBk->matLuf(m, lu, pm) == 0;
+    }
+    if (bk) {
+        for (i=0; i < m * m; ++i) a[i] = (i % (m + 1) == 0) ? 1.0 : 0.0;
+        omBk->matLus(m, m, lu, pm, a);
+    } else {                            /* built-in, also if singular        */
+        OmMatPiv(m, a, pm);
+        OmMatLuInv(m, a, lu, pm, 0.0);
+    }
+    if (ws != NULL) return;
+    free(pm);
+    free(lu);
+}
+/*========== OmMatMul ================*//** Function [32]                    */
+void OmMatMul(OmInt m, OmFlt* c, OmFlt* a, OmFlt* b) {
+    OmInt i, j, k;                      /* used in for-loop                  */
+    OmFlt s;                            /* temporary value                   */
+    if (omBk != NULL && omBk->matGmm != NULL && m >= omBk->minM) {
+        omBk->matGmm(m, m, m, c, a, b);
+        return;
+    }
+    for (i=0; i < m; ++i) {
+        for (j=0; j < m; ++j) {
+            c[i*m+j] = 0.0;
+        }
+    }
+    for(i=0; i < m; ++i) {
+        for(k=0; k < m; ++k) {
+            s = a[i*m+k];
+            for (j=0; j < m; ++j) {
+                c[i*m+j] += s * b[k*m+j];
+            }
+        }
+    }
+}
+/*========== OmVecMul ================*//** Function [33]                    */
+void OmVecMul(OmInt m, OmInt n, OmFlt* y, OmFlt* a, OmFlt* x) {
+    OmInt i, j;                         /* used in for-loop                  */
+    OmFlt sum;                          /* used to store summation value     */
+    if (omBk != NULL && omBk->vecGmv != NULL && m >= omBk->minM) {
+        omBk->vecGmv(m, n, y, a, x);
+        return;
+    }
+    for (i=0; i < m; ++i) {
+        sum = 0.0;
+        for (j=0; j < n; ++j) {
+            sum += a[i*n+j] * x[j];
+        }
+        y[i] = sum;
+    }
+}
+/*========== OmVecAdd ================*//** Function [34]                    */
+void OmVecAdd(OmInt m, OmFlt* z, OmFlt* x, OmFlt* y) {
+    OmInt i;                            /* used in for-loop                  */
+    for (i=0; i < m; ++i) {
+        z[i] = x[i] + y[i];
+    }
+}
+/*========== OmVecFma ================*//** Function [35]                    */
+void OmVecFma(OmInt m, OmFlt* y, OmFlt* w1, OmFlt* x, OmFlt* w2) {
+    OmInt i;                            /* used in for-loop                  */
+    for (i=0; i < m; ++i) {
+        y[i] = w1[i] * x[i] + w2[i] * y[i];
+    }
+}
+/*========== OmEmitF =================*//** Helper of Function [36]          */
+static void OmEmitF(FILE* fp, OmFlt v) {
+    char buf[40];                       /* formatted number                  */
+    OmInt i, dot;                       /* used in for-loop, has dot / exp   */
+    sprintf(buf, "%.17g", v);
+    dot = 0;
+    for (i=0; buf[i] != '\0'; ++i) {    /* keep literal a double constant    */
+        if (buf[i] == '.' || buf[i] == 'e') dot = 1;
+    }
+    fprintf(fp, dot ? "%s" : "%s.0", buf);
+}
+/*========== OmEmitN =================*//** Helper of Function [36]          */
+static OmInt OmEmitN(OmCir* cr) {
+    OmInt b, m, c;                      /* numB, numM, numC                  */
+    OmInt i;                            /* used in for-loop                  */
+    OmFlt v;                            /* value minus itself, 0.0 if finite */
+    b = cr->numB;
+    m = cr->numM;
+    c = cr->numC;
+    for (i=0, v=0.0; i < c * c; ++i) v += cr->matC[i] - cr->matC[i];
+    for (i=0; i < m * c; ++i) v += cr->matD[i] - cr->matD[i];
+    for (i=0; i < b; ++i) {
+        v += cr->vecW1c[i] - cr->vecW1c[i] + cr->vecW2c[i] - cr->vecW2c[i];
+        v += cr->vecW1o[i] - cr->vecW1o[i] + cr->vecW2o[i] - cr->vecW2o[i];
+        v += cr->vecQa0[i] - cr->vecQa0[i] + cr->vecQs0[i] - cr->vecQs0[i];
+    }
+    return v != 0.0 || v != v;
+}
+/*========== OmEmitT =================*//** Helper of Function [36]          */
+static void OmEmitT(FILE* fp, OmFlt k, const char* v, OmInt j, OmInt* nt) {
+    if (k == 0.0) return;               /* exact zeros are skipped           */
+    if (*nt == 0) {                     /* first term of expression          */
+        fputs(k < 0.0 ? "-" : "", fp);
+    } else {
+        if (*nt % 4 == 0) fputs("\n       ", fp);
+        fputs(k < 0.0 ? " - " : " + ", fp);
+    }
+    if (OMABS(k) != 1.0) {              /* fold unit coefficient             */
+        OmEmitF(fp, OMABS(k));
+        fputc('*', fp);
+    }
+    fprintf(fp, v, j);
+    *nt += 1;
+}
+/*========== OmEmitC =================*//** Function [36]                    */
+void OmEmitC(OmCir* cr, FILE* fp, const char* nm) {
+    OmInt b, m, c;                      /* numB, numM, numC                  */
+    OmInt i, j, nt, ns;                 /* loop index, term and switch count */
+    OmInt ilut;                         /* lookup table value                */
+    OmInt* rb;                          /* branch of each kept row     [c]   */
+    OmInt* rs;                          /* switch slot of row, -1 none [c]   */
+    OmInt* rq;                          /* row carries associated source [c] */
+    OmFlt w1, w2;                       /* folded row weights                */
+    b = cr->numB;
+    m = cr->numM;
+    c = cr->numC;
+    if (cr->vecQb != NULL) {            /* second history is not emitted     */
+        fprintf(fp, "#error \"%s: BDF2 branches are not emitted\"\n", nm);
+        return;
+    }
+    if (OmEmitN(cr)) {                  /* inf / nan have no C89 literal     */
+        fprintf(fp, "#error \"%s: non-finite coefficient\"\n", nm);
+        return;
+    }
+    /*======== Step 0: Classify kept rows ===================================*/
+    rb = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    rs = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    rq = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    for (i=0; i < b; ++i) {
+        ilut = cr->vecLut[i];
+        if (ilut >= 0) rb[ilut] = i;
+    }
+    ns = 0;
+    for (i=0; i < c; ++i) {
+        j = rb[i];
+        rs[i] = -1;
+        if (OMABS(cr->vecBtm[j]) == OMTYP_SW) rs[i] = ns++;
+        rq[i] = (rs[i] >= 0 || cr->vecW1o[j] != 0.0 ||
+                 cr->vecW2o[j] != 0.0 || cr->vecQa0[j] != 0.0);
+    }
+    /*======== Step 1: State structure and switch tables ====================*/
+    fprintf(fp, "/* Generated by LibOhm OmEmitC(), c = %d, m = %d */\n\n",
+            (int)c, (int)m);
+    fprintf(fp, "typedef struct %sState {\n", nm);
+    fprintf(fp, "    double qa[%d];\n", (int)(c > 0 ? c : 1));
+    fprintf(fp, "    double qs[%d];\n", (int)(c > 0 ? c : 1));
+    fprintf(fp, "    double qt[%d];\n", (int)(c > 0 ? c : 1));
+    fprintf(fp, "    double xc[%d];\n", (int)(c > 0 ? c : 1));
+    fprintf(fp, "    double xm[%d];\n", (int)(m > 0 ? m : 1));
+    fprintf(fp, "    double w1[%d];\n", (int)(ns > 0 ? ns : 1));
+    fprintf(fp, "    double w2[%d];\n", (int)(ns > 0 ? ns : 1));
+    fprintf(fp, "} %sState;\n\n", nm);
+    if (ns > 0) {
+        const char* tn[4];              /* switch table names                */
+        tn[0] = "W1c"; tn[1] = "W2c"; tn[2] = "W1o"; tn[3] = "W2o";
+        for (j=0; j < 4; ++j) {
+            fprintf(fp, "static const double %s%s[%d] = {", nm, tn[j],
+                    (int)ns);
+            nt = 0;
+            for (i=0; i < c; ++i) {
+                if (rs[i] < 0) continue;
+                fputs(nt++ ? ", " : "", fp);
+                if (j == 0) OmEmitF(fp, cr->vecW1c[rb[i]]);
+                if (j == 1) OmEmitF(fp, cr->vecW2c[rb[i]]);
+                if (j == 2) OmEmitF(fp, cr->vecW1o[rb[i]]);
+                if (j == 3) OmEmitF(fp, cr->vecW2o[rb[i]]);
+            }
+            fprintf(fp, "};\n");
+        }
+        fprintf(fp, "\n");
+    }
+    /*======== Step 2: Reset, SetQs and SetSw ===============================*/
+    fprintf(fp, "void %sReset(%sState* s) {\n", nm, nm);
+    for (i=0; i < c; ++i) {
+        fprintf(fp, "    s->qa[%d] = ", (int)i);
+        OmEmitF(fp, cr->vecQa0[rb[i]]);
+        fprintf(fp, "; s->qs[%d] = ", (int)i);
+        OmEmitF(fp, cr->vecQs0[rb[i]]);
+        fprintf(fp, ";\n    s->qt[%d] = s->qa[%d] + s->qs[%d];"
+                " s->xc[%d] = 0.0;\n", (int)i, (int)i, (int)i, (int)i);
+        if (rs[i] < 0) continue;
+        fprintf(fp, "    s->w1[%d] = %sW1o[%d]; s->w2[%d] = %sW2o[%d];\n",
+                (int)rs[i], nm, (int)rs[i], (int)rs[i], nm, (int)rs[i]);
+    }
+    for (i=0; i < m; ++i) fprintf(fp, "    s->xm[%d] = 0.0;\n", (int)i);
+    fprintf(fp, "}\n\n");
+    fprintf(fp, "void %sSetQs(%sState* s, int br, double x) {\n", nm, nm);
+    fprintf(fp, "    switch (br) {\n");
+    for (i=0; i < c; ++i) {
+        fprintf(fp, "    case %d: s->qs[%d] = x; break;\n",
+                (int)(rb[i]+1), (int)i);
+    }
+    fprintf(fp, "    default: break;\n    }\n    (void)s; (void)x;\n}\n\n");
+    fprintf(fp, "void %sSetSw(%sState* s, int br, int on) {\n", nm, nm);
+    fprintf(fp, "    switch (br) {\n");
+    for (i=0; i < c; ++i) {
+        if (rs[i] < 0) continue;
+        fprintf(fp, "    case %d:\n", (int)(rb[i]+1));
+        fprintf(fp, "        s->w1[%d] = on ? %sW1c[%d] : %sW1o[%d];\n",
+                (int)rs[i], nm, (int)rs[i], nm, (int)rs[i]);
+        fprintf(fp, "        s->w2[%d] = on ? %sW2c[%d] : %sW2o[%d];\n",
+                (int)rs[i], nm, (int)rs[i], nm, (int)rs[i]);
+        fprintf(fp, "        break;\n");
+    }
+    fprintf(fp, "    default: break;\n    }\n    (void)s; (void)on;\n}\n\n");
+    /*======== Step 3: UpdCr and UpdSw (fully unrolled) =====================*/
+    for (j=0; j < 2; ++j) {             /* j = 0: UpdCr, j = 1: UpdSw        */
+        fprintf(fp, "void %s%s(%sState* s) {\n", nm,
+                j == 0 ? "UpdCr" : "UpdSw", nm);
+        for (i=0; i < c; ++i) {
+            if (rq[i]) {
+                fprintf(fp, "    s->qt[%d] = s->qa[%d] + s->qs[%d];\n",
+                        (int)i, (int)i, (int)i);
+            } else {                    /* Qa of stateless row is always 0   */
+                fprintf(fp, "    s->qt[%d] = s->qs[%d];\n", (int)i, (int)i);
+            }
+        }
+        for (i=0; i < c; ++i) {
+            OmInt k;                    /* column index                      */
+            if (j == 1 && rs[i] < 0) continue;
+            fprintf(fp, "    s->xc[%d] = ", (int)i);
+            nt = 0;
+            for (k=0; k < c; ++k) {
+                OmEmitT(fp, cr->matC[i*c+k], "s->qt[%d]", k, &nt);
+            }
+            fputs(nt ? ";\n" : "0.0;\n", fp);
+        }
+        for (i=0; i < c; ++i) {
+            if (rs[i] >= 0) {           /* switch weights come from state    */
+                fprintf(fp, "    s->qa[%d] = s->w1[%d] * s->xc[%d]"
+                        " + s->w2[%d] * s->qa[%d];\n", (int)i, (int)rs[i],
+                        (int)i, (int)rs[i], (int)i);
+                continue;
+            }
+            if (j == 1 || !rq[i]) continue;
+            w1 = cr->vecW1o[rb[i]];
+            w2 = cr->vecW2o[rb[i]];
+            if (w1 == 0.0 && w2 == 1.0) continue;
+            fprintf(fp, "    s->qa[%d] = ", (int)i);
+            nt = 0;
+            OmEmitT(fp, w1, "s->xc[%d]", i, &nt);
+            OmEmitT(fp, w2, "s->qa[%d]", i, &nt);
+            fputs(nt ? ";\n" : "0.0;\n", fp);
+        }
+        fprintf(fp, "    (void)s;\n}\n\n");
+    }
+    /*======== Step 4: UpdMt ================================================*/
+    fprintf(fp, "void %sUpdMt(%sState* s) {\n", nm, nm);
+    for (i=0; i < m; ++i) {
+        fprintf(fp, "    s->xm[%d] = ", (int)i);
+        nt = 0;
+        for (j=0; j < c; ++j) {
+            OmEmitT(fp, cr->matD[i*c+j], "s->qt[%d]", j, &nt);
+        }
+        fputs(nt ? ";\n" : "0.0;\n", fp);
+    }
+    fprintf(fp, "    (void)s;\n}\n");
+    OMFREE(rb);
+    OMFREE(rs);
+    OMFREE(rq);
+}
+/*========== OmPermute ===============*//** Helper of Function [37]          */
+static void OmPermute(OmCir* cr, OmInt* pm) {
+    OmInt b, m, c;                      /* numB, numM, numC                  */
+    OmInt i, j;                         /* used in for-loop                  */
+    OmFlt* tmp;                         /* copy of permuted data             */
+    OmFlt* vec[12];                     /* runtime vectors to be permuted    */
+    OmInt nv;                           /* number of vectors to be permuted  */
+    b = cr->numB;
+    m = cr->numM;
+    c = cr->numC;
+    tmp = (OmFlt*)OMMALLOC((c * c + m * c + 1) * sizeof(OmFlt));
+    cr->numP = 0;                       /* cached powers of G are stale      */
+    for (i=0; i < c * c; ++i) tmp[i] = cr->matC[i];
+    for (i=0; i < c; ++i) {             /* C'[pm[i],pm[j]] = C[i,j]          */
+        for (j=0; j < c; ++j) {
+            cr->matC[pm[i]*c+pm[j]] = tmp[i*c+j];
+        }
+    }
+    for (i=0; i < m * c; ++i) tmp[i] = cr->matD[i];
+    for (i=0; i < m; ++i) {             /* D'[i,pm[j]] = D[i,j]              */
+        for (j=0; j < c; ++j) {
+            cr->matD[i*c+pm[j]] = tmp[i*c+j];
+        }
+    }
+    vec[0] = cr->vecW1m; vec[1] = cr->vecW2m;
+    vec[2] = cr->vecW1s; vec[3] = cr->vecW2s;
+    vec[4] = cr->vecQa;  vec[5] = cr->vecQs;
+    vec[6] = cr->vecQtp; vec[7] = cr->vecXc;
+    vec[8] = cr->vecW3m; vec[9] = cr->vecW4m;
+    vec[10] = cr->vecW5m; vec[11] = cr->vecQb;
+    nv = (cr->vecQb != NULL) ? 12 : 8;  /* BDF2 rows carry a second history  */
+    for (j=0; j < nv; ++j) {
+        for (i=0; i < c; ++i) tmp[i] = vec[j][i];
+        for (i=0; i < c; ++i) vec[j][pm[i]] = tmp[i];
+    }
+    for (i=0; i < b; ++i) {             /* remap kept branches               */
+        if (cr->vecLut[i] >= 0) cr->vecLut[i] = pm[cr->vecLut[i]];
+    }
+    OMFREE(tmp);
+}
+/*========== OmSpmCsr ================*//** Helper of Function [37]          */
+static void OmSpmCsr(OmInt m, OmInt n, OmFlt* a, OmFlt tol,
+                     OmInt** pp, OmInt** pi, OmFlt** pv) {
+    OmInt i, j, z;                      /* used in for-loop, nonzero count   */
+    OmFlt mv;                           /* max abs value of row              */
+    *pp = (OmInt*)OMMALLOC((m+1) * sizeof(OmInt));
+    z = 0;
+    for (i=0; i < m; ++i) {             /* count kept entries of each row    */
+        (*pp)[i] = z;
+        mv = 0.0;
+        for (j=0; j < n; ++j) if (OMABS(a[i*n+j]) > mv) mv = OMABS(a[i*n+j]);
+        for (j=0; j < n; ++j) {
+            if (a[i*n+j] != 0.0 && OMABS(a[i*n+j]) > tol * mv) z += 1;
+        }
+    }
+    (*pp)[m] = z;
+    *pi = (OmInt*)OMMALLOC((z+1) * sizeof(OmInt));
+    *pv = (OmFlt*)OMMALLOC((z+1) * sizeof(OmFlt));
+    z = 0;
+    for (i=0; i < m; ++i) {             /* fill column index and value       */
+        mv = 0.0;
+        for (j=0; j < n; ++j) if (OMABS(a[i*n+j]) > mv) mv = OMABS(a[i*n+j]);
+        for (j=0; j < n; ++j) {
+            if (a[i*n+j] == 0.0 || OMABS(a[i*n+j]) <= tol * mv) continue;
+            (*pi)[z] = j;
+            (*pv)[z] = a[i*n+j];
+            z += 1;
+        }
+    }
+}
+/*========== OmSparse ================*//** Function [37]                    */
+void OmSparse(OmCir* cr, OmFlt tol) {
+    OmInt m, c;                         /* numM, numC                        */
+    OmInt i, j, ri, rj;                 /* used in for-loop, component roots */
+    OmInt* uf;                          /* union-find parent / label   [c]   */
+    OmInt* pm;                          /* new row index of old row    [c]   */
+    OmFlt mv;                           /* max abs value of row              */
+    m = cr->numM;
+    c = cr->numC;
+    /*======== Step 0: Release previous sparse form =========================*/
+    OmSsx(cr, -1, NULL);                /* rows are permuted below           */
+    cr->numK = 0;
+    OMFREE(cr->vecKb); cr->vecKb = NULL;
+    OMFREE(cr->vecCp); cr->vecCp = NULL;
+    OMFREE(cr->vecCi); cr->vecCi = NULL;
+    OMFREE(cr->vecCv); cr->vecCv = NULL;
+    OMFREE(cr->vecDp); cr->vecDp = NULL;
+    OMFREE(cr->vecDi); cr->vecDi = NULL;
+    OMFREE(cr->vecDv); cr->vecDv = NULL;
+    if (tol < 0.0) return;              /* back to dense runtime form        */
+    /*======== Step 1: Connected components of coupling graph ===============*/
+    uf = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    pm = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    for (i=0; i < c; ++i) uf[i] = i;
+    for (i=0; i < c; ++i) {
+        mv = 0.0;
+        for (j=0; j < c; ++j) {
+            if (OMABS(cr->matC[i*c+j]) > mv) mv = OMABS(cr->matC[i*c+j]);
+        }
+        for (j=0; j < c; ++j) {
+            if (cr->matC[i*c+j] == 0.0) continue;
+            if (OMABS(cr->matC[i*c+j]) <= tol * mv) continue;
+            for (ri=i; uf[ri] != ri; ri=uf[ri]) uf[ri] = uf[uf[ri]];
+            for (rj=j; uf[rj] != rj; rj=uf[rj]) uf[rj] = uf[uf[rj]];
+            if (ri < rj) uf[rj] = ri;   /* keep smallest row as root         */
+            if (rj < ri) uf[ri] = rj;
+        }
+    }
+    /*======== Step 2: Permute blocks into contiguous rows ==================*/
+    for (i=0; i < c; ++i) {             /* resolve root of each row          */
+        for (ri=i; uf[ri] != ri; ri=uf[ri]);
+        pm[i] = ri;                     /* root is the first row of block    */
+    }
+    for (i=0; i < c; ++i) {             /* number blocks by their first row  */
+        if (pm[i] == i) uf[i] = cr->numK++;
+    }
+    for (i=0; i < c; ++i) pm[i] = uf[pm[i]];
+    cr->vecKb = (OmInt*)OMMALLOC((cr->numK+1) * sizeof(OmInt));
+    for (i=0; i <= cr->numK; ++i) cr->vecKb[i] = 0;
+    for (i=0; i < c; ++i) cr->vecKb[pm[i]+1] += 1;
+    for (i=0; i < cr->numK; ++i) cr->vecKb[i+1] += cr->vecKb[i];
+    for (i=0; i < cr->numK; ++i) uf[i] = cr->vecKb[i];
+    for (i=0; i < c; ++i) pm[i] = uf[pm[i]]++;
+    OmPermute(cr, pm);
+    OMFREE(uf);
+    OMFREE(pm);
+    /*======== Step 3: Compressed sparse rows of C and D ====================*/
+    OmSpmCsr(c, c, cr->matC, tol, &cr->vecCp, &cr->vecCi, &cr->vecCv);
+    OmSpmCsr(m, c, cr->matD, tol, &cr->vecDp, &cr->vecDi, &cr->vecDv);
+}
+/*========== OmUpdBk =================*//** Function [38]                    */
+void OmUpdBk(OmCir* cr, OmInt k) {
+    OmInt i, j, r0, r1;                 /* used in for-loop, row range       */
+    OmFlt sum;                          /* used to store summation value     */
+    r0 = cr->vecKb[k-1];
+    r1 = cr->vecKb[k];
+    for (i=r0; i < r1; ++i) cr->vecQtp[i] = cr->vecQa[i] + cr->vecQs[i];
+    for (i=r0; i < r1; ++i) {
+        sum = 0.0;
+        for (j=cr->vecCp[i]; j < cr->vecCp[i+1]; ++j) {
+            sum += cr->vecCv[j] * cr->vecQtp[cr->vecCi[j]];
+        }
+        cr->vecXc[i] = sum;
+    }
+    for (i=r0; i < r1; ++i) {
+        if (cr->vecQb != NULL) {        /* BDF2 branches, second history     */
+            OmBdfFma(cr, i);
+            continue;
+        }
+        cr->vecQa[i] = cr->vecW1m[i] * cr->vecXc[i]
+                     + cr->vecW2m[i] * cr->vecQa[i];
+    }
+}
+/*========== OmSpmMul ================*//** Function [39]                    */
+void OmSpmMul(OmInt m, OmFlt* y, OmInt* p, OmInt* ci, OmFlt* v, OmFlt* x) {
+    OmInt i, j;                         /* used in for-loop                  */
+    OmFlt sum;                          /* used to store summation value     */
+    for (i=0; i < m; ++i) {
+        sum = 0.0;
+        for (j=p[i]; j < p[i+1]; ++j) {
+            sum += v[j] * x[ci[j]];
+        }
+        y[i] = sum;
+    }
+}
+#ifdef LIBOHM_FIX                       /*| fixed-point runtime (opt-in)    |*/
+/*========== OmFxpP2 =================*//** Helper of Function [40]          */
+static OmFlt OmFxpP2(OmInt e) {
+    OmFlt v;                            /* v = 2^e                           */
+    v = 1.0;
+    for (; e > 0; --e) v *= 2.0;
+    for (; e < 0; ++e) v *= 0.5;
+    return v;
+}
+/*========== OmFxpFb =================*//** Helper of Function [40]          */
+static OmInt OmFxpFb(OmFlt r, OmInt top, OmInt lo, OmInt hi) {
+    OmInt f;                            /* largest f with r * 2^f < 2^top    */
+    OmFlt lim;                          /* 2^top                             */
+    if (r <= 0.0) return hi < top ? hi : top;
+    lim = OmFxpP2(top);
+    f = 0;
+    while (f > lo && r * OmFxpP2(f) >= lim) f -= 1;
+    while (f < hi && r * OmFxpP2(f+1) < lim) f += 1;
+    return f;
+}
+/*========== OmFxpQt =================*//** Helper of Function [40]          */
+static OmI32 OmFxpQt(OmFxp* fx, OmFlt v, OmInt f) {
+    v = v * OmFxpP2(f);
+    v = v < 0.0 ? v - 0.5 : v + 0.5;    /* round to nearest                  */
+    if (v >= 2147483647.0) { fx->numSat += 1; return 2147483647; }
+    if (v <= -2147483647.0) { fx->numSat += 1; return -2147483647; }
+    return (OmI32)v;
+}
+/*========== OmFxpSh =================*//** Helper of Function [48]          */
+static OmI64 OmFxpSh(OmI64 a, OmInt s) {
+    if (s <= 0) return a;               /* rounding arithmetic right shift   */
+    return (a + ((OmI64)1 << (s-1))) >> s;
+}
+/*========== OmFxpSt =================*//** Helper of Function [48]          */
+static OmI32 OmFxpSt(OmFxp* fx, OmI64 a) {
+    if (a > 2147483647) { fx->numSat += 1; return 2147483647; }
+    if (a < -2147483647) { fx->numSat += 1; return -2147483647; }
+    return (OmI32)a;
+}
+/*========== OmFxpNew ================*//** Function [40]                    */
+OmFxp* OmFxpNew(OmCir* cr) {
+    OmInt b, m, c;                      /* numB, numM, numC                  */
+    OmInt i, ilut;                      /* used in for-loop, lookup value    */
+    OmFxp* fx;                          /* new fixed-point runtime           */
+    if (cr == NULL || cr->matC == NULL || cr->vecQb != NULL) return NULL;
+    b = cr->numB;
+    m = cr->numM;
+    c = cr->numC;
+    fx = (OmFxp*)OMMALLOC(sizeof(OmFxp));
+    fx->cir    = cr;
+    fx->numC   = c;
+    fx->numM   = m;
+    fx->numCal = 0;
+    fx->numSat = 0;
+    fx->errXc  = 0.0;
+    fx->errXm  = 0.0;
+    fx->vecRs  = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    fx->vecRq  = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    fx->vecRx  = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    fx->vecRm  = (OmFlt*)OMMALLOC((m+1) * sizeof(OmFlt));
+    fx->vecFq  = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    fx->vecFx  = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    fx->vecFm  = (OmInt*)OMMALLOC((m+1) * sizeof(OmInt));
+    fx->matCq  = (OmI32*)OMMALLOC((c*c+1) * sizeof(OmI32));
+    fx->vecCs  = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    fx->matDq  = (OmI32*)OMMALLOC((m*c+1) * sizeof(OmI32));
+    fx->vecDs  = (OmInt*)OMMALLOC((m+1) * sizeof(OmInt));
+    fx->matWq  = (OmI32*)OMMALLOC((c*4+1) * sizeof(OmI32));
+    fx->matWs  = (OmInt*)OMMALLOC((c*4+1) * sizeof(OmInt));
+    fx->vecSw  = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    fx->vecA1  = (OmI32*)OMMALLOC((c+1) * sizeof(OmI32));
+    fx->vecT1  = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    fx->vecA2  = (OmI32*)OMMALLOC((c+1) * sizeof(OmI32));
+    fx->vecT2  = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    fx->vecQa  = (OmI32*)OMMALLOC((c+1) * sizeof(OmI32));
+    fx->vecQs  = (OmI32*)OMMALLOC((c+1) * sizeof(OmI32));
+    fx->vecQtp = (OmI32*)OMMALLOC((c+1) * sizeof(OmI32));
+    fx->vecXc  = (OmI32*)OMMALLOC((c+1) * sizeof(OmI32));
+    fx->vecXm  = (OmI32*)OMMALLOC((m+1) * sizeof(OmI32));
+    for (i=0; i < c; ++i) {
+        fx->vecRs[i] = 0.0;
+        fx->vecRq[i] = 0.0;
+        fx->vecRx[i] = 0.0;
+        fx->vecSw[i] = 0;
+    }
+    for (i=0; i < m; ++i) fx->vecRm[i] = 0.0;
+    for (i=0; i < b; ++i) {             /* initial sources are in range      */
+        ilut = cr->vecLut[i];
+        if (ilut < 0) continue;         /* cut branch                        */
+        fx->vecRs[ilut] = OMABS(cr->vecQs0[i]);
+        fx->vecSw[ilut] = (OMABS(cr->vecBtm[i]) == OMTYP_SW);
+    }
+    OmFxpBld(fx);
+    return fx;
+}
+/*========== OmFxpDel ================*//** Function [41]                    */
+void OmFxpDel(OmFxp* fx) {
+    if (fx == NULL) return;             /* check if fx is null pointer       */
+    OMFREE(fx->vecRs ); OMFREE(fx->vecRq ); OMFREE(fx->vecRx );
+    OMFREE(fx->vecRm ); OMFREE(fx->vecFq ); OMFREE(fx->vecFx );
+    OMFREE(fx->vecFm ); OMFREE(fx->matCq ); OMFREE(fx->vecCs );
+    OMFREE(fx->matDq ); OMFREE(fx->vecDs ); OMFREE(fx->matWq );
+    OMFREE(fx->matWs ); OMFREE(fx->vecSw ); OMFREE(fx->vecA1 );
+    OMFREE(fx->vecT1 ); OMFREE(fx->vecA2 ); OMFREE(fx->vecT2 );
+    OMFREE(fx->vecQa ); OMFREE(fx->vecQs ); OMFREE(fx->vecQtp);
+    OMFREE(fx->vecXc ); OMFREE(fx->vecXm );
+    OMFREE(fx);
+}
+/*========== OmFxpRng ================*//** Function [42]                    */
+void OmFxpRng(OmFxp* fx, OmInt br, OmFlt r) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = fx->cir->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    fx->vecRs[ilut] = OMABS(r);
+}
+/*========== OmFxpCal ================*//** Function [43]                    */
+void OmFxpCal(OmFxp* fx) {
+    OmInt i;                            /* used in for-loop                  */
+    OmCir* cr;                          /* double-precision circuit          */
+    OmFlt v;                            /* absolute value                    */
+    cr = fx->cir;
+    for (i=0; i < fx->numC; ++i) {
+        v = OMABS(cr->vecQtp[i]);
+        if (v > fx->vecRq[i]) fx->vecRq[i] = v;
+        v = OMABS(cr->vecQa[i]) + OMABS(cr->vecQs[i]);
+        if (v > fx->vecRq[i]) fx->vecRq[i] = v;
+        v = OMABS(cr->vecXc[i]);
+        if (v > fx->vecRx[i]) fx->vecRx[i] = v;
+    }
+    for (i=0; i < fx->numM; ++i) {
+        v = OMABS(cr->vecXm[i]);
+        if (v > fx->vecRm[i]) fx->vecRm[i] = v;
+    }
+    fx->numCal += 1;
+}
+/*========== OmFxpBld ================*//** Function [44]                    */
+void OmFxpBld(OmFxp* fx) {
+    OmInt b, m, c;                      /* numB, numM, numC                  */
+    OmInt i, j, k, ilut;                /* used in for-loop, lookup value    */
+    OmCir* cr;                          /* double-precision circuit          */
+    OmFlt* rq;                          /* Qtp range used for scaling  [c]   */
+    OmFlt* rx;                          /* Xc range used for scaling   [c]   */
+    OmFlt* rm;                          /* Xm range used for scaling   [m]   */
+    OmFlt* r2;                          /* gain 1 / (1 - |W2|), at most 2 [c]*/
+    OmFlt w[4];                         /* W1c, W2c, W1o, W2o of row         */
+    OmFlt g, sum;                       /* scaled coefficient, sum of |g|    */
+    cr = fx->cir;
+    b = cr->numB;
+    m = fx->numM;
+    c = fx->numC;
+    rq = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    rx = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    rm = (OmFlt*)OMMALLOC((m+1) * sizeof(OmFlt));
+    r2 = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    /*======== Step 0: Ranges, observed or propagated bound =================*/
+    for (i=0; i < b; ++i) {             /* bound of |W1| in rx, of W2 in r2  */
+        ilut = cr->vecLut[i];
+        if (ilut < 0) continue;         /* cut branch                        */
+        rq[ilut] = fx->vecRs[ilut] + OMABS(cr->vecQa0[i]);
+        g = OMABS(cr->vecW1c[i]);
+        rx[ilut] = OMABS(cr->vecW1o[i]) > g ? OMABS(cr->vecW1o[i]) : g;
+        g = OMABS(cr->vecW2c[i]);
+        g = OMABS(cr->vecW2o[i]) > g ? OMABS(cr->vecW2o[i]) : g;
+        r2[ilut] = g < 0.5 ? 1.0 / (1.0 - g) : 2.0;
+    }
+    if (fx->numCal > 0) {               /* use observed ranges               */
+        for (i=0; i < c; ++i) {
+            rq[i] = fx->vecRq[i] > fx->vecRs[i] ? fx->vecRq[i] : fx->vecRs[i];
+            rx[i] = fx->vecRx[i];
+        }
+        for (i=0; i < m; ++i) rm[i] = fx->vecRm[i];
+    } else {                            /* propagate bound through C / W     */
+        for (k=0; k < 8; ++k) {         /* fixed point of the bound, capped  */
+            for (i=0; i < c; ++i) {     /* |Qa| <= |W1| |Xc| / (1 - |W2|)    */
+                sum = 0.0;
+                for (j=0; j < c; ++j) sum += OMABS(cr->matC[i*c+j]) * rq[j];
+                g = rx[i] * sum * r2[i];
+                if (g + fx->vecRs[i] > rq[i]) rq[i] = g + fx->vecRs[i];
+            }
+        }
+        for (i=0; i < c; ++i) {
+            sum = 0.0;
+            for (j=0; j < c; ++j) sum += OMABS(cr->matC[i*c+j]) * rq[j];
+            rx[i] = sum;
+        }
+        for (i=0; i < m; ++i) {
+            sum = 0.0;
+            for (j=0; j < c; ++j) sum += OMABS(cr->matD[i*c+j]) * rq[j];
+            rm[i] = sum;
+        }
+    }
+    /*======== Step 1: Fraction bits of every row ===========================*/
+    for (i=0; i < c; ++i) {
+        fx->vecFq[i] = OmFxpFb(rq[i], 30, -60, 60);
+        fx->vecFx[i] = OmFxpFb(rx[i], 30, -60, 60);
+    }
+    for (i=0; i < m; ++i) fx->vecFm[i] = OmFxpFb(rm[i], 30, -60, 60);
+    /*======== Step 2: Quantize C and D with per-row shift ==================*/
+    fx->numSat = 0;
+    for (i=0; i < c; ++i) {             /* sum |Cq| < 2^31, no int64 overflow*/
+        sum = 0.0;
+        for (j=0; j < c; ++j) {
+            sum += OMABS(cr->matC[i*c+j]) *
+                   OmFxpP2(fx->vecFx[i] - fx->vecFq[j]);
+        }
+        fx->vecCs[i] = OmFxpFb(sum, 31, 0, 62);
+        for (j=0; j < c; ++j) {
+            g = cr->matC[i*c+j] * OmFxpP2(fx->vecFx[i] - fx->vecFq[j]);
+            fx->matCq[i*c+j] = OmFxpQt(fx, g, fx->vecCs[i]);
+        }
+    }
+    for (i=0; i < m; ++i) {
+        sum = 0.0;
+        for (j=0; j < c; ++j) {
+            sum += OMABS(cr->matD[i*c+j]) *
+                   OmFxpP2(fx->vecFm[i] - fx->vecFq[j]);
+        }
+        fx->vecDs[i] = OmFxpFb(sum, 31, 0, 62);
+        for (j=0; j < c; ++j) {
+            g = cr->matD[i*c+j] * OmFxpP2(fx->vecFm[i] - fx->vecFq[j]);
+            fx->matDq[i*c+j] = OmFxpQt(fx, g, fx->vecDs[i]);
+        }
+    }
+    /*======== Step 3: Quantize weights and reset state =====================*/
+    for (i=0; i < b; ++i) {
+        ilut = cr->vecLut[i];
+        if (ilut < 0) continue;         /* cut branch                        */
+        w[0] = fx->vecSw[ilut] ? cr->vecW1c[i] : cr->vecW1o[i];
+        w[1] = fx->vecSw[ilut] ? cr->vecW2c[i] : cr->vecW2o[i];
+        w[2] = cr->vecW1o[i];
+        w[3] = cr->vecW2o[i];
+        w[0] *= OmFxpP2(fx->vecFq[ilut] - fx->vecFx[ilut]);
+        w[2] *= OmFxpP2(fx->vecFq[ilut] - fx->vecFx[ilut]);
+        for (k=0; k < 4; ++k) {         /* |mantissa| < 2^30                 */
+            fx->matWs[ilut*4+k] = OmFxpFb(OMABS(w[k]), 30, 0, 62);
+            fx->matWq[ilut*4+k] = OmFxpQt(fx, w[k], fx->matWs[ilut*4+k]);
+        }
+        fx->vecA1[ilut] = fx->matWq[ilut*4+2];
+        fx->vecT1[ilut] = fx->matWs[ilut*4+2];
+        fx->vecA2[ilut] = fx->matWq[ilut*4+3];
+        fx->vecT2[ilut] = fx->matWs[ilut*4+3];
+        fx->vecQa[ilut] = OmFxpQt(fx, cr->vecQa0[i], fx->vecFq[ilut]);
+        fx->vecQs[ilut] = OmFxpQt(fx, cr->vecQs0[i], fx->vecFq[ilut]);
+        fx->vecQtp[ilut] = OmFxpSt(fx, (OmI64)fx->vecQa[ilut] +
+                                       fx->vecQs[ilut]);
+        fx->vecXc[ilut] = 0;
+    }
+    for (i=0; i < m; ++i) fx->vecXm[i] = 0;
+    fx->errXc = 0.0;
+    fx->errXm = 0.0;
+    OMFREE(rq);
+    OMFREE(rx);
+    OMFREE(rm);
+    OMFREE(r2);
+}
+/*========== OmFxpSetQs ==============*//** Function [45]                    */
+void OmFxpSetQs(OmFxp* fx, OmInt br, OmFlt x) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = fx->cir->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    fx->vecQs[ilut] = OmFxpQt(fx, x, fx->vecFq[ilut]);
+}
+/*========== OmFxpSetSw ==============*//** Function [46]                    */
+void OmFxpSetSw(OmFxp* fx, OmInt br, OmInt s) {
+    OmInt ilut, k;                      /* lookup table value, table column  */
+    ilut = fx->cir->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    k = (s == 0) ? 2 : 0;
+    fx->vecA1[ilut] = fx->matWq[ilut*4+k];
+    fx->vecT1[ilut] = fx->matWs[ilut*4+k];
+    fx->vecA2[ilut] = fx->matWq[ilut*4+k+1];
+    fx->vecT2[ilut] = fx->matWs[ilut*4+k+1];
+}
+/*========== OmFxpStep ===============*//** Helper of Function [48]          */
+static void OmFxpStep(OmFxp* fx, OmInt sw) {
+    OmInt c;                            /* numC                              */
+    OmInt i, j;                         /* used in for-loop                  */
+    OmI64 acc;                          /* 64-bit accumulator                */
+    OmI32* cq;                          /* row of quantized C                */
+    c = fx->numC;
+    for (i=0; i < c; ++i) {
+        fx->vecQtp[i] = OmFxpSt(fx, (OmI64)fx->vecQa[i] + fx->vecQs[i]);
+    }
+    for (i=0; i < c; ++i) {
+        if (sw && !fx->vecSw[i]) continue;
+        acc = 0;
+        cq = fx->matCq + i * c;
+        for (j=0; j < c; ++j) acc += (OmI64)cq[j] * fx->vecQtp[j];
+        fx->vecXc[i] = OmFxpSt(fx, OmFxpSh(acc, fx->vecCs[i]));
+    }
+    for (i=0; i < c; ++i) {
+        if (sw && !fx->vecSw[i]) continue;
+        acc = OmFxpSh((OmI64)fx->vecA1[i] * fx->vecXc[i], fx->vecT1[i])
+            + OmFxpSh((OmI64)fx->vecA2[i] * fx->vecQa[i], fx->vecT2[i]);
+        fx->vecQa[i] = OmFxpSt(fx, acc);
+    }
+}
+/*========== OmFxpUpdSw ==============*//** Function [47]                    */
+void OmFxpUpdSw(OmFxp* fx) {
+    OmFxpStep(fx, 1);
+}
+/*========== OmFxpUpdCr ==============*//** Function [48]                    */
+void OmFxpUpdCr(OmFxp* fx) {
+    OmFxpStep(fx, 0);
+}
+/*========== OmFxpUpdMt ==============*//** Function [49]                    */
+void OmFxpUpdMt(OmFxp* fx) {
+    OmInt m, c;                         /* numM, numC                        */
+    OmInt i, j;                         /* used in for-loop                  */
+    OmI64 acc;                          /* 64-bit accumulator                */
+    m = fx->numM;
+    c = fx->numC;
+    for (i=0; i < m; ++i) {
+        acc = 0;
+        for (j=0; j < c; ++j) acc += (OmI64)fx->matDq[i*c+j] * fx->vecQtp[j];
+        fx->vecXm[i] = OmFxpSt(fx, OmFxpSh(acc, fx->vecDs[i]));
+    }
+}
+/*========== OmFxpGetMt ==============*//** Function [50]                    */
+OmFlt OmFxpGetMt(OmFxp* fx, OmInt mt) {
+    return fx->vecXm[mt-1] * OmFxpP2(-fx->vecFm[mt-1]);
+}
+/*========== OmFxpGetXc ==============*//** Function [51]                    */
+OmFlt OmFxpGetXc(OmFxp* fx, OmInt br) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = fx->cir->vecLut[br-1];
+    if (ilut < 0) return 0.0;           /* cut branch                        */
+    return fx->vecXc[ilut] * OmFxpP2(-fx->vecFx[ilut]);
+}
+/*========== OmFxpCmp ================*//** Function [52]                    */
+void OmFxpCmp(OmFxp* fx) {
+    OmInt i;                            /* used in for-loop                  */
+    OmFlt e;                            /* absolute error                    */
+    for (i=0; i < fx->numC; ++i) {
+        e = fx->vecXc[i] * OmFxpP2(-fx->vecFx[i]) - fx->cir->vecXc[i];
+        if (OMABS(e) > fx->errXc) fx->errXc = OMABS(e);
+    }
+    for (i=0; i < fx->numM; ++i) {
+        e = fx->vecXm[i] * OmFxpP2(-fx->vecFm[i]) - fx->cir->vecXm[i];
+        if (OMABS(e) > fx->errXm) fx->errXm = OMABS(e);
+    }
+}
+#endif                                  /*| #ifdef LIBOHM_FIX               |*/
+/*========== OmStampSz ===============*//** Function [53]                    */
+OmInt OmStampSz(OmCir* cr) {
+    OmInt n, b, m, x;                   /* numN, numB, numM, numX            */
+    OmInt i, s;                         /* used in for-loop, SW-type count   */
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    x = cr->numX;
+    for (i=0, s=0; i < b; ++i) s += OMABS(cr->vecBtm[i]) == OMTYP_SW;
+    return 2 * (n+x) * (n+x) + (n+x) + (n+x) * b + 3 * b * b + m * b + 1
+         + 3 * s * s + 3 * s;           /* ports of tuned switches           */
+}
+typedef struct OmSwq {                  /** Work range of a sweep thread     */
+#ifdef LIBOHM_PTHREAD
+    pthread_mutex_t mtx;                /** Protects lo and hi               */
+    pthread_t thd;                      /** Thread handle                    */
+    OmInt  ok     ;                     /** Thread was created               */
+#endif
+    OmInt  lo     ;                     /** First point not yet taken        */
+    OmInt  hi     ;                     /** One past last point              */
+    OmInt  numF   ;                     /** Number of failed points          */
+    OmInt  numW   ;                     /** Size of scratch arena            */
+    OmFlt* vecW   ;                     /** Scratch arena of OmStampWs()     */
+    struct OmSwj* job;                  /** Shared sweep job                 */
+} OmSwq;
+typedef struct OmSwj {                  /** Shared sweep job                 */
+    OmInt  np, nd, nm, nt;              /** Points, params, meters, threads  */
+    OmFlt* par;                         /** Parameter grid          [np,nd]  */
+    OmFlt* res;                         /** Result table            [np,nm]  */
+    OmBldFn bld;                        /** Builder callback                 */
+    OmRunFn run;                        /** Runner callback                  */
+    void*  usr;                         /** User pointer                     */
+    OmSwq* q;                           /** Per-thread ranges          [nt]  */
+} OmSwj;
+/*========== OmSwpPt =================*//** Helper of Function [56]          */
+static void OmSwpPt(OmSwq* q, OmInt pt) {
+    OmSwj* jb;                          /* shared sweep job                  */
+    OmCir* cr;                          /* circuit of this point             */
+    OmFlt* par;                         /* parameters of this point          */
+    OmFlt* res;                         /* results of this point             */
+    OmInt k, sz;                        /* used in for-loop, scratch size    */
+    jb = q->job;
+    par = jb->par + pt * jb->nd;
+    res = jb->res + pt * jb->nm;
+    for (k=0; k < jb->nm; ++k) res[k] = 0.0;
+    cr = jb->bld(pt, par, jb->usr);
+    if (cr == NULL) { q->numF += 1; return; }
+    if (cr->matC == NULL) {             /* unstamped, stamp with arena       */
+        sz = OmStampSz(cr);
+        if (sz > q->numW) {             /* grow arena, kept for next points  */
+            OMFREE(q->vecW);
+            q->vecW = (OmFlt*)OMMALLOC(sz * sizeof(OmFlt));
+            q->numW = sz;
+        }
+        OmStampWs(cr, q->vecW);
+    }
+    if (jb->run != NULL) jb->run(cr, pt, par, jb->usr);
+    else OmUpdMt(cr);
+    for (k=0; k < jb->nm && k < cr->numM; ++k) res[k] = cr->vecXm[k];
+    OmDelete(cr);
+}
+#ifdef LIBOHM_PTHREAD
+/*========== OmSwpTk =================*//** Helper of Function [56]          */
+static OmInt OmSwpTk(OmSwq* q) {
+    OmSwj* jb;                          /* shared sweep job                  */
+    OmSwq* v;                           /* victim range                      */
+    OmInt i, pt, k;                     /* used in for-loop, point, count    */
+    pt = -1;
+    pthread_mutex_lock(&q->mtx);        /* take from bottom of own range     */
+    if (q->lo < q->hi) pt = q->lo++;
+    pthread_mutex_unlock(&q->mtx);
+    if (pt >= 0) return pt;
+    jb = q->job;
+    for (i=1; i < jb->nt; ++i) {        /* steal upper half from others      */
+        v = jb->q + ((q - jb->q) + i) % jb->nt;
+        pthread_mutex_lock(&v->mtx);
+        k = (v->hi - v->lo) / 2;
+        if (k > 0) {
+            pthread_mutex_lock(&q->mtx);
+            q->lo = v->hi - k;
+            q->hi = v->hi;
+            pt = q->lo++;
+            pthread_mutex_unlock(&q->mtx);
+            v->hi -= k;
+        } else if (v->lo < v->hi) {     /* last point of victim              */
+            pt = v->lo++;
+        }
+        pthread_mutex_unlock(&v->mtx);
+        if (pt >= 0) return pt;
+    }
+    return -1;                          /* all ranges empty, work only drops */
+}
+/*========== OmSwpTh =================*//** Helper of Function [56]          */
+static void* OmSwpTh(void* arg) {
+    OmSwq* q;                           /* own range                         */
+    OmInt pt;                           /* point index                       */
+    q = (OmSwq*)arg;
+    while ((pt = OmSwpTk(q)) >= 0) OmSwpPt(q, pt);
+    return NULL;
+}
+#endif
+/*========== OmSweep =================*//** Function [56]                    */
+OmInt OmSweep(OmInt np, OmInt nd, OmFlt* par, OmInt nm, OmFlt* res,
+              OmBldFn bld, OmRunFn run, void* usr, OmInt nt) {
+    OmSwj jb;                           /* shared sweep job                  */
+    OmInt i, nf;                        /* used in for-loop, failed points   */
+#ifndef LIBOHM_PTHREAD
+    nt = 1;                             /* no threads without pthread        */
+#endif
+    if (nt < 1) nt = 1;
+    if (nt > np) nt = np > 0 ? np : 1;
+    jb.np = np; jb.nd = nd; jb.nm = nm; jb.nt = nt;
+    jb.par = par; jb.res = res;
+    jb.bld = bld; jb.run = run; jb.usr = usr;
+    jb.q = (OmSwq*)OMMALLOC(nt * sizeof(OmSwq));
+    for (i=0; i < nt; ++i) {            /* contiguous initial ranges         */
+        jb.q[i].lo   = (OmInt)(((long)np * i) / nt);
+        jb.q[i].hi   = (OmInt)(((long)np * (i+1)) / nt);
+        jb.q[i].numF = 0;
+        jb.q[i].numW = 0;
+        jb.q[i].vecW = NULL;
+        jb.q[i].job  = &jb;
+    }
+#ifdef LIBOHM_PTHREAD
+    for (i=0; i < nt; ++i) pthread_mutex_init(&jb.q[i].mtx, NULL);
+    for (i=1; i < nt; ++i) {            /* thread 0 is the calling thread    */
+        jb.q[i].ok = pthread_create(&jb.q[i].thd, NULL, OmSwpTh,
+                                    jb.q + i) == 0;
+    }
+    OmSwpTh(jb.q);                      /* also steals ranges of failed ones */
+    for (i=1; i < nt; ++i) {
+        if (jb.q[i].ok) pthread_join(jb.q[i].thd, NULL);
+    }
+    for (i=0; i < nt; ++i) pthread_mutex_destroy(&jb.q[i].mtx);
+#else
+    for (i=0; i < np; ++i) OmSwpPt(jb.q, i);
+#endif
+    nf = 0;
+    for (i=0; i < nt; ++i) {
+        nf += jb.q[i].numF;
+        OMFREE(jb.q[i].vecW);
+    }
+    OMFREE(jb.q);
+    return nf;
+}
+/*========== OmSymNew ================*//** Function [57]                    */
+OmSym* OmSymNew(OmCir* cr) {
+    OmInt n, b, x;                      /* numN, numB, numX                  */
+    OmInt i, j, t, z, nz;               /* used in for-loop, nonzero count   */
+    OmInt tp[4];                        /* target index in Pn                */
+    OmFlt ts[4];                        /* target sign in Pn                 */
+    OmSym* sy;                          /* new symbolic analysis             */
+    if (cr == NULL || cr->matC != NULL) return NULL;
+    n = cr->numN;
+    b = cr->numB;
+    x = cr->numX;
+    /*======== Step 0: Allocate struct and copy X/Y lookup table ============*/
+    sy = (OmSym*)OMMALLOC(sizeof(OmSym));
+    sy->cir    = cr;
+    sy->numF   = 0;
+    sy->vecLux = (OmInt*)OMMALLOC((b+1) * sizeof(OmInt));
+    for (i=0; i < b; ++i) sy->vecLux[i] = cr->vecLut[i];
+    /*======== Step 1: Scatter pattern of nonzeros of Pb ====================*/
+    z = 0;
+    for (i=0; i < b * b; ++i) z += (cr->matPb[i] != 0.0);
+    sy->numZ   = z;
+    sy->vecZb  = (OmInt*)OMMALLOC((z+1) * sizeof(OmInt));
+    sy->vecZp  = (OmInt*)OMMALLOC((4*z+1) * sizeof(OmInt));
+    sy->vecZs  = (OmFlt*)OMMALLOC((4*z+1) * sizeof(OmFlt));
+    z = 0;
+    for (i=0; i < b; ++i) {
+        for (j=0; j < b; ++j) {
+            if (cr->matPb[i*b+j] == 0.0) continue;
+            nz = OmStmMap(cr, sy->vecLux, i, j, tp, ts);
+            sy->vecZb[z] = i*b+j;
+            for (t=0; t < 4; ++t) {     /* unused target adds zero to Pn[0]  */
+                sy->vecZp[z*4+t] = t < nz ? tp[t] : 0;
+                sy->vecZs[z*4+t] = t < nz ? ts[t] : 0.0;
+            }
+            z += 1;
+        }
+    }
+    /*======== Step 2: Incidence part, pivot order and workspace ============*/
+    sy->matPn0 = (OmFlt*)OMMALLOC(((n+x)*(n+x)+1) * sizeof(OmFlt));
+    sy->vecPv  = (OmInt*)OMMALLOC((2*(n+x)+1) * sizeof(OmInt));
+    sy->vecW   = (OmFlt*)OMMALLOC(OmStampSz(cr) * sizeof(OmFlt));
+    OmStmPn0(cr, sy->vecLux, sy->matPn0);
+    OmStmPn(cr, sy->vecLux, sy->vecW);
+    OmMatPiv(n+x, sy->vecW, sy->vecPv);
+    /*======== Step 3: Stamp and keep setup members =========================*/
+    OmStmRun(cr, sy->vecW, 1);
+    return sy;
+}
+/*========== OmSymDel ================*//** Function [58]                    */
+void OmSymDel(OmSym* sy) {
+    if (sy == NULL) return;             /* check if sy is null pointer       */
+    OMFREE(sy->vecLux);
+    OMFREE(sy->vecZb );
+    OMFREE(sy->vecZp );
+    OMFREE(sy->vecZs );
+    OMFREE(sy->matPn0);
+    OMFREE(sy->vecPv );
+    OMFREE(sy->vecW  );
+    OMFREE(sy);
+}
+/*========== OmClear =================*//** Function [59]                    */
+void OmClear(OmCir* cr) {
+    OmInt b;                            /* numB                              */
+    OmInt i, btyp;                      /* used in for-loop, branch type     */
+    b = cr->numB;
+    for (i=0; i < b * b; ++i) {
+        cr->matPa[i] = 0.0;
+        cr->matPb[i] = 0.0;
+    }
+    for (i=0; i < b; ++i) {
+        cr->vecW1c[i] = 0.0;
+        cr->vecW2c[i] = 0.0;
+        cr->vecW1o[i] = 0.0;
+        cr->vecW2o[i] = 0.0;
+        cr->vecQa0[i] = 0.0;
+        cr->vecQs0[i] = 0.0;
+        cr->vecW3b[i] = 0.0;
+        cr->vecW4b[i] = 0.0;
+        cr->vecW5b[i] = 0.0;
+        cr->vecQb0[i] = 0.0;
+        cr->vecTa [i] = 0;
+        cr->vecTg [i] = 0.0;
+        cr->vecTr [i] = 0.0;
+        btyp = OMABS(cr->vecBtm[i]);    /* same as OmBran()                  */
+        if (btyp != OMTYP_X3 && btyp != OMTYP_Y3) cr->matPa[i*b+i] = 1.0;
+    }
+}
+/*========== OmRstPiv ================*//** Helper of Function [60]          */
+static OmInt OmRstPiv(OmSym* sy, OmInt m, OmFlt* pn) {
+    OmInt* pv;                          /* new pivot order [m]               */
+    OmInt i, d;                         /* used in for-loop, order changed   */
+    pv = sy->vecPv + m;
+    OmMatPiv(m, pn, pv);                /* same search as OmMatInvWs()       */
+    d = 0;
+    for (i=0; i < m; ++i) {
+        d |= pv[i] != sy->vecPv[i];
+        sy->vecPv[i] = pv[i];
+    }
+    return d;
+}
+/*========== OmRestamp ===============*//** Function [60]                    */
+OmInt OmRestamp(OmSym* sy) {
+    OmInt n, b, x;                      /* numN, numB, numX                  */
+    OmInt i, t, z, fb;                  /* used in for-loop, fallback flag   */
+    OmInt it;                           /* switch tuning pass                */
+    OmCir* cr;                          /* circuit to be restamped           */
+    OmFlt* pn;                          /* node conductance matrix [n+x,n+x] */
+    OmFlt k;                            /* used as factor / coefficient      */
+    cr = sy->cir;
+    n = cr->numN;
+    b = cr->numB;
+    x = cr->numX;
+    pn = sy->vecW;
+    /*======== Step 0: Stamp Pb to Pn with cached pattern ===================*/
+    OmStmAg(cr);
+    fb = 0;
+    for (i=0; i < (n+x) * (n+x); ++i) pn[i] = sy->matPn0[i];
+    z = 0;
+    for (i=0; i < b * b; ++i) {         /* vecZb is sorted, walk it along    */
+        k = cr->matPb[i];
+        if (z < sy->numZ && sy->vecZb[z] == i) {
+            for (t=0; t < 4; ++t) pn[sy->vecZp[z*4+t]] += sy->vecZs[z*4+t] * k;
+            z += 1;
+        } else if (k != 0.0) {          /* pattern changed                   */
+            fb = 1;
+        }
+    }
+    if (fb) OmStmPn(cr, sy->vecLux, pn);
+    /*======== Step 1: Refactor, fall back if pivot order changed ===========*/
+    fb |= OmRstPiv(sy, n+x, pn);
+    OmMatLuInv(n+x, pn, pn + (n+x)*(n+x), sy->vecPv, 0.0);
+    /*======== Step 2: Refill matC / matD and reset =========================*/
+    OmStmTp(cr, sy->vecLux, pn);
+    for (it=0; it < 8 && OmStmSw(cr, pn, 1); ++it) {
+        OmStmPn(cr, sy->vecLux, pn);    /* stamp again with tuned switches   */
+        fb |= OmRstPiv(sy, n+x, pn);
+        OmMatLuInv(n+x, pn, pn + (n+x)*(n+x), sy->vecPv, 0.0);
+        OmStmTp(cr, sy->vecLux, pn);
+    }
+    if (it == 8) OmStmSw(cr, pn, 0);
+    OmStmCut(cr, pn);
+    if (cr->vecCp != NULL) OmSparse(cr, -1.0);
+    if (cr->vecSr != NULL) OmSsx(cr, -1, NULL);
+    OmReset(cr);
+    sy->numF += fb;
+    return fb;
+}
+/*========== OmStdPer ================*//** Helper of Function [61]          */
+static void OmStdPer(OmCir* cr, OmInt np, OmStpFn fn, void* usr,
+                     OmFlt* snp, OmFlt* q, OmFlt* f) {
+    OmInt c;                            /* numC                              */
+    OmInt i, k;                         /* used in for-loop                  */
+    c = cr->numC;
+    for (i=0; i < c; ++i) {             /* restore period start, Qa = q      */
+        cr->vecQs [i] = snp[0*c+i];
+        cr->vecW1m[i] = snp[1*c+i];
+        cr->vecW2m[i] = snp[2*c+i];
+        cr->vecW1s[i] = snp[3*c+i];
+        cr->vecW2s[i] = snp[4*c+i];
+        cr->vecQa [i] = q[i];
+    }
+    for (k=0; k < np; ++k) {
+        fn(cr, k, usr);
+        OmUpdCr(cr);
+    }
+    for (i=0; i < c; ++i) f[i] = cr->vecQa[i];
+}
+/*========== OmSteady ================*//** Function [61]                    */
+OmInt OmSteady(OmCir* cr, OmInt np, OmStpFn fn, void* usr, OmFlt tol,
+               OmInt itm) {
+    OmInt c, k;                         /* numC, number of state rows        */
+    OmInt i, j, it;                     /* used in for-loop, iteration       */
+    OmFlt h, r, qm;                     /* perturbation, residual, |q| max   */
+    OmFlt* snp;                         /* Qs, W1m, W2m, W1s, W2s, Qa [6,c]  */
+    OmFlt* q0;                          /* Qa at period start          [c]   */
+    OmFlt* f0;                          /* Qa at period end            [c]   */
+    OmFlt* qj;                          /* perturbed Qa / its image    [c]   */
+    OmFlt* am;                          /* I - M, then its inverse     [k,k] */
+    OmInt* rs;                          /* rows of state, W1m | W2m != 0 [k] */
+    c = cr->numC;
+    if (cr->vecQb != NULL) return -1;   /* period map also acts on Qb        */
+    /*======== Step 0: Run one period and take snapshot =====================*/
+    snp = (OmFlt*)OMMALLOC((6*c+1) * sizeof(OmFlt));
+    q0  = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    f0  = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    qj  = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    am  = (OmFlt*)OMMALLOC((c*c+1) * sizeof(OmFlt));
+    rs  = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    for (i=0; i < np; ++i) {
+        fn(cr, i, usr);
+        OmUpdCr(cr);
+    }
+    for (i=0; i < c; ++i) {
+        snp[0*c+i] = cr->vecQs [i];
+        snp[1*c+i] = cr->vecW1m[i];
+        snp[2*c+i] = cr->vecW2m[i];
+        snp[3*c+i] = cr->vecW1s[i];
+        snp[4*c+i] = cr->vecW2s[i];
+        snp[5*c+i] = cr->vecQa [i];
+        q0[i] = cr->vecQa[i];
+    }
+    k = 0;
+    for (i=0; i < c; ++i) {             /* other rows end a period at zero   */
+        if (cr->vecW1m[i] != 0.0 || cr->vecW2m[i] != 0.0) rs[k++] = i;
+    }
+    /*======== Step 1: Newton iteration on Qa(0) = Phi(Qa(0)) ===============*/
+    for (it=0; it <= itm; ++it) {
+        OmStdPer(cr, np, fn, usr, snp, q0, f0);
+        r = 0.0;
+        qm = 1.0;
+        for (i=0; i < c; ++i) {
+            if (OMABS(f0[i] - q0[i]) > r) r = OMABS(f0[i] - q0[i]);
+            if (OMABS(q0[i]) > qm) qm = OMABS(q0[i]);
+        }
+        if (r != r) break;              /* NaN, I - M is singular            */
+        if (r <= tol * qm) {            /* converged, leave cr at Qa = q0    */
+            OmStdPer(cr, 0, fn, usr, snp, q0, f0);
+            OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
+            OMFREE(snp); OMFREE(q0); OMFREE(f0); OMFREE(qj); OMFREE(am);
+            OMFREE(rs);
+            return it;
+        }
+        if (it == itm) break;
+        for (j=0; j < k; ++j) {         /* column j of I - M on state rows   */
+            for (i=0; i < c; ++i) qj[i] = q0[i];
+            h = 1e-3 * (OMABS(q0[rs[j]]) > 1.0 ? OMABS(q0[rs[j]]) : 1.0);
+            qj[rs[j]] += h;
+            OmStdPer(cr, np, fn, usr, snp, qj, qj);
+            for (i=0; i < k; ++i) am[i*k+j] = -(qj[rs[i]] - f0[rs[i]]) / h;
+            am[j*k+j] += 1.0;
+        }
+        OmMatInv(k, am);
+        for (i=0; i < c; ++i) qj[i] = f0[i];
+        for (i=0; i < k; ++i) {         /* q0 += (I - M)^-1 (f0 - q0)        */
+            h = 0.0;
+            for (j=0; j < k; ++j) h += am[i*k+j] * (f0[rs[j]] - q0[rs[j]]);
+            qj[rs[i]] = q0[rs[i]] + h;
+        }
+        for (i=0; i < c; ++i) q0[i] = qj[i];
+    }
+    OmStdPer(cr, 0, fn, usr, snp, snp + 5*c, f0);
+    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
+    OMFREE(snp); OMFREE(q0); OMFREE(f0); OMFREE(qj); OMFREE(am);
+    OMFREE(rs);
+    return -1;
+}
+/*========== OmInitDC ================*//** Function [62]                    */
+OmInt OmInitDC(OmCir* cr) {
+    OmInt c;                            /* numC                              */
+    OmInt i, j;                         /* used in for-loop                  */
+    OmFlt s;                            /* used to store summation value     */
+    OmFlt* am;                          /* I - W1m C - W2m, inverse, LU      */
+    OmFlt* y;                           /* W1m C Qs, then new Qa       [c]   */
+    OmInt* pm;                          /* pivot row order             [c]   */
+    OmInt sg;                           /* tiny pivot, singular system       */
+    c = cr->numC;
+    if (cr->vecQb != NULL) return -1;   /* equilibrium also involves Qb      */
+    am = (OmFlt*)OMMALLOC((2*c*c+1) * sizeof(OmFlt));
+    y  = (OmFlt*)OMMALLOC((2*c+1) * sizeof(OmFlt));
+    pm = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    for (i=0; i < c; ++i) {
+        s = 0.0;
+        for (j=0; j < c; ++j) {
+            am[i*c+j] = -cr->vecW1m[i] * cr->matC[i*c+j];
+            s += cr->matC[i*c+j] * cr->vecQs[j];
+        }
+        am[i*c+i] += 1.0 - cr->vecW2m[i];
+        y[i] = cr->vecW1m[i] * s;
+    }
+    OmMatPiv(c, am, pm);                /* relative pivot check, am is kept  */
+    sg = OmMatLuInv(c, am, am + c*c, pm, 1e-12);
+    if (!sg) {
+        OmVecMul(c, c, y + c, am, y);
+        for (i=0; i < c; ++i) cr->vecQa[i] = y[c+i];
+        OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
+        OmVecMul(c, c, cr->vecXc, cr->matC, cr->vecQtp);
+    }
+    OMFREE(am);
+    OMFREE(y);
+    OMFREE(pm);
+    return sg ? -1 : 0;
+}
+/*========== OmSnpSz =================*//** Function [63]                    */
+OmInt OmSnpSz(OmCir* cr) {
+    if (cr->vecQb != NULL) return 9 * cr->numC + cr->numM + cr->numA + 1;
+    return 8 * cr->numC + cr->numM + cr->numA + 1;
+}
+/*========== OmSave ==================*//** Function [64]                    */
+void OmSave(OmCir* cr, OmFlt* sv) {
+    OmInt m, c;                         /* numM, numC                        */
+    OmInt i;                            /* used in for-loop                  */
+    m = cr->numM;
+    c = cr->numC;
+    for (i=0; i < c; ++i) {
+        sv[0*c+i] = cr->vecQa [i];
+        sv[1*c+i] = cr->vecQs [i];
+        sv[2*c+i] = cr->vecQtp[i];
+        sv[3*c+i] = cr->vecXc [i];
+        sv[4*c+i] = cr->vecW1m[i];
+        sv[5*c+i] = cr->vecW2m[i];
+        sv[6*c+i] = cr->vecW1s[i];
+        sv[7*c+i] = cr->vecW2s[i];
+    }
+    for (i=0; i < m; ++i) sv[8*c+i] = cr->vecXm[i];
+    for (i=0; i < cr->numA; ++i) sv[8*c+m+i] = cr->vecAs[i];
+    if (cr->vecQb == NULL) return;      /* no BDF2 branch                    */
+    for (i=0; i < c; ++i) sv[8*c+m+cr->numA+i] = cr->vecQb[i];
+}
+/*========== OmRestore ===============*//** Function [65]                    */
+void OmRestore(OmCir* cr, OmFlt* sv) {
+    OmInt m, c;                         /* numM, numC                        */
+    OmInt i;                            /* used in for-loop                  */
+    m = cr->numM;
+    c = cr->numC;
+    for (i=0; i < c; ++i) {
+        cr->vecQa [i] = sv[0*c+i];
+        cr->vecQs [i] = sv[1*c+i];
+        cr->vecQtp[i] = sv[2*c+i];
+        cr->vecXc [i] = sv[3*c+i];
+        cr->vecW1m[i] = sv[4*c+i];
+        cr->vecW2m[i] = sv[5*c+i];
+        cr->vecW1s[i] = sv[6*c+i];
+        cr->vecW2s[i] = sv[7*c+i];
+    }
+    for (i=0; i < m; ++i) cr->vecXm[i] = sv[8*c+i];
+    for (i=0; i < cr->numA; ++i) cr->vecAs[i] = (OmInt)sv[8*c+m+i];
+    if (cr->vecQb == NULL) return;      /* no BDF2 branch                    */
+    for (i=0; i < c; ++i) cr->vecQb[i] = sv[8*c+m+cr->numA+i];
+}
+/*========== OmEvSeg =================*//** Helper of Function [66]          */
+static void OmEvSeg(OmCir* cr, OmFlt f, OmFlt* ws) {
+    OmInt c;                            /* numC                              */
+    OmInt i;                            /* used in for-loop                  */
+    OmFlt* qa;                          /* Qa at segment start         [c]   */
+    OmFlt* qt;                          /* Qtp at segment start        [c]   */
+    OmFlt* xc;                          /* Xc at segment start         [c]   */
+    OmFlt* qb;                          /* Qb at segment start         [c]   */
+    c = cr->numC;
+    qa = ws;
+    qt = ws + c;
+    xc = ws + 2 * c;
+    qb = cr->vecQb != NULL ? ws + 3 * c : NULL;
+    for (i=0; i < c; ++i) {             /* step one timStp, keep fraction f  */
+        qa[i] = cr->vecQa[i];
+        qt[i] = cr->vecQtp[i];
+        xc[i] = cr->vecXc[i];
+        if (qb != NULL) qb[i] = cr->vecQb[i];
+    }
+    OmUpdCr(cr);
+    for (i=0; i < c; ++i) {
+        cr->vecQa [i] = qa[i] + f * (cr->vecQa [i] - qa[i]);
+        cr->vecQtp[i] = qt[i] + f * (cr->vecQtp[i] - qt[i]);
+        cr->vecXc [i] = xc[i] + f * (cr->vecXc [i] - xc[i]);
+        if (qb != NULL) cr->vecQb[i] = qb[i] + f * (cr->vecQb[i] - qb[i]);
+    }
+}
+/*========== OmEvStep ================*//** Helper of Function [66]          */
+static void OmEvStep(OmCir* cr, OmInt ne, OmInt* eb, OmInt* es, OmFlt a,
+                     OmInt nsw, OmFlt* ws) {
+    OmInt i;                            /* used in for-loop                  */
+    if (a < 0.0) a = 0.0;
+    if (a > 1.0) a = 1.0;
+    /*======== Step 0: Step with old state, interpolate to event ============*/
+    OmEvSeg(cr, a, ws);
+    /*======== Step 1: Switch at event and step one timStp ==================*/
+    for (i=0; i < ne; ++i) OmSetSw(cr, eb[i], es[i]);
+    for (i=0; i < nsw; ++i) OmUpdSw(cr);
+    /*======== Step 2: Interpolate back to step end =========================*/
+    OmEvSeg(cr, 1.0 - a, ws);
+}
+/*========== OmUpdEv =================*//** Function [66]                    */
+void OmUpdEv(OmCir* cr, OmInt br, OmInt s, OmFlt a, OmInt nsw, OmFlt* ws) {
+    OmEvStep(cr, 1, &br, &s, a, nsw, ws);
+}
+/*========== OmAddCm =================*//** Helper of Function [67]          */
+static void OmAddCm(OmCir* cr, OmInt bs, OmInt rt, OmFlt von, OmFlt ioff) {
+    OmInt b;                            /* numB                              */
+    OmInt i;                            /* used in for-loop                  */
+    b = cr->numB;
+    if (cr->vecAb == NULL) {            /* first rule, allocate for [b]      */
+        cr->vecAb = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+        cr->vecAt = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+        cr->vecAs = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+        cr->vecAe = (OmInt*)OMMALLOC(b * sizeof(OmInt));
+        cr->vecAg = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+        cr->vecAv = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+        cr->vecAi = (OmFlt*)OMMALLOC(b * sizeof(OmFlt));
+    }
+    for (i=0; i < cr->numA; ++i) {      /* update rule of same branch        */
+        if (cr->vecAb[i] == bs - 1) break;
+    }
+    if (i == cr->numA) cr->numA += 1;
+    cr->vecAb[i] = bs - 1;
+    cr->vecAt[i] = rt;
+    cr->vecAs[i] = 0;
+    cr->vecAe[i] = 0;
+    cr->vecAg[i] = 0.0;                 /* read from Pb at stamp time        */
+    cr->vecAv[i] = von;
+    cr->vecAi[i] = ioff;
+}
+/*========== OmAddD ==================*//** Function [67]                    */
+void OmAddD(OmCir* cr, OmInt bs, OmFlt von, OmFlt ioff) {
+    OmAddCm(cr, bs, OMCMT_DI, von, ioff);
+}
+/*========== OmAddT ==================*//** Function [68]                    */
+void OmAddT(OmCir* cr, OmInt bs, OmFlt von, OmFlt ioff) {
+    OmAddCm(cr, bs, OMCMT_TH, von, ioff);
+}
+/*========== OmSetGt =================*//** Function [69]                    */
+void OmSetGt(OmCir* cr, OmInt bs, OmInt g) {
+    OmInt i;                            /* used in for-loop                  */
+    for (i=0; i < cr->numA; ++i) {
+        if (cr->vecAb[i] == bs - 1) cr->vecAe[i] = g;
+    }
+}
+/*========== OmCmPass ================*//** Helper of Function [70]          */
+static OmInt OmCmPass(OmCir* cr) {
+    OmInt i, br, ilut, s, nc;           /* used in for-loop, changes         */
+    OmFlt v, cur;                       /* branch voltage and current        */
+    nc = 0;
+    for (i=0; i < cr->numA; ++i) {
+        br = cr->vecAb[i];
+        ilut = cr->vecLut[br];
+        if (ilut < 0) continue;         /* cut branch                        */
+        v = cr->vecXc[ilut];
+        cur = cr->vecAg[i] * v + cr->vecQtp[ilut];
+        s = cr->vecAs[i];
+        if (s) {                        /* closed: open on low current       */
+            s = !(cur < cr->vecAi[i]);
+        } else {                        /* open: close on forward voltage    */
+            s = v > cr->vecAv[i];
+            if (cr->vecAt[i] == OMCMT_TH) s = s && cr->vecAe[i];
+        }
+        if (s == cr->vecAs[i]) continue;
+        cr->vecAs[i] = s;
+        cr->vecW1m[ilut] = s ? cr->vecW1c[br] : cr->vecW1o[br];
+        cr->vecW2m[ilut] = s ? cr->vecW2c[br] : cr->vecW2o[br];
+        cr->vecW1s[ilut] = cr->vecW1m[ilut];
+        cr->vecW2s[ilut] = cr->vecW2m[ilut];
+        nc += 1;
+    }
+    return nc;
+}
+/*========== OmUpdCm =================*//** Function [70]                    */
+OmInt OmUpdCm(OmCir* cr, OmInt nsw) {
+    OmInt k, nc, tot;                   /* settle count left, changes        */
+    OmInt r;                            /* restarts of settling              */
+    nc = OmCmPass(cr);
+    tot = nc;
+    k = nc > 0 ? nsw : 0;
+    r = 0;
+    while (k > 0) {                     /* settle, then check again          */
+        OmUpdSw(cr);
+        nc = OmCmPass(cr);
+        tot += nc;
+        k = (nc > 0 && ++r <= cr->numA) ? nsw : k - 1;
+    }
+    return tot;
+}
+typedef struct OmNlr {                  /** Record of netlist (binary unit)  */
+    OmInt  vi[5]  ;                     /** Op letter and integer fields     */
+    OmFlt  vf[4]  ;                     /** Float fields                     */
+} OmNlr;
+typedef struct OmNlp {                  /** Streaming netlist parser         */
+    FILE*  fp     ;                     /** Input file                       */
+    char*  buf    ;                     /** Read chunk           [OMNL_BUF]  */
+    OmInt  pos    ;                     /** Read position in chunk           */
+    OmInt  len    ;                     /** Valid bytes in chunk             */
+    OmInt  pend   ;                     /** Pushed back char (0 if none)     */
+    OmInt  lin    ;                     /** Current line (1-based)           */
+    OmInt  err    ;                     /** Line of first error (0 if none)  */
+    OmInt  numR   ;                     /** Number of records                */
+    OmInt  capR   ;                     /** Capacity of records              */
+    OmNlr* rec    ;                     /** Records                   [capR] */
+    OmInt* lns    ;                     /** Line of each record       [capR] */
+    OmInt  n, b, m;                     /** Largest node, branch and meter   */
+    char   tok[64];                     /** Current token                    */
+} OmNlp;
+/*========== OmNlCh ==================*//** Helper of Function [71]          */
+static OmInt OmNlCh(OmNlp* p) {
+    if (p->pos == p->len) {             /* refill chunk                      */
+        p->len = (OmInt)fread(p->buf, 1, OMNL_BUF, p->fp);
+        p->pos = 0;
+        if (p->len <= 0) {
+            p->len = 0;
+            return EOF;
+        }
+    }
+    return (unsigned char)p->buf[p->pos++];
+}
+/*========== OmNlTok =================*//** Helper of Function [71]          */
+static OmInt OmNlTok(OmNlp* p) {
+    OmInt ch, k;                        /* current char, token length        */
+    ch = p->pend ? p->pend : OmNlCh(p);
+    p->pend = 0;
+    while (ch != EOF && ch != '\n' && (ch <= ' ' || ch == ',')) {
+        ch = OmNlCh(p);
+    }
+    if (ch == ';') {                    /* comment to end of line            */
+        while (ch != EOF && ch != '\n') ch = OmNlCh(p);
+    }
+    if (ch == '\n') {
+        p->lin += 1;
+        return 0;
+    }
+    if (ch == EOF) return -1;
+    for (k=0; ch > ' ' && ch != ',' && ch != ';'; ++k) {
+        if (k < 63) p->tok[k] = (char)ch;
+        ch = OmNlCh(p);
+    }
+    p->pend = ch;
+    if (k > 63) return -2;              /* token too long                    */
+    p->tok[k] = '\0';
+    return k;
+}
+/*========== OmNlUp ==================*//** Helper of Function [71]          */
+static OmInt OmNlUp(OmInt c) {
+    return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+}
+/*========== OmNlNum =================*//** Helper of Function [71]          */
+static OmInt OmNlNum(const char* s, OmFlt* v) {
+    char* e;                            /* end of number                     */
+    OmInt c, c1, c2;                    /* suffix letters (upper case)       */
+    *v = strtod(s, &e);
+    if (e == s) return 1;
+    c = OmNlUp(e[0]);
+    c1 = c ? OmNlUp(e[1]) : 0;
+    c2 = c1 ? OmNlUp(e[2]) : 0;
+    switch (c) {                        /* SPICE scale suffix                */
+        case 'T': *v *= 1e12; break;
+        case 'G': *v *= 1e9; break;
+        case 'K': *v *= 1e3; break;
+        case 'U': *v *= 1e-6; break;
+        case 'N': *v *= 1e-9; break;
+        case 'P': *v *= 1e-12; break;
+        case 'F': *v *= 1e-15; break;
+        case 'M':
+            if (c1 == 'E' && c2 == 'G') *v *= 1e6;
+            else if (c1 == 'I' && c2 == 'L') *v *= 25.4e-6;
+            else *v *= 1e-3;
+            break;
+        default: break;
+    }
+    for (; *e != '\0'; ++e) {           /* rest must be a unit name          */
+        c = OmNlUp(*e);
+        if (c < 'A' || c > 'Z') return 1;
+    }
+    return 0;
+}
+/*========== OmNlInt =================*//** Helper of Function [71]          */
+static OmInt OmNlInt(const char* s, OmInt* v) {
+    char* e;                            /* end of number                     */
+    *v = (OmInt)strtol(s, &e, 10);
+    return e == s || *e != '\0';
+}
+/*========== OmNlTyp =================*//** Helper of Function [71]          */
+static OmInt OmNlTyp(const char* s, OmInt* v) {
+    static const char tn[] = "UNX0X1X2X3Y0Y1Y2Y3SW";
+    OmInt k, sg;                        /* used in for-loop, method sign     */
+    sg = (s[0] == '-') ? -1 : 1;
+    if (s[0] == '-' || s[0] == '+') s += 1;
+    if (s[0] >= '0' && s[0] <= '9') {   /* numeric OMTYP_ value              */
+        if (OmNlInt(s, &k)) return 1;
+    } else {                            /* name like Y2 or SW                */
+        for (k=OMTYP_X0; k <= OMTYP_SW; ++k) {
+            if (OmNlUp(s[0]) == tn[2*k] && OmNlUp(s[1]) == tn[2*k+1]
+                && s[2] == '\0') break;
+        }
+    }
+    *v = sg * k;
+    return k < OMTYP_X0 || k > OMTYP_SW;
+}
+/*========== OmNlAr ==================*//** Helper of Function [71]          */
+static OmInt OmNlAr(OmInt op, OmInt* ni, OmInt* nf, OmInt* no) {
+    *no = 0;
+    switch (op) {                       /* integer, float, optional float    */
+        case 'b': *ni = 4; *nf = 0; break;
+        case 'v': *ni = 3; *nf = 0; break;
+        case 'a': *ni = 2; *nf = 0; break;
+        case 'X': case 'Y': case 'V': case 'I':
+            *ni = 1; *nf = 1; break;
+        case 'L': case 'C': case 'Q': case 'P':
+            *ni = 1; *nf = 2; *no = 1; break;
+        case 'E': case 'H': case 'F': case 'G':
+            *ni = 2; *nf = 1; break;
+        case 'M': case 'N': case 'A': case 'B':
+            *ni = 2; *nf = 2; *no = 1; break;
+        case 'S': *ni = 1; *nf = 4; break;
+        case 'D': case 'T':
+            *ni = 1; *nf = 2; *no = 2; break;
+        default: return 1;
+    }
+    return 0;
+}
+/*========== OmNlEq ==================*//** Helper of Function [71]          */
+static OmInt OmNlEq(const char* s, const char* u) {
+    for (; *u != '\0'; ++s, ++u) {
+        if (OmNlUp(*s) != *u) return 0;
+    }
+    return *s == '\0';
+}
+/*========== OmNlPush ================*//** Helper of Function [71]          */
+static OmInt OmNlPush(OmNlp* p, OmNlr* r, OmInt ln) {
+    OmNlr* rec;                         /* grown records                     */
+    OmInt* lns;                         /* grown lines                       */
+    OmInt k, cap;                       /* used in for-loop, new capacity    */
+    if (p->numR == p->capR) {
+        cap = p->capR ? 2 * p->capR : 1024;
+        rec = (OmNlr*)OMMALLOC(cap * sizeof(OmNlr));
+        lns = (OmInt*)OMMALLOC(cap * sizeof(OmInt));
+        if (rec == NULL || lns == NULL) {
+            OMFREE(rec);
+            OMFREE(lns);
+            return 1;
+        }
+        for (k=0; k < p->numR; ++k) {
+            rec[k] = p->rec[k];
+            lns[k] = p->lns[k];
+        }
+        OMFREE(p->rec);
+        OMFREE(p->lns);
+        p->rec = rec;
+        p->lns = lns;
+        p->capR = cap;
+    }
+    p->rec[p->numR] = *r;
+    p->lns[p->numR] = ln;
+    p->numR += 1;
+    return 0;
+}
+/*========== OmNlLine ================*//** Helper of Function [71]          */
+static OmInt OmNlLine(OmNlp* p, OmInt ln) {
+    OmNlr r;                            /* record of this line               */
+    OmInt k, t, op, ni, nf, no;         /* used in for-loop, token, arity    */
+    OmInt* v;                           /* integer fields                    */
+    if (p->tok[0] == '*') {             /* comment line                      */
+        while ((t = OmNlTok(p)) > 0) continue;
+        return t == -2;
+    }
+    if (p->tok[0] == '.') {             /* directive                         */
+        if (OmNlEq(p->tok + 1, "END")) return 2;
+        op = OmNlEq(p->tok + 1, "BR") ? 'b'
+           : OmNlEq(p->tok + 1, "MV") ? 'v'
+           : OmNlEq(p->tok + 1, "MA") ? 'a' : 0;
+    } else {                            /* element, rest of name is a label  */
+        op = OmNlUp(p->tok[0]);
+    }
+    if (OmNlAr(op, &ni, &nf, &no)) return 1;
+    r.vi[0] = op;
+    v = r.vi + 1;
+    for (k=0; k < 4; ++k) v[k] = 0;
+    for (k=0; k < 4; ++k) r.vf[k] = 0.0;
+    t = 1;
+    for (k=0; k < ni; ++k) {
+        if (OmNlTok(p) <= 0) return 1;
+        if (op == 'b' && k == 3) {
+            if (OmNlTyp(p->tok, v + k)) return 1;
+        } else {
+            if (OmNlInt(p->tok, v + k)) return 1;
+        }
+    }
+    for (k=0; k < nf; ++k) {
+        t = OmNlTok(p);
+        if (t == -2) return 1;
+        if (t <= 0 && k >= nf - no) break;
+        if (t <= 0 || OmNlNum(p->tok, r.vf + k)) return 1;
+    }
+    if (t > 0 && (t = OmNlTok(p)) > 0) return 1;
+    if (t == -2) return 1;
+    if (op == 'b' && v[0] > p->b) p->b = v[0];
+    if ((op == 'v' || op == 'a') && v[0] > p->m) p->m = v[0];
+    if (op == 'b' || op == 'v') {       /* largest node                      */
+        if (v[1] > p->n) p->n = v[1];
+        if (v[2] > p->n) p->n = v[2];
+    }
+    return OmNlPush(p, &r, ln);
+}
+/*========== OmNlText ================*//** Helper of Function [71]          */
+static OmInt OmNlText(OmNlp* p) {
+    OmInt t, ln, rc;                    /* token, line, result of line       */
+    for (;;) {
+        ln = p->lin;
+        t = OmNlTok(p);
+        if (t == -1) return 0;
+        if (t == 0) continue;
+        rc = (t < 0) ? 1 : OmNlLine(p, ln);
+        if (rc == 2) return 0;          /* .END                              */
+        if (rc) {
+            p->err = ln;
+            return 1;
+        }
+    }
+}
+/*========== OmNlRun =================*//** Helper of Function [71]          */
+static OmInt OmNlRun(OmNlp* p, OmCir* cr) {
+    OmNlr* r;                           /* current record                    */
+    OmInt* v;                           /* integer fields                    */
+    OmFlt* f;                           /* float fields                      */
+    OmInt k, op, tm, ok;                /* used in for-loop, op, type, check */
+    OmInt ni, nf, no;                   /* arity of record                   */
+    /*======== Step 1: Branches ============================================*/
+    for (k=0; k < p->numR; ++k) {
+        r = p->rec + k;
+        v = r->vi + 1;
+        if (r->vi[0] != 'b') continue;
+        tm = OMABS(v[3]);
+        if (v[0] < 1 || v[0] > p->b || v[1] < 0 || v[1] > p->n
+            || v[2] < 0 || v[2] > p->n || tm < OMTYP_X0 || tm > OMTYP_SW
+            || cr->vecBtm[v[0]-1] != 0) return k;
+        OmBran(cr, v[0], v[1], v[2], v[3]);
+    }
+    /*======== Step 2: Meters and Elements =================================*/
+    for (k=0; k < p->numR; ++k) {
+        r = p->rec + k;
+        v = r->vi + 1;
+        f = r->vf;
+        op = r->vi[0];
+        if (op == 'b') continue;
+        if (op == 'v') {
+            if (v[0] < 1 || v[0] > p->m || v[1] < 0 || v[1] > p->n
+                || v[2] < 0 || v[2] > p->n) return k;
+            OmMetV(cr, v[0], v[1], v[2]);
+            continue;
+        }
+        if (op == 'a') {
+            if (v[0] < 1 || v[0] > p->m || v[1] < 1 || v[1] > p->b) return k;
+            OmMetA(cr, v[0], v[1]);
+            continue;
+        }
+        if (v[0] < 1 || v[0] > p->b) return k;
+        tm = OMABS(cr->vecBtm[v[0]-1]);
+        switch (op) {                   /* element fits branch type          */
+            case 'X': case 'V': case 'L': case 'Q':
+            case 'E': case 'H': case 'M': case 'A':
+                ok = tm >= OMTYP_X0 && tm <= OMTYP_X3; break;
+            case 'S': case 'D': case 'T':
+                ok = tm == OMTYP_SW; break;
+            default:
+                ok = tm >= OMTYP_Y0 && tm <= OMTYP_SW; break;
+        }
+        if (!ok) return k;
+        if (OmNlAr(op, &ni, &nf, &no)) return k;
+        if (ni == 2 && (v[1] < 1 || v[1] > p->b)) return k;
+        switch (op) {
+            case 'X': OmAddX(cr, v[0], f[0]); break;
+            case 'Y': OmAddY(cr, v[0], f[0]); break;
+            case 'V': OmAddV(cr, v[0], f[0]); break;
+            case 'I': OmAddI(cr, v[0], f[0]); break;
+            case 'L': OmAddL(cr, v[0], f[0], f[1]); break;
+            case 'C': OmAddC(cr, v[0], f[0], f[1]); break;
+            case 'Q': OmAddQ(cr, v[0], f[0], f[1]); break;
+            case 'P': OmAddP(cr, v[0], f[0], f[1]); break;
+            case 'E': OmAddE(cr, v[0], v[1], f[0]); break;
+            case 'H': OmAddH(cr, v[0], v[1], f[0]); break;
+            case 'F': OmAddF(cr, v[0], v[1], f[0]); break;
+            case 'G': OmAddG(cr, v[0], v[1], f[0]); break;
+            case 'M': OmAddM(cr, v[0], v[1], f[0], f[1]); break;
+            case 'N': OmAddN(cr, v[0], v[1], f[0], f[1]); break;
+            case 'A': OmAddA(cr, v[0], v[1], f[0], f[1]); break;
+            case 'B': OmAddB(cr, v[0], v[1], f[0], f[1]); break;
+            case 'S': OmAddS(cr, v[0], f[0], f[1], f[2], f[3]); break;
+            case 'D': OmAddD(cr, v[0], f[0], f[1]); break;
+            case 'T': OmAddT(cr, v[0], f[0], f[1]); break;
+            default: break;
+        }
+    }
+    return -1;
+}
+/*========== OmNlBin =================*//** Helper of Function [71]          */
+static OmInt OmNlBin(OmNlp* p) {
+    OmInt hd[8];                        /* header of binary netlist          */
+    char* dst;                          /* bytes of header and records       */
+    OmInt k, sz, nb;                    /* used in for-loop, sizes           */
+    sz = (OmInt)sizeof(hd);
+    if (p->len < sz) return 0;
+    dst = (char*)hd;
+    for (k=0; k < sz; ++k) dst[k] = p->buf[k];
+    if (hd[0] != OMNL_MAG) return 0;    /* not binary, parse as text         */
+    if (hd[1] != 1 || hd[2] != (OmInt)sizeof(OmNlr)
+        || hd[3] != (OmInt)sizeof(OmFlt) || hd[4] < 0 || hd[5] < 0
+        || hd[6] < 0 || hd[7] < 0) return -1;
+    p->n = hd[4];
+    p->b = hd[5];
+    p->m = hd[6];
+    p->numR = p->capR = hd[7];
+    p->rec = (OmNlr*)OMMALLOC((hd[7] + 1) * sizeof(OmNlr));
+    if (p->rec == NULL) return -1;
+    nb = hd[7] * (OmInt)sizeof(OmNlr);
+    dst = (char*)p->rec;
+    for (k=0; k < nb && sz + k < p->len; ++k) dst[k] = p->buf[sz + k];
+    if (k < nb && (OmInt)fread(dst + k, 1, nb - k, p->fp) != nb - k) {
+        return -1;
+    }
+    return 1;
+}
+/*========== OmLoad ==================*//** Function [71]                    */
+OmCir* OmLoad(FILE* fp, OmFlt stp, OmInt* ln) {
+    OmNlp p;                            /* parser state                      */
+    OmCir* cr;                          /* loaded circuit                    */
+    OmInt bin, k;                       /* binary flag, failed record        */
+    cr = NULL;
+    p.fp = fp;
+    p.pos = p.len = p.pend = p.err = 0;
+    p.numR = p.capR = p.n = p.b = p.m = 0;
+    p.lin = 1;
+    p.rec = NULL;
+    p.lns = NULL;
+    p.buf = (char*)OMMALLOC(OMNL_BUF);
+    if (p.buf != NULL) p.len = (OmInt)fread(p.buf, 1, OMNL_BUF, fp);
+    bin = (p.buf != NULL) ? OmNlBin(&p) : -1;
+    if (bin == 0 && OmNlText(&p) != 0) bin = -1;
+    if (bin >= 0) cr = OmCreate(p.n, p.b, p.m, stp);
+    if (cr != NULL) {
+        k = OmNlRun(&p, cr);
+        if (k >= 0) {                   /* semantic error in a record        */
+            p.err = bin ? k + 1 : p.lns[k];
+            OmDelete(cr);
+            cr = NULL;
+        }
+    } else if (p.err == 0) {
+        p.err = -1;
+    }
+    if (ln != NULL) *ln = (cr != NULL) ? 0 : p.err;
+    OMFREE(p.buf);
+    OMFREE(p.rec);
+    OMFREE(p.lns);
+    return cr;
+}
+/*========== OmNetBin ================*//** Function [72]                    */
+OmInt OmNetBin(FILE* fi, FILE* fo, OmInt* ln) {
+    OmNlp p;                            /* parser state                      */
+    OmInt hd[8];                        /* header of binary netlist          */
+    OmInt nr;                           /* number of records written         */
+    p.fp = fi;
+    p.pos = p.len = p.pend = p.err = 0;
+    p.numR = p.capR = p.n = p.b = p.m = 0;
+    p.lin = 1;
+    p.rec = NULL;
+    p.lns = NULL;
+    p.buf = (char*)OMMALLOC(OMNL_BUF);
+    nr = -1;
+    if (p.buf != NULL && OmNlText(&p) == 0) {
+        hd[0] = OMNL_MAG;
+        hd[1] = 1;
+        hd[2] = (OmInt)sizeof(OmNlr);
+        hd[3] = (OmInt)sizeof(OmFlt);
+        hd[4] = p.n;
+        hd[5] = p.b;
+        hd[6] = p.m;
+        hd[7] = p.numR;
+        if (fwrite(hd, sizeof(hd), 1, fo) == 1
+            && (OmInt)fwrite(p.rec, sizeof(OmNlr), p.numR, fo) == p.numR) {
+            nr = p.numR;
+        }
+    }
+    if (ln != NULL) *ln = (nr >= 0) ? 0 : (p.err ? p.err : -1);
+    OMFREE(p.buf);
+    OMFREE(p.rec);
+    OMFREE(p.lns);
+    return nr;
+}
+/*========== OmRdPure ================*//** Helper of Function [73]          */
+static OmInt OmRdPure(OmCir* cr, OmInt i) {
+    OmInt b, m;                         /* numB, numM                        */
+    OmInt j, btyp;                      /* used in for-loop, branch type     */
+    b = cr->numB;
+    m = cr->numM;
+    btyp = OMABS(cr->vecBtm[i]);
+    if (btyp != OMTYP_X0 && btyp != OMTYP_Y0) return 0;
+    if (cr->vecBn1[i] < 0 && cr->vecBn2[i] < 0) return 0;
+    if (cr->vecQs0[i] != 0.0 || cr->vecQa0[i] != 0.0) return 0;
+    if (cr->matPa[i*b+i] != 1.0) return 0;
+    for (j=0; j < b; ++j) {             /* not controlling or controlled     */
+        if (j == i) continue;
+        if (cr->matPb[i*b+j] != 0.0 || cr->matPb[j*b+i] != 0.0) return 0;
+        if (cr->matPa[i*b+j] != 0.0 || cr->matPa[j*b+i] != 0.0) return 0;
+    }
+    for (j=0; j < m; ++j) {             /* not ammetered                     */
+        if (cr->vecMn2[j] == -2 && cr->vecMn1[j] == i) return 0;
+    }
+    return 1;
+}
+/*========== OmRdAmm =================*//** Helper of Function [73]          */
+static OmInt OmRdAmm(OmCir* cr, OmInt i) {
+    OmInt j;                            /* used in for-loop                  */
+    for (j=0; j < cr->numM; ++j) {
+        if (cr->vecMn2[j] == -2 && cr->vecMn1[j] == i) return 1;
+    }
+    return 0;
+}
+/*========== OmRdRes =================*//** Helper of Function [73]          */
+static OmFlt OmRdRes(OmCir* cr, OmInt i) {
+    OmFlt p;                            /* diagonal of Pb                    */
+    p = cr->matPb[i*cr->numB+i];
+    if (OMABS(cr->vecBtm[i]) < OMTYP_Y0) return p;
+    return p != 0.0 ? 1.0 / p : -1.0;   /* -1 if open                        */
+}
+/*========== OmRdDel =================*//** Helper of Function [73]          */
+static void OmRdDel(OmCir* cr, OmInt i) {
+    cr->matPb[i*cr->numB+i] = 0.0;
+    cr->vecBn1[i] = -1;
+    cr->vecBn2[i] = -1;
+    cr->vecBtm[i] = OMTYP_Y0;
+}
+/*========== OmRdAbs =================*//** Helper of Function [73]          */
+static OmInt OmRdAbs(OmCir* cr, OmInt t, OmFlt r, OmInt pure) {
+    OmInt b, btyp;                      /* numB, branch type of target       */
+    OmFlt* p;                           /* diagonal of Pb of target          */
+    b = cr->numB;
+    btyp = OMABS(cr->vecBtm[t]);
+    p = cr->matPb + t*b + t;
+    if (btyp < OMTYP_Y0) {              /* X-type: add series resistance     */
+        *p += r;
+        return 1;
+    }
+    if (!pure || *p == 0.0) return 0;   /* pure Y0 only, open stays open     */
+    *p = 1.0 / (1.0 / *p + r);
+    return 1;
+}
+/*========== OmReduce ================*//** Function [73]                    */
+OmInt OmReduce(OmCir* cr) {
+    OmInt n, b, m;                      /* numN, numB, numM                  */
+    OmInt i, j, k, u, nd, nr, chg;      /* used in for-loop, counters        */
+    OmInt ib[3], ie[3];                 /* branches and far ends at node     */
+    OmInt *pure, *deg, *vm, *map;       /* flags, degree, voltmeter, new idx */
+    OmInt *ni, *nj;                     /* node of branch i / j              */
+    OmFlt g[3], r, s;                   /* conductances, resistance, sum     */
+    if (cr == NULL || cr->matC != NULL) return 0;
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    pure = (OmInt*)OMMALLOC((b + 3 * n + 1) * sizeof(OmInt));
+    if (pure == NULL) return 0;
+    deg = pure + b;
+    vm  = deg + n;
+    map = vm + n;
+    nr = 0;
+    for (i=0; i < n; ++i) vm[i] = 0;
+    for (i=0; i < m; ++i) {             /* voltmeter nodes are kept          */
+        if (cr->vecMn2[i] == -2) continue;
+        if (cr->vecMn1[i] >= 0) vm[cr->vecMn1[i]] = 1;
+        if (cr->vecMn2[i] >= 0) vm[cr->vecMn2[i]] = 1;
+    }
+    do {
+        chg = 0;
+        /*======== Step 1: Classify branches and count node degree ==========*/
+        for (i=0; i < n; ++i) deg[i] = 0;
+        for (i=0; i < b; ++i) {
+            pure[i] = OmRdPure(cr, i) && cr->matPb[i*b+i] >= 0.0;
+            if (cr->vecBn1[i] >= 0) deg[cr->vecBn1[i]] += 1;
+            if (cr->vecBn2[i] >= 0) deg[cr->vecBn2[i]] += 1;
+        }
+        /*======== Step 2: Remove open branches, contract shorts ============*/
+        for (i=0; i < b; ++i) {
+            if (!pure[i]) continue;
+            r = OmRdRes(cr, i);
+            ni = cr->vecBn1 + i;
+            nj = cr->vecBn2 + i;
+            if (r < 0.0 || *ni == *nj) {/* open or self loop                 */
+                if (*ni >= 0) deg[*ni] -= 1;
+                if (*nj >= 0) deg[*nj] -= 1;
+            } else if (r == 0.0 && *ni != *nj) {
+                u = (*ni >= 0 && !vm[*ni]) ? *ni
+                  : (*nj >= 0 && !vm[*nj]) ? *nj : -1;
+                if (u < 0) continue;    /* both ends must stay               */
+                k = (u == *ni) ? *nj : *ni;
+                OmRdDel(cr, i);
+                for (j=0; j < b; ++j) { /* merge node u into node k          */
+                    if (cr->vecBn1[j] == u) cr->vecBn1[j] = k;
+                    if (cr->vecBn2[j] == u) cr->vecBn2[j] = k;
+                }
+                if (k >= 0) deg[k] += deg[u] - 2;
+                deg[u] = 0;
+                pure[i] = 0;
+                nr += 1;
+                chg = 1;
+                continue;
+            } else {
+                continue;
+            }
+            OmRdDel(cr, i);
+            pure[i] = 0;
+            nr += 1;
+            chg = 1;
+        }
+        /*======== Step 3: Merge parallel branches ==========================*/
+        for (i=0; i < b; ++i) {
+            if (!pure[i]) continue;
+            r = OmRdRes(cr, i);
+            if (r <= 0.0) continue;
+            for (j=0; j < b; ++j) {
+                if (j == i) continue;
+                if (!(cr->vecBn1[j] == cr->vecBn1[i]
+                      && cr->vecBn2[j] == cr->vecBn2[i])
+                    && !(cr->vecBn1[j] == cr->vecBn2[i]
+                      && cr->vecBn2[j] == cr->vecBn1[i])) continue;
+                k = OMABS(cr->vecBtm[j]);
+                if (k >= OMTYP_Y0 && k != OMTYP_SW && !OmRdAmm(cr, j)) {
+                    cr->matPb[j*b+j] += 1.0 / r;
+                    break;              /* Y-type: add parallel conductance  */
+                }
+                if (pure[j] && k == OMTYP_X0 && OmRdRes(cr, j) > 0.0) {
+                    s = OmRdRes(cr, j);
+                    cr->matPb[j*b+j] = r * s / (r + s);
+                    break;              /* pure X0: combine resistances      */
+                }
+            }
+            if (j == b) continue;
+            if (cr->vecBn1[i] >= 0) deg[cr->vecBn1[i]] -= 1;
+            if (cr->vecBn2[i] >= 0) deg[cr->vecBn2[i]] -= 1;
+            OmRdDel(cr, i);
+            pure[i] = 0;
+            nr += 1;
+            chg = 1;
+        }
+        /*======== Step 4: Eliminate internal nodes of degree 1 to 3 ========*/
+        for (u=0; u < n; ++u) {
+            nd = deg[u];
+            if (vm[u] || nd < 1 || nd > 3) continue;
+            for (i=0, k=0; i < b && k < nd; ++i) {
+                if (cr->vecBn1[i] == u && cr->vecBn2[i] != u) {
+                    ib[k] = i; ie[k] = cr->vecBn2[i]; k += 1;
+                } else if (cr->vecBn2[i] == u && cr->vecBn1[i] != u) {
+                    ib[k] = i; ie[k] = cr->vecBn1[i]; k += 1;
+                }
+            }
+            if (k != nd) continue;      /* self loop at node                 */
+            if (nd == 1) {              /* dangling branch                   */
+                if (!pure[ib[0]]) continue;
+                OmRdDel(cr, ib[0]);
+                pure[ib[0]] = 0;
+                if (ie[0] >= 0) deg[ie[0]] -= 1;
+            } else if (nd == 2) {       /* series branches                   */
+                if (ie[0] == ie[1]) continue;
+                if (!pure[ib[1]]) {     /* let ib[1] be the pure one         */
+                    k = ib[0]; ib[0] = ib[1]; ib[1] = k;
+                    k = ie[0]; ie[0] = ie[1]; ie[1] = k;
+                }
+                if (!pure[ib[1]] || OMABS(cr->vecBtm[ib[0]]) == OMTYP_SW)
+                    continue;
+                r = OmRdRes(cr, ib[1]);
+                if (r < 0.0 || !OmRdAbs(cr, ib[0], r, pure[ib[0]])) continue;
+                if (cr->vecBn1[ib[0]] == u) cr->vecBn1[ib[0]] = ie[1];
+                else cr->vecBn2[ib[0]] = ie[1];
+                OmRdDel(cr, ib[1]);
+                pure[ib[1]] = 0;
+            } else {                    /* star-mesh of three conductances   */
+                if (ie[0] == ie[1] || ie[1] == ie[2] || ie[0] == ie[2])
+                    continue;
+                s = 0.0;
+                for (k=0; k < 3; ++k) {
+                    r = pure[ib[k]] ? OmRdRes(cr, ib[k]) : -1.0;
+                    if (r <= 0.0) break;
+                    g[k] = 1.0 / r;
+                    s += g[k];
+                }
+                if (k < 3) continue;
+                for (k=0; k < 3; ++k) { /* branch k joins ends k and k+1     */
+                    i = ib[k];
+                    cr->vecBn1[i] = ie[k];
+                    cr->vecBn2[i] = ie[(k+1)%3];
+                    cr->vecBtm[i] = OMTYP_Y0;
+                    cr->matPb[i*b+i] = g[k] * g[(k+1)%3] / s;
+                    if (ie[k] >= 0) deg[ie[k]] += 1;
+                }
+                deg[u] = 0;
+                chg = 1;
+                continue;
+            }
+            deg[u] = 0;
+            nr += 1;
+            chg = 1;
+        }
+    } while (chg);
+    /*======== Step 5: Remove unused nodes ==================================*/
+    for (i=0; i < n; ++i) map[i] = vm[i];
+    for (i=0; i < b; ++i) {
+        if (cr->vecBn1[i] >= 0) map[cr->vecBn1[i]] = 1;
+        if (cr->vecBn2[i] >= 0) map[cr->vecBn2[i]] = 1;
+    }
+    for (i=0, k=0; i < n; ++i) map[i] = map[i] ? k++ : -1;
+    for (i=0; i < b; ++i) {
+        if (cr->vecBn1[i] >= 0) cr->vecBn1[i] = map[cr->vecBn1[i]];
+        if (cr->vecBn2[i] >= 0) cr->vecBn2[i] = map[cr->vecBn2[i]];
+    }
+    for (i=0; i < m; ++i) {
+        if (cr->vecMn2[i] == -2) continue;
+        if (cr->vecMn1[i] >= 0) cr->vecMn1[i] = map[cr->vecMn1[i]];
+        if (cr->vecMn2[i] >= 0) cr->vecMn2[i] = map[cr->vecMn2[i]];
+    }
+    cr->numN = k;
+    /*======== Step 6: Renumber X-type branches =============================*/
+    cr->numX = 0;
+    for (i=0; i < b; ++i) {
+        if (OMABS(cr->vecBtm[i]) >= OMTYP_Y0) {
+            cr->vecLut[i] = 1;
+        } else {
+            cr->vecLut[i] = -cr->numX;
+            cr->numX += 1;
+        }
+    }
+    OMFREE(pure);
+    return nr;
+}
+/*========== OmMorAdd ================*//** Helper of Function [74]          */
+static OmInt OmMorAdd(OmInt r, OmInt nv, OmFlt* v, OmFlt* w, OmFlt tol) {
+    OmInt i, k, it;                     /* used in for-loop, pass            */
+    OmFlt h, s0, s;                     /* projection, norms                 */
+    s0 = 0.0;
+    for (i=0; i < r; ++i) s0 += w[i] * w[i];
+    s0 = OmSqrt(s0);
+    if (s0 == 0.0) return 0;
+    for (it=0; it < 2; ++it) {          /* modified Gram-Schmidt, twice      */
+        for (k=0; k < nv; ++k) {
+            h = 0.0;
+            for (i=0; i < r; ++i) h += v[k*r+i] * w[i];
+            for (i=0; i < r; ++i) w[i] -= h * v[k*r+i];
+        }
+    }
+    s = 0.0;
+    for (i=0; i < r; ++i) s += w[i] * w[i];
+    s = OmSqrt(s);
+    if (s <= tol * s0) return 0;        /* deflate dependent vector          */
+    for (i=0; i < r; ++i) v[nv*r+i] = w[i] / s;
+    return 1;
+}
+/*========== OmMor ===================*//** Function [74]                    */
+OmCir* OmMor(OmCir* cr, OmInt* kb, OmInt nk, OmInt q, OmFlt tol,
+             OmInt* map, OmFlt* pol) {
+    OmInt b, c, m, p, r, nb;            /* sizes of original and ports       */
+    OmInt i, j, k, e, nv;               /* used in for-loop, basis size      */
+    OmInt *rb, *ip, *ir, *pm;           /* branch of row, port / state rows  */
+    OmFlt *mi, *lu, *v, *w, *t;         /* (sI-A)^-1, LU, basis, scratch     */
+    OmFlt sg, aij;                      /* expansion point, entry of A       */
+    OmCir* rd;                          /* reduced circuit                   */
+    if (cr == NULL || cr->matC == NULL || q < 0) return NULL;
+    if (cr->vecQb != NULL) return NULL; /* BDF2 history is not reduced       */
+    b = cr->numB;
+    c = cr->numC;
+    m = cr->numM;
+    /*======== Step 1: Split rows into ports and states =====================*/
+    rb = (OmInt*)OMMALLOC((3 * c + 1) * sizeof(OmInt));
+    if (rb == NULL) return NULL;
+    ip = rb + c;
+    ir = ip + c;
+    for (i=0; i < c; ++i) ip[i] = 0;
+    for (i=0; i < b; ++i) {
+        k = cr->vecLut[i];
+        if (k < 0) continue;
+        rb[k] = i;
+        if (OMABS(cr->vecBtm[i]) == OMTYP_SW || cr->vecQs0[i] != 0.0
+            || (cr->vecW1o[i] == 0.0 && cr->vecW2o[i] == 0.0)) ip[k] = 1;
+    }
+    for (i=0; i < nk; ++i) {
+        k = cr->vecLut[kb[i]-1];
+        if (k >= 0) ip[k] = 1;
+    }
+    for (i=0, p=0, r=0; i < c; ++i) {
+        if (ip[i]) ip[p++] = i;
+        else ir[r++] = i;
+    }
+    if (q > r) q = r;
+    /*======== Step 2: Invert (sI - A) of state rows ========================*/
+    mi = (OmFlt*)OMMALLOC((2 * r * r + (q + 2) * r + 1) * sizeof(OmFlt));
+    pm = (OmInt*)OMMALLOC((r + 1) * sizeof(OmInt));
+    if (mi == NULL || pm == NULL) {
+        OMFREE(rb); OMFREE(mi); OMFREE(pm);
+        return NULL;
+    }
+    lu = mi + r * r;
+    v  = lu + r * r;
+    w  = v + q * r;
+    t  = w + r;
+    for (sg=1.0, k=1; k && sg < 2.0; sg += 0.25) {
+        for (i=0; i < r; ++i) {         /* A = W1 * Crr + W2                 */
+            for (j=0; j < r; ++j) {
+                aij = cr->vecW1o[rb[ir[i]]] * cr->matC[ir[i]*c+ir[j]];
+                if (i == j) aij += cr->vecW2o[rb[ir[i]]];
+                mi[i*r+j] = (i == j ? sg : 0.0) - aij;
+            }
+        }
+        OmMatPiv(r, mi, pm);
+        k = OmMatLuInv(r, mi, lu, pm, 1e-13);
+    }
+    if (tol <= 0.0) tol = 1e-10;
+    /*======== Step 3: Block Arnoldi on (sI - A)^-1 with deflation ==========*/
+    nv = 0;
+    for (e=0; !k && e < p && nv < q; ++e) {
+        for (i=0; i < r; ++i) {         /* t = B[:,e] = W1 * Crp[:,e]        */
+            t[i] = cr->vecW1o[rb[ir[i]]] * cr->matC[ir[i]*c+ip[e]];
+        }
+        OmVecMul(r, r, w, mi, t);
+        nv += OmMorAdd(r, nv, v, w, tol);
+    }
+    for (e=0; !k && e < nv && nv < q; ++e) {
+        OmVecMul(r, r, w, mi, v + e * r);
+        nv += OmMorAdd(r, nv, v, w, tol);
+    }
+    /*======== Step 4: Build reduced circuit ================================*/
+    nb = p + nv;
+    rd = k ? NULL : OmCreate(0, nb, m, cr->timStp);
+    if (rd != NULL) {
+        OMFREE(rd->vecBn1); rd->vecBn1 = NULL;
+        OMFREE(rd->vecBn2); rd->vecBn2 = NULL;
+        OMFREE(rd->vecMn1); rd->vecMn1 = NULL;
+        OMFREE(rd->vecMn2); rd->vecMn2 = NULL;
+        OMFREE(rd->matPa ); rd->matPa  = NULL;
+        OMFREE(rd->matPb ); rd->matPb  = NULL;
+        rd->matC   = (OmFlt*)OMMALLOC((nb * nb + 1) * sizeof(OmFlt));
+        rd->matD   = (OmFlt*)OMMALLOC((m * nb + 1) * sizeof(OmFlt));
+        rd->vecW1m = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        rd->vecW2m = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        rd->vecW1s = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        rd->vecW2s = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        rd->vecQa  = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        rd->vecQs  = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        rd->vecQtp = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        rd->vecXm  = (OmFlt*)OMMALLOC((m + 1) * sizeof(OmFlt));
+        rd->vecXc  = (OmFlt*)OMMALLOC((nb + 1) * sizeof(OmFlt));
+        e = rd->matC == NULL || rd->matD == NULL || rd->vecW1m == NULL
+         || rd->vecW2m == NULL || rd->vecW1s == NULL || rd->vecW2s == NULL
+         || rd->vecQa == NULL || rd->vecQs == NULL || rd->vecQtp == NULL
+         || rd->vecXm == NULL || rd->vecXc == NULL;
+        if (cr->numA > 0) {             /* same [b] layout as OmAddCm()      */
+            rd->vecAb = (OmInt*)OMMALLOC(nb * sizeof(OmInt));
+            rd->vecAt = (OmInt*)OMMALLOC(nb * sizeof(OmInt));
+            rd->vecAs = (OmInt*)OMMALLOC(nb * sizeof(OmInt));
+            rd->vecAe = (OmInt*)OMMALLOC(nb * sizeof(OmInt));
+            rd->vecAg = (OmFlt*)OMMALLOC(nb * sizeof(OmFlt));
+            rd->vecAv = (OmFlt*)OMMALLOC(nb * sizeof(OmFlt));
+            rd->vecAi = (OmFlt*)OMMALLOC(nb * sizeof(OmFlt));
+            e = e || rd->vecAb == NULL || rd->vecAt == NULL
+             || rd->vecAs == NULL || rd->vecAe == NULL || rd->vecAg == NULL
+             || rd->vecAv == NULL || rd->vecAi == NULL;
+        }
+        if (e) {                        /* out of memory                     */
+            OmDelete(rd);
+            rd = NULL;
+        }
+    }
+    if (rd != NULL) {
+        for (i=0; i < nb; ++i) rd->vecLut[i] = i;
+        for (i=0; i < p; ++i) {         /* ports keep their branch data      */
+            j = rb[ip[i]];
+            rd->vecBtm[i] = cr->vecBtm[j];
+            rd->vecW1c[i] = cr->vecW1c[j];
+            rd->vecW2c[i] = cr->vecW2c[j];
+            rd->vecW1o[i] = cr->vecW1o[j];
+            rd->vecW2o[i] = cr->vecW2o[j];
+            rd->vecQa0[i] = cr->vecQa0[j];
+            rd->vecQs0[i] = cr->vecQs0[j];
+        }
+        for (i=0; i < nv; ++i) {        /* states: Qa = Xc of next step      */
+            rd->vecBtm[p+i] = OMTYP_Y2;
+            rd->vecW1c[p+i] = rd->vecW1o[p+i] = 1.0;
+            rd->vecQa0[p+i] = 0.0;
+            for (j=0; j < r; ++j) {
+                rd->vecQa0[p+i] += v[i*r+j] * cr->vecQa0[rb[ir[j]]];
+            }
+        }
+        rd->numC = nb;
+        for (i=0; i < p; ++i) {         /* Cpp and Dp unchanged              */
+            for (j=0; j < p; ++j) {
+                rd->matC[i*nb+j] = cr->matC[ip[i]*c+ip[j]];
+            }
+        }
+        for (i=0; i < m; ++i) {
+            for (j=0; j < p; ++j) rd->matD[i*nb+j] = cr->matD[i*c+ip[j]];
+        }
+        for (k=0; k < nv; ++k) {        /* Cpr V, Dr V, V' B, V' A V         */
+            for (i=0; i < p; ++i) {
+                aij = 0.0;
+                for (j=0; j < r; ++j) {
+                    aij += cr->matC[ip[i]*c+ir[j]] * v[k*r+j];
+                }
+                rd->matC[i*nb+p+k] = aij;
+            }
+            for (i=0; i < m; ++i) {
+                aij = 0.0;
+                for (j=0; j < r; ++j) {
+                    aij += cr->matD[i*c+ir[j]] * v[k*r+j];
+                }
+                rd->matD[i*nb+p+k] = aij;
+            }
+            for (i=0; i < p; ++i) {
+                aij = 0.0;
+                for (j=0; j < r; ++j) {
+                    aij += v[k*r+j] * cr->vecW1o[rb[ir[j]]]
+                         * cr->matC[ir[j]*c+ip[i]];
+                }
+                rd->matC[(p+k)*nb+i] = aij;
+            }
+            for (i=0; i < r; ++i) {     /* t = A V[:,k]                      */
+                aij = cr->vecW2o[rb[ir[i]]] * v[k*r+i];
+                for (j=0; j < r; ++j) {
+                    aij += cr->vecW1o[rb[ir[i]]] * cr->matC[ir[i]*c+ir[j]]
+                         * v[k*r+j];
+                }
+                t[i] = aij;
+            }
+            for (i=0; i < nv; ++i) {
+                aij = 0.0;
+                for (j=0; j < r; ++j) aij += v[i*r+j] * t[j];
+                rd->matC[(p+i)*nb+p+k] = aij;
+            }
+        }
+        /*======== Step 5: Runtime vectors and auto switches ================*/
+        for (i=0; i < c; ++i) ir[i] = -1;
+        for (i=0; i < p; ++i) ir[ip[i]] = i;
+        for (i=0; i < cr->numA; ++i) {  /* SW rows are ports                 */
+            rd->vecAb[i] = ir[cr->vecLut[cr->vecAb[i]]];
+            rd->vecAt[i] = cr->vecAt[i];
+            rd->vecAe[i] = cr->vecAe[i];
+            rd->vecAg[i] = cr->vecAg[i];
+            rd->vecAv[i] = cr->vecAv[i];
+            rd->vecAi[i] = cr->vecAi[i];
+        }
+        rd->numA = cr->numA;
+        OmReset(rd);
+        if (map != NULL) for (i=0; i < b; ++i) {
+            k = cr->vecLut[i];
+            map[i] = (k >= 0 && ir[k] >= 0) ? ir[k] + 1 : 0;
+        }
+        /*======== Step 6: Poles of reduced dynamics ========================*/
+        if (pol != NULL && nv > 0) {    /* reuse scratch, w and t are [2r]   */
+            for (i=0; i < nv; ++i) {
+                for (j=0; j < nv; ++j) {
+                    lu[i*nv+j] = rd->matC[(p+i)*nb+p+j];
+                }
+            }
+            if (OmMatEig(nv, lu, w, w + nv)) {
+                OmDelete(rd);           /* QR did not converge               */
+                rd = NULL;
+            }
+            for (i=0; rd != NULL && i < nv; ++i) {
+                pol[2*i]   = w[i];
+                pol[2*i+1] = w[nv+i];
+            }
+        }
+    }
+    OMFREE(rb);
+    OMFREE(mi);
+    OMFREE(pm);
+    return rd;
+}
+/*========== OmEigHes ================*//** Helper of Function [75]          */
+static void OmEigHes(OmInt n, OmFlt* a) {
+    OmInt i, j, k, im;                  /* used in for-loop, pivot row       */
+    OmFlt x, y;                         /* pivot, multiplier                 */
+    for (k=1; k < n-1; ++k) {           /* elimination with row pivoting     */
+        x = 0.0;
+        im = k;
+        for (j=k; j < n; ++j) {
+            if (OMABS(a[j*n+k-1]) > OMABS(x)) {
+                x = a[j*n+k-1];
+                im = j;
+            }
+        }
+        if (im != k) {                  /* similarity: swap rows and columns */
+            for (j=k-1; j < n; ++j) {
+                y = a[im*n+j]; a[im*n+j] = a[k*n+j]; a[k*n+j] = y;
+            }
+            for (j=0; j < n; ++j) {
+                y = a[j*n+im]; a[j*n+im] = a[j*n+k]; a[j*n+k] = y;
+            }
+        }
+        if (x == 0.0) continue;
+        for (i=k+1; i < n; ++i) {
+            y = a[i*n+k-1];
+            if (y == 0.0) continue;
+            y /= x;
+            a[i*n+k-1] = 0.0;
+            for (j=k; j < n; ++j) a[i*n+j] -= y * a[k*n+j];
+            for (j=0; j < n; ++j) a[j*n+k] += y * a[j*n+i];
+        }
+    }
+}
+/*========== OmMatEig ================*//** Function [75]                    */
+OmInt OmMatEig(OmInt n, OmFlt* a, OmFlt* wr, OmFlt* wi) {
+    OmInt nn, m, l, k, j, its, i, mmin; /* used in for-loop, active block    */
+    OmFlt z, y, x, w, v, u, t, s, r;    /* shifts and Householder values     */
+    OmFlt p, q, anorm;                  /* Householder values, matrix norm   */
+    OmEigHes(n, a);
+    anorm = 0.0;
+    for (i=0; i < n; ++i) {
+        for (j=(i > 0 ? i-1 : 0); j < n; ++j) anorm += OMABS(a[i*n+j]);
+    }
+    nn = n - 1;
+    t = 0.0;
+    p = q = r = 0.0;
+    while (nn >= 0) {                   /* Step: deflate from bottom         */
+        its = 0;
+        do {
+            for (l=nn; l >= 1; --l) {   /* look for small subdiagonal        */
+                s = OMABS(a[(l-1)*n+l-1]) + OMABS(a[l*n+l]);
+                if (s == 0.0) s = anorm;
+                if ((OmFlt)(OMABS(a[l*n+l-1]) + s) == s) {
+                    a[l*n+l-1] = 0.0;
+                    break;
+                }
+            }
+            x = a[nn*n+nn];
+            if (l == nn) {              /* one root found                    */
+                wr[nn] = x + t;
+                wi[nn--] = 0.0;
+            } else {
+                y = a[(nn-1)*n+nn-1];
+                w = a[nn*n+nn-1] * a[(nn-1)*n+nn];
+                if (l == nn - 1) {      /* two roots found                   */
+                    p = 0.5 * (y - x);
+                    q = p * p + w;
+                    z = OmSqrt(OMABS(q));
+                    x += t;
+                    if (q >= 0.0) {     /* real pair                         */
+                        z = p + (p >= 0.0 ? z : -z);
+                        wr[nn-1] = wr[nn] = x + z;
+                        if (z != 0.0) wr[nn] = x - w / z;
+                        wi[nn-1] = wi[nn] = 0.0;
+                    } else {            /* complex pair                      */
+                        wr[nn-1] = wr[nn] = x + p;
+                        wi[nn-1] = -z;
+                        wi[nn] = z;
+                    }
+                    nn -= 2;
+                } else {                /* no roots yet, double shift QR     */
+                    if (its == 60) return -1;
+                    if (its == 10 || its == 20) {
+                        t += x;         /* exceptional shift                 */
+                        for (i=0; i <= nn; ++i) a[i*n+i] -= x;
+                        s = OMABS(a[nn*n+nn-1]) + OMABS(a[(nn-1)*n+nn-2]);
+                        y = x = 0.75 * s;
+                        w = -0.4375 * s * s;
+                    }
+                    ++its;
+                    for (m=nn-2; m >= l; --m) {
+                        z = a[m*n+m];
+                        r = x - z;
+                        s = y - z;
+                        p = (r * s - w) / a[(m+1)*n+m] + a[m*n+m+1];
+                        q = a[(m+1)*n+m+1] - z - r - s;
+                        r = a[(m+2)*n+m+1];
+                        s = OMABS(p) + OMABS(q) + OMABS(r);
+                        p /= s;
+                        q /= s;
+                        r /= s;
+                        if (m == l) break;
+                        u = OMABS(a[m*n+m-1]) * (OMABS(q) + OMABS(r));
+                        v = OMABS(p) * (OMABS(a[(m-1)*n+m-1]) + OMABS(z)
+                          + OMABS(a[(m+1)*n+m+1]));
+                        if ((OmFlt)(u + v) == v) break;
+                    }
+                    for (i=m+2; i <= nn; ++i) {
+                        a[i*n+i-2] = 0.0;
+                        if (i != m + 2) a[i*n+i-3] = 0.0;
+                    }
+                    for (k=m; k <= nn-1; ++k) {
+                        if (k != m) {
+                            p = a[k*n+k-1];
+                            q = a[(k+1)*n+k-1];
+                            r = 0.0;
+                            if (k != nn - 1) r = a[(k+2)*n+k-1];
+                            x = OMABS(p) + OMABS(q) + OMABS(r);
+                            if (x != 0.0) {
+                                p /= x;
+                                q /= x;
+                                r /= x;
+                            }
+                        }
+                        s = OmSqrt(p * p + q * q + r * r);
+                        if (p < 0.0) s = -s;
+                        if (s == 0.0) continue;
+                        if (k == m) {
+                            if (l != m) a[k*n+k-1] = -a[k*n+k-1];
+                        } else {
+                            a[k*n+k-1] = -s * x;
+                        }
+                        p += s;
+                        x = p / s;
+                        y = q / s;
+                        z = r / s;
+                        q /= p;
+                        r /= p;
+                        for (j=k; j <= nn; ++j) {
+                            p = a[k*n+j] + q * a[(k+1)*n+j];
+                            if (k != nn - 1) {
+                                p += r * a[(k+2)*n+j];
+                                a[(k+2)*n+j] -= p * z;
+                            }
+                            a[(k+1)*n+j] -= p * y;
+                            a[k*n+j] -= p * x;
+                        }
+                        mmin = nn < k + 3 ? nn : k + 3;
+                        for (i=l; i <= mmin; ++i) {
+                            p = x * a[i*n+k] + y * a[i*n+k+1];
+                            if (k != nn - 1) {
+                                p += z * a[i*n+k+2];
+                                a[i*n+k+2] -= p * r;
+                            }
+                            a[i*n+k+1] -= p * q;
+                            a[i*n+k] -= p;
+                        }
+                    }
+                }
+            }
+        } while (l < nn - 1);
+    }
+    return 0;
+}
+#ifdef LIBOHM_ATOMIC                    /*| concurrency layer (opt-in)      |*/
+/*========== OmChnNew ================*//** Function [76]                    */
+OmChn* OmChnNew(OmCir* cr, OmInt nq) {
+    OmChn* ch;                          /* new channel                       */
+    OmInt q;                            /* ring capacity                     */
+    if (cr == NULL || cr->matC == NULL || nq < 1) return NULL;
+    for (q=1; q < nq; q *= 2);
+    ch = (OmChn*)OMMALLOC(sizeof(OmChn));
+    if (ch == NULL) return NULL;
+    ch->cir    = cr;
+    ch->numQ   = q;
+    ch->numS   = cr->numM + cr->numC;
+    ch->idxH   = 0;
+    ch->idxT   = 0;
+    ch->numSeq = 0;
+    ch->numP   = -1;
+    ch->vecQ   = (OmCmd*)OMMALLOC(q * sizeof(OmCmd));
+    ch->vecP   = (OmFlt*)OMMALLOC((ch->numS + 1) * sizeof(OmFlt));
+    if (ch->vecQ == NULL || ch->vecP == NULL) {
+        OmChnDel(ch);
+        return NULL;
+    }
+    return ch;
+}
+/*========== OmChnDel ================*//** Function [77]                    */
+void OmChnDel(OmChn* ch) {
+    OMFREE(ch->vecQ);
+    OMFREE(ch->vecP);
+    OMFREE(ch);
+}
+/*========== OmChnPut ================*//** Function [78]                    */
+OmInt OmChnPut(OmChn* ch, OmInt typ, OmInt br, OmFlt x, OmInt k) {
+    unsigned int h, t;                  /* head and tail                     */
+    OmCmd* cm;                          /* slot to fill                      */
+    t = OMLDR(&ch->idxT);               /* own index                         */
+    h = OMLDA(&ch->idxH);               /* slots released by consumer        */
+    if (t - h >= (unsigned int)ch->numQ) return -1;
+    cm = ch->vecQ + (t & (ch->numQ - 1));
+    cm->typ = typ;
+    cm->br  = br;
+    cm->stp = k;
+    cm->val = x;
+    OMSTR(&ch->idxT, t + 1);            /* publish the slot                  */
+    return 0;
+}
+/*========== OmChnRun ================*//** Function [79]                    */
+OmInt OmChnRun(OmChn* ch, OmInt k) {
+    unsigned int h, t;                  /* head and tail                     */
+    OmCmd* cm;                          /* slot to apply                     */
+    OmInt nsw;                          /* number of switch commands         */
+    h = OMLDR(&ch->idxH);               /* own index                         */
+    t = OMLDA(&ch->idxT);               /* slots published by producer       */
+    nsw = 0;
+    for (; h != t; ++h) {
+        cm = ch->vecQ + (h & (ch->numQ - 1));
+        if (cm->stp > k) break;         /* not due yet, keep order           */
+        switch (cm->typ) {
+            case OMCMD_QS:
+                OmSetQs(ch->cir, cm->br, cm->val);
+                break;
+            case OMCMD_SW:
+                OmSetSw(ch->cir, cm->br, cm->val != 0.0);
+                nsw += 1;
+                break;
+            case OMCMD_GT:
+                OmSetGt(ch->cir, cm->br, cm->val != 0.0);
+                break;
+            default: break;
+        }
+    }
+    OMSTR(&ch->idxH, h);                /* release applied slots             */
+    return nsw;
+}
+/*========== OmChnPub ================*//** Function [80]                    */
+void OmChnPub(OmChn* ch, OmInt k) {
+    OmCir* cr;                          /* circuit of channel                */
+    unsigned int s;                     /* sequence before writing           */
+    OmInt i;                            /* used in for-loop                  */
+    cr = ch->cir;
+    s = OMLDR(&ch->numSeq);
+    OMSTX(&ch->numSeq, s + 1);          /* odd: writing                      */
+    OMFNR();
+    for (i=0; i < cr->numM; ++i) {
+        __atomic_store(ch->vecP + i, cr->vecXm + i, __ATOMIC_RELAXED);
+    }
+    for (i=0; i < cr->numC; ++i) {
+        __atomic_store(ch->vecP + cr->numM + i, cr->vecXc + i,
+                       __ATOMIC_RELAXED);
+    }
+    OMSTX(&ch->numP, k);
+    OMSTR(&ch->numSeq, s + 2);          /* even: consistent                  */
+}
+/*========== OmChnGet ================*//** Function [81]                    */
+OmInt OmChnGet(OmChn* ch, OmFlt* xm, OmFlt* xc) {
+    unsigned int s1, s2;                /* sequence before and after read    */
+    OmInt i, m, c, k;                   /* used in for-loop, sizes, step     */
+    m = ch->cir->numM;
+    c = ch->cir->numC;
+    do {
+        s1 = OMLDA(&ch->numSeq);
+        if (s1 & 1u) continue;          /* writer is publishing              */
+        for (i=0; xm != NULL && i < m; ++i) {
+            __atomic_load(ch->vecP + i, xm + i, __ATOMIC_RELAXED);
+        }
+        for (i=0; xc != NULL && i < c; ++i) {
+            __atomic_load(ch->vecP + m + i, xc + i, __ATOMIC_RELAXED);
+        }
+        k = OMLDR(&ch->numP);
+        OMFNA();
+        s2 = OMLDR(&ch->numSeq);
+    } while ((s1 & 1u) || s1 != s2);
+    return k;
+}
+#endif                                  /*| #ifdef LIBOHM_ATOMIC            |*/
+/*========== OmWavNew ================*//** Function [82]                    */
+OmWav* OmWavNew(OmCir* cr, OmInt nw) {
+    OmWav* wv;                          /* new waveform engine               */
+    OmInt i;                            /* used in for-loop                  */
+    if (cr == NULL || cr->matC == NULL || nw < 1) return NULL;
+    wv = (OmWav*)OMMALLOC(sizeof(OmWav));
+    if (wv == NULL) return NULL;
+    wv->cir   = cr;
+    wv->numW  = nw;
+    wv->numU  = 0;
+    wv->vecWt = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    wv->vecWb = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    wv->vecWn = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    wv->vecWi = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    wv->vecWv = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWl = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWx = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWy = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWp = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWq = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWa = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWo = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecWd = (OmFlt**)OMMALLOC(nw * sizeof(OmFlt*));
+    wv->vecEb = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    wv->vecEs = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    wv->vecEa = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    wv->vecE  = (OmFlt*)OMMALLOC((4 * cr->numC + 1) * sizeof(OmFlt));
+    if (wv->vecWt == NULL || wv->vecWb == NULL || wv->vecWn == NULL
+        || wv->vecWi == NULL || wv->vecWv == NULL || wv->vecWl == NULL
+        || wv->vecWx == NULL || wv->vecWy == NULL || wv->vecWp == NULL
+        || wv->vecWq == NULL || wv->vecWa == NULL || wv->vecWo == NULL
+        || wv->vecWd == NULL || wv->vecEb == NULL || wv->vecEs == NULL
+        || wv->vecEa == NULL || wv->vecE == NULL) {
+        OmWavDel(wv);                   /* numU = 0, vecWd is not walked     */
+        return NULL;
+    }
+    for (i=0; i < nw; ++i) wv->vecWd[i] = NULL;
+    return wv;
+}
+/*========== OmWavDel ================*//** Function [83]                    */
+void OmWavDel(OmWav* wv) {
+    OmInt i;                            /* used in for-loop                  */
+    if (wv == NULL) return;
+    for (i=0; i < wv->numU; ++i) OMFREE(wv->vecWd[i]);
+    OMFREE(wv->vecWt);
+    OMFREE(wv->vecWb);
+    OMFREE(wv->vecWn);
+    OMFREE(wv->vecWi);
+    OMFREE(wv->vecWv);
+    OMFREE(wv->vecWl);
+    OMFREE(wv->vecWx);
+    OMFREE(wv->vecWy);
+    OMFREE(wv->vecWp);
+    OMFREE(wv->vecWq);
+    OMFREE(wv->vecWa);
+    OMFREE(wv->vecWo);
+    OMFREE(wv->vecWd);
+    OMFREE(wv->vecEb);
+    OMFREE(wv->vecEs);
+    OMFREE(wv->vecEa);
+    OMFREE(wv->vecE);
+    OMFREE(wv);
+}
+/*========== OmWavAdd ================*//** Helper of Function [84]          */
+static OmInt OmWavAdd(OmWav* wv, OmInt typ, OmInt br) {
+    OmInt j;                            /* index of new generator            */
+    if (wv->numU >= wv->numW || br < 0 || br > wv->cir->numB) return -1;
+    j = wv->numU++;
+    wv->vecWt[j] = typ;
+    wv->vecWb[j] = br;
+    wv->vecWn[j] = 0;
+    wv->vecWi[j] = 0;
+    wv->vecWv[j] = 0.0;
+    wv->vecWl[j] = 0.0;
+    wv->vecWx[j] = 0.0;
+    wv->vecWy[j] = 0.0;
+    wv->vecWp[j] = 0.0;
+    wv->vecWq[j] = 0.0;
+    wv->vecWa[j] = 0.0;
+    wv->vecWo[j] = 0.0;
+    return j;
+}
+/*========== OmWavPv =================*//** Helper of Function [88]          */
+static OmFlt OmWavPv(OmWav* wv, OmInt j) {
+    OmFlt* t;                           /* time of points                    */
+    OmFlt* v;                           /* value of points                   */
+    OmFlt tl;                           /* local time                        */
+    OmInt i, n;                         /* cursor, number of points          */
+    n  = wv->vecWn[j];
+    t  = wv->vecWd[j];
+    v  = t + n;
+    tl = wv->vecWx[j];
+    i  = wv->vecWi[j];
+    while (i + 1 < n && tl >= t[i+1]) ++i;
+    wv->vecWi[j] = i;
+    if (i + 1 >= n || tl <= t[i]) return v[i];
+    return v[i] + (tl - t[i]) * (v[i+1] - v[i]) / (t[i+1] - t[i]);
+}
+/*========== OmWavTri ================*//** Helper of Function [88]          */
+static OmFlt OmWavTri(OmFlt p) {
+    return p < 0.5 ? 4.0 * p - 1.0 : 3.0 - 4.0 * p;
+}
+/*========== OmSinCos ================*//** Helper of Function [84]          */
+static void OmSinCos(OmFlt x, OmFlt* sn, OmFlt* cs) {
+    OmFlt t, u, r2, ps, pc;             /* terms, reduced angle^2, series    */
+    long q;                             /* nearest multiple of pi / 2        */
+    OmInt i;                            /* used in for-loop                  */
+    t = x * 0.63661977236758134308;
+    q = (long)(t < 0.0 ? t - 0.5 : t + 0.5);
+    t = (x - q * 1.5707963267341256) - q * 6.077100506506192e-11;
+    r2 = t * t;                         /* |t| <= pi / 4                     */
+    ps = t;
+    pc = 1.0;
+    u = 1.0;
+    for (i=1; i < 11; ++i) {            /* Taylor series up to t^21          */
+        t *= -r2 / (OmFlt)((2*i) * (2*i+1));
+        u *= -r2 / (OmFlt)((2*i-1) * (2*i));
+        ps += t;
+        pc += u;
+    }
+    i = (OmInt)(q % 4);
+    if (i < 0) i += 4;
+    *sn = (i == 0) ? ps : (i == 1) ? pc : (i == 2) ? -ps : -pc;
+    *cs = (i == 0) ? pc : (i == 1) ? -ps : (i == 2) ? -pc : ps;
+}
+/*========== OmWavSin ================*//** Function [84]                    */
+OmInt OmWavSin(OmWav* wv, OmInt br, OmFlt am, OmFlt f, OmFlt ph, OmFlt dc) {
+    OmInt j;                            /* index of new generator            */
+    OmFlt w;                            /* angle of one step                 */
+    j = OmWavAdd(wv, OMWAV_SIN, br);
+    if (j < 0) return -1;
+    w = 2.0 * 3.14159265358979323846 * f * wv->cir->timStp;
+    OmSinCos(w, wv->vecWq + j, wv->vecWp + j);
+    OmSinCos(ph, wv->vecWx + j, wv->vecWy + j);
+    wv->vecWa[j] = am;
+    wv->vecWo[j] = dc;
+    wv->vecWv[j] = am * wv->vecWx[j] + dc;
+    wv->vecWl[j] = wv->vecWv[j];
+    return j + 1;
+}
+/*========== OmWavPwl ================*//** Function [85]                    */
+OmInt OmWavPwl(OmWav* wv, OmInt br, OmInt n, OmFlt* t, OmFlt* v, OmFlt per) {
+    OmInt i, j;                         /* used in for-loop, new generator   */
+    if (n < 1) return -1;
+    j = OmWavAdd(wv, OMWAV_PWL, br);
+    if (j < 0) return -1;
+    wv->vecWd[j] = (OmFlt*)OMMALLOC(2 * n * sizeof(OmFlt));
+    for (i=0; i < n; ++i) {
+        wv->vecWd[j][i]   = t[i];
+        wv->vecWd[j][n+i] = v[i];
+    }
+    wv->vecWn[j] = n;
+    wv->vecWp[j] = per;
+    wv->vecWv[j] = OmWavPv(wv, j);
+    wv->vecWl[j] = wv->vecWv[j];
+    return j + 1;
+}
+/*========== OmWavTab ================*//** Function [86]                    */
+OmInt OmWavTab(OmWav* wv, OmInt br, OmInt n, OmFlt* v, OmInt rep) {
+    OmInt i, j;                         /* used in for-loop, new generator   */
+    if (n < 1) return -1;
+    j = OmWavAdd(wv, OMWAV_TAB, br);
+    if (j < 0) return -1;
+    wv->vecWd[j] = (OmFlt*)OMMALLOC(n * sizeof(OmFlt));
+    for (i=0; i < n; ++i) wv->vecWd[j][i] = v[i];
+    wv->vecWn[j] = n;
+    wv->vecWq[j] = (rep != 0);
+    wv->vecWv[j] = v[0];
+    wv->vecWl[j] = v[0];
+    return j + 1;
+}
+/*========== OmWavPwm ================*//** Function [87]                    */
+OmInt OmWavPwm(OmWav* wv, OmInt bs, OmFlt f, OmFlt ph, OmInt ref, OmFlt d,
+               OmInt inv) {
+    OmInt j, s;                         /* new generator, switch state       */
+    OmFlt r;                            /* reference at step 0               */
+    if (ref < 0 || ref > wv->numU) return -1;
+    if (ref > 0 && wv->vecWt[ref-1] == OMWAV_PWM) return -1;
+    if (bs < 1 || OMABS(wv->cir->vecBtm[bs-1]) != OMTYP_SW) return -1;
+    j = OmWavAdd(wv, OMWAV_PWM, bs);
+    if (j < 0) return -1;
+    ph -= (OmInt)ph;                    /* phase in 0.0 to 1.0               */
+    if (ph < 0.0) ph += 1.0;
+    r = (ref > 0) ? d * wv->vecWv[ref-1] : d;
+    s = (r > OmWavTri(ph)) != (inv != 0);
+    wv->vecWn[j] = ref;
+    wv->vecWi[j] = s;
+    wv->vecWx[j] = ph;
+    wv->vecWp[j] = f * wv->cir->timStp;
+    wv->vecWq[j] = (inv != 0);
+    wv->vecWa[j] = d;
+    OmSetSw(wv->cir, bs, s);
+    return j + 1;
+}
+/*========== OmWavRun ================*//** Function [88]                    */
+OmInt OmWavRun(OmWav* wv, OmInt nsw) {
+    OmCir* cr;                          /* circuit of engine                 */
+    OmInt j, r, ne, s;                  /* generator, row, changes, state    */
+    OmInt i, k;                         /* used in for-loop                  */
+    OmFlt x, y, g;                      /* rotated sin / cos, renormalizer   */
+    OmFlt r0, r1, c0, c1, e0, e1, em;   /* reference, carrier, difference    */
+    OmFlt p1, ap, cm, a;                /* phase, break of carrier, instant  */
+    cr = wv->cir;
+    /*======== Step 0: Sources take value of step start, then advance =======*/
+    for (j=0; j < wv->numU; ++j) {
+        if (wv->vecWt[j] == OMWAV_PWM) continue;
+        wv->vecWl[j] = wv->vecWv[j];
+        r = (wv->vecWb[j] > 0) ? cr->vecLut[wv->vecWb[j]-1] : -1;
+        if (r >= 0) cr->vecQs[r] = wv->vecWv[j];
+        switch (wv->vecWt[j]) {
+            case OMWAV_SIN:
+                x = wv->vecWx[j] * wv->vecWp[j] + wv->vecWy[j] * wv->vecWq[j];
+                y = wv->vecWy[j] * wv->vecWp[j] - wv->vecWx[j] * wv->vecWq[j];
+                g = 1.5 - 0.5 * (x * x + y * y);
+                wv->vecWx[j] = g * x;
+                wv->vecWy[j] = g * y;
+                wv->vecWv[j] = wv->vecWa[j] * wv->vecWx[j] + wv->vecWo[j];
+                break;
+            case OMWAV_PWL:
+                wv->vecWx[j] += cr->timStp;
+                if (wv->vecWp[j] > 0.0 && wv->vecWx[j] >= wv->vecWp[j]) {
+                    wv->vecWx[j] -= wv->vecWp[j];
+                    wv->vecWi[j] = 0;
+                }
+                wv->vecWv[j] = OmWavPv(wv, j);
+                break;
+            case OMWAV_TAB:
+                wv->vecWi[j] += 1;
+                if (wv->vecWi[j] >= wv->vecWn[j]) {
+                    wv->vecWi[j] = wv->vecWq[j] != 0.0 ? 0 : wv->vecWn[j] - 1;
+                }
+                wv->vecWv[j] = wv->vecWd[j][wv->vecWi[j]];
+                break;
+            default: break;
+        }
+    }
+    /*======== Step 1: Solve comparators for crossing instant ===============*/
+    ne = 0;
+    for (j=0; j < wv->numU; ++j) {
+        if (wv->vecWt[j] != OMWAV_PWM) continue;
+        r = wv->vecWn[j];
+        r0 = (r > 0) ? wv->vecWa[j] * wv->vecWl[r-1] : wv->vecWa[j];
+        r1 = (r > 0) ? wv->vecWa[j] * wv->vecWv[r-1] : wv->vecWa[j];
+        c0 = OmWavTri(wv->vecWx[j]);
+        p1 = wv->vecWx[j] + wv->vecWp[j];
+        ap = -1.0;                      /* no peak of carrier in step        */
+        cm = 0.0;
+        if (wv->vecWx[j] < 0.5 && p1 > 0.5) {
+            ap = (0.5 - wv->vecWx[j]) / wv->vecWp[j];
+            cm = 1.0;
+        } else if (p1 > 1.0) {
+            ap = (1.0 - wv->vecWx[j]) / wv->vecWp[j];
+            cm = -1.0;
+        }
+        if (p1 >= 1.0) p1 -= 1.0;
+        wv->vecWx[j] = p1;
+        c1 = OmWavTri(p1);
+        e0 = r0 - c0;
+        e1 = r1 - c1;
+        s = (e1 > 0.0) != (wv->vecWq[j] != 0.0);
+        if (s == wv->vecWi[j]) continue;
+        if (ap >= 0.0) {                /* piecewise linear carrier          */
+            em = r0 + ap * (r1 - r0) - cm;
+            if ((em > 0.0) != (e0 > 0.0)) {
+                a = ap * e0 / (e0 - em);
+            } else {
+                a = (em != e1) ? ap + (1.0 - ap) * em / (em - e1) : ap;
+            }
+        } else {
+            a = (e0 != e1) ? e0 / (e0 - e1) : 0.0;
+        }
+        if (a < 0.0) a = 0.0;
+        if (a > 1.0) a = 1.0;
+        wv->vecWi[j] = s;
+        for (k=ne; k > 0 && wv->vecEa[k-1] > a; --k) {
+            wv->vecEb[k] = wv->vecEb[k-1];
+            wv->vecEs[k] = wv->vecEs[k-1];
+            wv->vecEa[k] = wv->vecEa[k-1];
+        }
+        wv->vecEb[k] = wv->vecWb[j];    /* keep changes sorted by instant    */
+        wv->vecEs[k] = s;
+        wv->vecEa[k] = a;
+        ne += 1;
+    }
+    /*======== Step 2: Step circuit, split at each distinct instant =========*/
+    if (ne == 0) {
+        OmUpdCr(cr);
+        return 0;
+    }
+    p1 = 0.0;                           /* instant reached in step           */
+    for (k=0; k < ne; k=i) {
+        a = wv->vecEa[k];
+        OmEvSeg(cr, a - p1, wv->vecE);
+        for (i=k; i < ne && wv->vecEa[i] == a; ++i) {
+            OmSetSw(cr, wv->vecEb[i], wv->vecEs[i]);
+        }
+        for (j=0; j < nsw; ++j) OmUpdSw(cr);
+        p1 = a;
+    }
+    OmEvSeg(cr, 1.0 - p1, wv->vecE);
+    return ne;
+}
+/*========== OmBatNew ================*//** Function [89]                    */
+OmBat* OmBatNew(OmCir* cr, OmInt nk) {
+    OmBat* bt;                          /* new batch                         */
+    OmInt m, c, i, k;                   /* numM, numC, used in for-loop      */
+    if (cr == NULL || cr->matC == NULL || nk < 1) return NULL;
+    if (cr->vecQb != NULL) return NULL; /* BDF2 history is not batched       */
+    m = cr->numM;
+    c = cr->numC;
+    bt = (OmBat*)OMMALLOC(sizeof(OmBat));
+    if (bt == NULL) return NULL;
+    bt->cir    = cr;
+    bt->numK   = nk;
+    cr->numR  += 1;                     /* keep operator alive               */
+    bt->matW1m = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    bt->matW2m = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    bt->matW1s = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    bt->matW2s = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    bt->matQa  = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    bt->matQs  = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    bt->matQtp = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    bt->matXm  = (OmFlt*)OMMALLOC((m * nk + 1) * sizeof(OmFlt));
+    bt->matXc  = (OmFlt*)OMMALLOC((c * nk + 1) * sizeof(OmFlt));
+    if (bt->matW1m == NULL || bt->matW2m == NULL || bt->matW1s == NULL
+        || bt->matW2s == NULL || bt->matQa == NULL || bt->matQs == NULL
+        || bt->matQtp == NULL || bt->matXm == NULL || bt->matXc == NULL) {
+        OmBatDel(bt);                   /* drops the reference again         */
+        return NULL;
+    }
+    for (i=0; i < c; ++i) {             /* broadcast current state of cr     */
+        for (k=0; k < nk; ++k) {
+            bt->matW1m[i*nk+k] = cr->vecW1m[i];
+            bt->matW2m[i*nk+k] = cr->vecW2m[i];
+            bt->matW1s[i*nk+k] = cr->vecW1s[i];
+            bt->matW2s[i*nk+k] = cr->vecW2s[i];
+            bt->matQa [i*nk+k] = cr->vecQa [i];
+            bt->matQs [i*nk+k] = cr->vecQs [i];
+            bt->matQtp[i*nk+k] = cr->vecQtp[i];
+            bt->matXc [i*nk+k] = cr->vecXc [i];
+        }
+    }
+    for (i=0; i < m; ++i) {
+        for (k=0; k < nk; ++k) bt->matXm[i*nk+k] = cr->vecXm[i];
+    }
+    return bt;
+}
+/*========== OmBatDel ================*//** Function [90]                    */
+void OmBatDel(OmBat* bt) {
+    if (bt == NULL) return;
+    OMFREE(bt->matW1m);
+    OMFREE(bt->matW2m);
+    OMFREE(bt->matW1s);
+    OMFREE(bt->matW2s);
+    OMFREE(bt->matQa );
+    OMFREE(bt->matQs );
+    OMFREE(bt->matQtp);
+    OMFREE(bt->matXm );
+    OMFREE(bt->matXc );
+    OmDelete(bt->cir);                  /* drop reference, maybe last one    */
+    OMFREE(bt);
+}
+/*========== OmBatReset ==============*//** Function [91]                    */
+void OmBatReset(OmBat* bt) {
+    OmCir* cr;                          /* shared circuit                    */
+    OmInt i, k, nk, ilut;               /* used in for-loop, numK, lut value */
+    OmFlt w1s, w2s;                     /* switch weights of UpdSw()         */
+    cr = bt->cir;
+    nk = bt->numK;
+    for (i=0; i < cr->numB; ++i) {
+        ilut = cr->vecLut[i];
+        if (ilut < 0) continue;         /* cut branch                        */
+        if (OMABS(cr->vecBtm[i]) == OMTYP_SW) {
+            w1s = cr->vecW1o[i];
+            w2s = cr->vecW2o[i];
+        } else {
+            w1s = 0.0;
+            w2s = 1.0;                  /* keep other branch Qa unchanged    */
+        }
+        for (k=0; k < nk; ++k) {
+            bt->matW1m[ilut*nk+k] = cr->vecW1o[i];
+            bt->matW2m[ilut*nk+k] = cr->vecW2o[i];
+            bt->matW1s[ilut*nk+k] = w1s;
+            bt->matW2s[ilut*nk+k] = w2s;
+            bt->matQa [ilut*nk+k] = cr->vecQa0[i];
+            bt->matQs [ilut*nk+k] = cr->vecQs0[i];
+            bt->matQtp[ilut*nk+k] = cr->vecQa0[i] + cr->vecQs0[i];
+        }
+    }
+}
+/*========== OmBatSetQs ==============*//** Function [92]                    */
+void OmBatSetQs(OmBat* bt, OmInt k, OmInt br, OmFlt x) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = bt->cir->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    bt->matQs[ilut*bt->numK+k-1] = x;
+}
+/*========== OmBatSetSw ==============*//** Function [93]                    */
+void OmBatSetSw(OmBat* bt, OmInt k, OmInt br, OmInt s) {
+    OmCir* cr;                          /* shared circuit                    */
+    OmInt j;                            /* index in state matrices           */
+    cr = bt->cir;
+    if (cr->vecLut[br-1] < 0) return;   /* cut branch                        */
+    j = cr->vecLut[br-1] * bt->numK + k - 1;
+    bt->matW1m[j] = (s == 0) ? cr->vecW1o[br-1] : cr->vecW1c[br-1];
+    bt->matW2m[j] = (s == 0) ? cr->vecW2o[br-1] : cr->vecW2c[br-1];
+    bt->matW1s[j] = bt->matW1m[j];
+    bt->matW2s[j] = bt->matW2m[j];
+}
+/*========== OmBatMul ================*//** Helper of Function [94]          */
+static void OmBatMul(OmInt m, OmInt c, OmInt nk, OmFlt* y, OmFlt* a,
+                     OmFlt* x) {
+    OmInt i, j, k;                      /* used in for-loop                  */
+    OmInt jb, kb, je, ke;               /* block start and end               */
+    OmFlt aij;                          /* element of A                      */
+    OmFlt* yi;                          /* row i of Y                        */
+    OmFlt* xj;                          /* row j of X                        */
+    if (omBk != NULL && omBk->matGmm != NULL && m >= omBk->minM) {
+        omBk->matGmm(m, nk, c, y, a, x);
+        return;
+    }
+    for (i=0; i < m * nk; ++i) y[i] = 0.0;
+    for (kb=0; kb < nk; kb += OMBAT_BLK) {
+        ke = (kb + OMBAT_BLK < nk) ? kb + OMBAT_BLK : nk;
+        for (jb=0; jb < c; jb += OMBAT_BLK) {
+            je = (jb + OMBAT_BLK < c) ? jb + OMBAT_BLK : c;
+            for (i=0; i < m; ++i) {     /* X block stays in cache            */
+                yi = y + i * nk;
+                for (j=jb; j < je; ++j) {
+                    aij = a[i*c+j];
+                    xj = x + j * nk;
+                    for (k=kb; k < ke; ++k) yi[k] += aij * xj[k];
+                }
+            }
+        }
+    }
+}
+/*========== OmBatSpm ================*//** Helper of Function [94]          */
+static void OmBatSpm(OmInt m, OmInt nk, OmFlt* y, OmInt* p, OmInt* ci,
+                     OmFlt* v, OmFlt* x) {
+    OmInt i, j, k;                      /* used in for-loop                  */
+    OmFlt* yi;                          /* row i of Y                        */
+    OmFlt* xj;                          /* row ci[j] of X                    */
+    for (i=0; i < m; ++i) {
+        yi = y + i * nk;
+        for (k=0; k < nk; ++k) yi[k] = 0.0;
+        for (j=p[i]; j < p[i+1]; ++j) {
+            xj = x + ci[j] * nk;
+            for (k=0; k < nk; ++k) yi[k] += v[j] * xj[k];
+        }
+    }
+}
+/*========== OmBatStep ===============*//** Helper of Function [94]          */
+static void OmBatStep(OmBat* bt, OmFlt* w1, OmFlt* w2) {
+    OmCir* cr;                          /* shared circuit                    */
+    OmInt c;                            /* numC * numK                       */
+    cr = bt->cir;
+    c = cr->numC * bt->numK;
+    OmVecAdd(c, bt->matQtp, bt->matQa, bt->matQs);
+    if (cr->vecCp != NULL) {            /* sparse runtime form               */
+        OmBatSpm(cr->numC, bt->numK, bt->matXc, cr->vecCp, cr->vecCi,
+                 cr->vecCv, bt->matQtp);
+    } else {
+        OmBatMul(cr->numC, cr->numC, bt->numK, bt->matXc, cr->matC,
+                 bt->matQtp);
+    }
+    OmVecFma(c, bt->matQa, w1, bt->matXc, w2);
+}
+/*========== OmBatUpdSw ==============*//** Function [94]                    */
+void OmBatUpdSw(OmBat* bt) {
+    OmBatStep(bt, bt->matW1s, bt->matW2s);
+}
+/*========== OmBatUpdCr ==============*//** Function [95]                    */
+void OmBatUpdCr(OmBat* bt) {
+    OmBatStep(bt, bt->matW1m, bt->matW2m);
+}
+/*========== OmBatUpdMt ==============*//** Function [96]                    */
+void OmBatUpdMt(OmBat* bt) {
+    OmCir* cr;                          /* shared circuit                    */
+    cr = bt->cir;
+    if (cr->vecDp != NULL) {            /* sparse runtime form               */
+        OmBatSpm(cr->numM, bt->numK, bt->matXm, cr->vecDp, cr->vecDi,
+                 cr->vecDv, bt->matQtp);
+    } else {
+        OmBatMul(cr->numM, cr->numC, bt->numK, bt->matXm, cr->matD,
+                 bt->matQtp);
+    }
+}
+/*========== OmBatGetMt ==============*//** Function [97]                    */
+OmFlt OmBatGetMt(OmBat* bt, OmInt k, OmInt mt) {
+    return bt->matXm[(mt-1)*bt->numK+k-1];
+}
+/*========== OmBatGetXc ==============*//** Function [98]                    */
+OmFlt OmBatGetXc(OmBat* bt, OmInt k, OmInt br) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = bt->cir->vecLut[br-1];
+    if (ilut < 0) return 0.0;           /* cut branch                        */
+    return bt->matXc[ilut*bt->numK+k-1];
+}
+/*========== OmEnsDot ================*//** Helper of Function [99]          */
+static void OmEnsDot(OmFlt* d, OmFlt* x, OmInt sx, OmFlt* y, OmInt sy,
+                     OmInt n, OmInt sub) {
+    OmInt k, l;                         /* used in for-loop, lane            */
+    OmFlt t[OMENS_LN];                  /* d of lanes, kept in registers     */
+    for (l=0; l < OMENS_LN; ++l) t[l] = d[l];
+    if (sub) {                          /* d -= x[k] * y[k], k ascending     */
+        for (k=0; k < n; ++k) {
+            for (l=0; l < OMENS_LN; ++l) t[l] -= x[k*sx+l] * y[k*sy+l];
+        }
+    } else {                            /* d += x[k] * y[k], k ascending     */
+        for (k=0; k < n; ++k) {
+            for (l=0; l < OMENS_LN; ++l) t[l] += x[k*sx+l] * y[k*sy+l];
+        }
+    }
+    for (l=0; l < OMENS_LN; ++l) d[l] = t[l];
+}
+/*========== OmEnsAxp ================*//** Helper of Function [99]          */
+static void OmEnsAxp(OmFlt* d, OmFlt s, OmFlt* x) {
+    OmInt l;                            /* lane                              */
+    for (l=0; l < OMENS_LN; ++l) d[l] += s * x[l];
+}
+/*========== OmEnsSet ================*//** Helper of Function [99]          */
+static void OmEnsSet(OmFlt* d, OmFlt* x, OmFlt v) {
+    OmInt l;                            /* lane                              */
+    for (l=0; l < OMENS_LN; ++l) d[l] = (x != NULL) ? x[l] : v;
+}
+/*========== OmEnsLu =================*//** Helper of Function [99]          */
+static void OmEnsLu(OmInt m, OmFlt* a, OmFlt* lu, OmInt* pm) {
+    OmInt i, j, k, l;                   /* used in for-loop, lane            */
+    OmInt L;                            /* OMENS_LN                          */
+    OmFlt* d;                           /* element updated in all lanes      */
+    L = OMENS_LN;                       /* same steps as OmMatLuInv()        */
+    /*======== Step 1: Apply row permutation pm =============================*/
+    for (i=0; i < m; ++i) {
+        for (j=0; j < m; ++j) OmEnsSet(lu+(i*m+j)*L, a+(pm[i]*m+j)*L, 0.0);
+    }
+    /*======== Step 2: LU decomposition (save both L & U in lu) =============*/
+    for (i=0; i < m; ++i) {
+        for (j=i; j < m; ++j) {
+            OmEnsDot(lu+(i*m+j)*L, lu+i*m*L, L, lu+j*L, m*L, i, 1);
+        }
+        for (k=i+1; k < m; ++k) {
+            d = lu + (k*m+i) * L;
+            OmEnsDot(d, lu+k*m*L, L, lu+i*L, m*L, i, 1);
+            for (l=0; l < L; ++l) d[l] /= lu[(i*m+i)*L+l];
+        }
+    }
+    /*======== Step 3: LU inversion (save both L^-1 & U^-1 in a) ============*/
+    for (i=0; i < m * m * L; ++i) a[i] = 0.0;
+    for (i=0; i < m; ++i) {
+        OmEnsSet(a+(i*m+i)*L, NULL, 1.0);
+        for (k=i+1; k < m; ++k) {
+            OmEnsDot(a+(k*m+i)*L, lu+(k*m+i)*L, L, a+(i*m+i)*L, m*L, k-i, 1);
+        }
+        d = a + (i*m+i) * L;
+        for (l=0; l < L; ++l) d[l] = 1.0 / lu[(i*m+i)*L+l];
+        for (k=i-1; k >= 0; --k) {
+            d = a + (k*m+i) * L;
+            OmEnsDot(d, lu+(k*m+k+1)*L, L, a+((k+1)*m+i)*L, m*L, i-k, 1);
+            for (l=0; l < L; ++l) d[l] /= lu[(k*m+k)*L+l];
+        }
+    }
+    /*======== Step 4: Calculate G^-1 = U^-1 * L^-1 (save in lu) ============*/
+    for (i=0; i < m; ++i) {
+        for (j=0; j < i; ++j) OmEnsSet(lu+(i*m+j)*L, NULL, 0.0);
+        for (j=i; j < m; ++j) OmEnsSet(lu+(i*m+j)*L, a+(i*m+j)*L, 0.0);
+    }
+    for (i=1; i < m; ++i) {             /* lower part, k ascending           */
+        for (j=0; j < i; ++j) {
+            OmEnsDot(lu+(i*m+j)*L, a+(i*m+i)*L, L, a+(i*m+j)*L, m*L, m-i, 0);
+        }
+    }
+    for (i=0; i < m; ++i) {             /* upper part, k ascending           */
+        for (j=i; j < m; ++j) {
+            OmEnsDot(lu+(i*m+j)*L, a+(i*m+j+1)*L, L, a+((j+1)*m+j)*L, m*L,
+                     m-j-1, 0);
+        }
+    }
+    /*======== Step 5: Permute column back (save in a) ======================*/
+    for (i=0; i < m; ++i) {
+        for (j=0; j < m; ++j) OmEnsSet(a+(i*m+pm[j])*L, lu+(i*m+j)*L, 0.0);
+    }
+}
+/*========== OmEnsMul ================*//** Helper of Function [99]          */
+static void OmEnsMul(OmInt m, OmFlt* c, OmFlt* a, OmFlt* b) {
+    OmInt i, j;                         /* used in for-loop                  */
+    OmInt L;                            /* OMENS_LN                          */
+    L = OMENS_LN;                       /* same order as OmMatMul()          */
+    for (i=0; i < m * m * L; ++i) c[i] = 0.0;
+    for (i=0; i < m; ++i) {             /* c[i,j] sums k ascending           */
+        for (j=0; j < m; ++j) {
+            OmEnsDot(c+(i*m+j)*L, a+i*m*L, L, b+j*L, m*L, m, 0);
+        }
+    }
+}
+/*========== OmEnsTp =================*//** Helper of Function [99]          */
+static void OmEnsTp(OmCir* cr, OmInt* lut, OmFlt* ws, OmFlt* pa, OmFlt* pb) {
+    OmInt n, b, m, x;                   /* numN, numB, numM, numX            */
+    OmInt i, j, l, L;                   /* used in for-loop, OMENS_LN        */
+    OmInt ilut, jlut, n1, n2;           /* lookup table value, nodes         */
+    OmFlt *matPn, *matPtp, *matTtp;     /* same slices as OmStmTp(), x LN    */
+    OmFlt *matRtp, *matCtp, *matDtp;
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    x = cr->numX;
+    L = OMENS_LN;
+    matPn  = ws;
+    matPtp = matPn  + (2 * (n+x) * (n+x) + (n+x)) * L;
+    matTtp = matPtp + (n+x) * b * L;
+    matRtp = matTtp + b * b * L;
+    matCtp = matRtp + b * b * L;
+    matDtp = matCtp + b * b * L;
+    /*======== Step 1: Calculate Ptp = (Pn^-1)(Tn) ==========================*/
+    for (i=0; i < (n+x) * b * L; ++i) matPtp[i] = 0.0;
+    for (i=0; i < n+x; ++i) {
+        for (j=0; j < b; ++j) {
+            jlut = lut[j];
+            n1 = cr->vecBn1[j];
+            n2 = cr->vecBn2[j];
+            if (jlut > 0) {
+                if (n1 >= 0) OmEnsAxp(matPtp+(i*b+j)*L, -1.0,
+                                      matPn+(i*(n+x)+n1)*L);
+                if (n2 >= 0) OmEnsAxp(matPtp+(i*b+j)*L, 1.0,
+                                      matPn+(i*(n+x)+n2)*L);
+            } else {
+                OmEnsAxp(matPtp+(i*b+j)*L, 1.0, matPn+(i*(n+x)+(n-jlut))*L);
+            }
+        }
+    }
+    /*======== Step 2: Calculate Ttp, Rtp, Ctp, Dtp =========================*/
+    for (i=0; i < b * b * L; ++i) matTtp[i] = 0.0;
+    for (i=0; i < m * b * L; ++i) matDtp[i] = 0.0;
+    for (i=0; i < b; ++i) {
+        ilut = lut[i];
+        n1 = cr->vecBn1[i];
+        n2 = cr->vecBn2[i];
+        for (j=0; j < b; ++j) {
+            if (ilut <= 0) {
+                OmEnsAxp(matTtp+(i*b+j)*L, 1.0, matPtp+((n-ilut)*b+j)*L);
+                continue;
+            }
+            if (n1 >= 0) OmEnsAxp(matTtp+(i*b+j)*L, 1.0, matPtp+(n1*b+j)*L);
+        }
+        for (j=0; ilut > 0 && n2 >= 0 && j < b; ++j) {
+            OmEnsAxp(matTtp+(i*b+j)*L, -1.0, matPtp+(n2*b+j)*L);
+        }
+    }
+    OmEnsMul(b, matCtp, pa, matTtp);
+    OmEnsMul(b, matRtp, pb, matTtp);
+    for (i=0; i < b; ++i) {
+        for (l=0; l < L; ++l) matRtp[(i*b+i)*L+l] += 1.0;
+    }
+    for (i=0; i < m; ++i) {
+        n1 = cr->vecMn1[i];
+        n2 = cr->vecMn2[i];
+        for (j=0; j < b; ++j) {
+            if (n2 < -1) {              /* ammeter                           */
+                ilut = lut[n1];
+                if (ilut > 0) {
+                    OmEnsAxp(matDtp+(i*b+j)*L, 1.0, matRtp+(n1*b+j)*L);
+                } else {
+                    OmEnsAxp(matDtp+(i*b+j)*L, 1.0,
+                             matPtp+((n-ilut)*b+j)*L);
+                }
+                continue;
+            }
+            if (n1 >= 0) OmEnsAxp(matDtp+(i*b+j)*L, 1.0, matPtp+(n1*b+j)*L);
+        }
+        for (j=0; n2 >= 0 && j < b; ++j) {
+            OmEnsAxp(matDtp+(i*b+j)*L, -1.0, matPtp+(n2*b+j)*L);
+        }
+    }
+}
+/*========== OmEnsCut ================*//** Helper of Function [99]          */
+static void OmEnsCut(OmEns* en, OmInt p, OmInt l, OmFlt* ctp, OmFlt* dtp,
+                     OmInt st) {
+    OmInt b, m, c, L;                   /* numB, numM, numC, OMENS_LN        */
+    OmInt i, j, ilut, jlut;             /* used in for-loop, lookup value    */
+    b = en->numB;
+    m = en->numM;
+    c = en->numC;
+    L = OMENS_LN;
+    for (j=0; j < b; ++j) {             /* build D of lane                   */
+        jlut = en->vecLut[j];
+        if (jlut < 0) continue;
+        for (i=0; i < m; ++i) {
+            en->matD[((p*m+i)*c+jlut)*L+l] = dtp[(i*b+j)*st];
+        }
+    }
+    for (i=0; i < b; ++i) {             /* build C of lane                   */
+        ilut = en->vecLut[i];
+        if (ilut < 0) continue;
+        for (j=0; j < b; ++j) {
+            jlut = en->vecLut[j];
+            if (jlut < 0) continue;
+            en->matC[((p*c+ilut)*c+jlut)*L+l] = ctp[(i*b+j)*st];
+        }
+    }
+}
+/*========== OmEnsTop ================*//** Helper of Function [99]          */
+static OmInt OmEnsTop(OmCir* c0, OmCir* cr) {
+    OmInt i;                            /* used in for-loop                  */
+    if (cr->matC != NULL || cr->numN != c0->numN || cr->numB != c0->numB ||
+        cr->numM != c0->numM || cr->numX != c0->numX) return 0;
+    for (i=0; i < c0->numB; ++i) {
+        if (cr->vecBn1[i] != c0->vecBn1[i] || cr->vecBn2[i] != c0->vecBn2[i]
+            || cr->vecBtm[i] != c0->vecBtm[i]
+            || cr->vecLut[i] != c0->vecLut[i]) return 0;
+    }
+    for (i=0; i < c0->numM; ++i) {
+        if (cr->vecMn1[i] != c0->vecMn1[i] ||
+            cr->vecMn2[i] != c0->vecMn2[i]) return 0;
+    }
+    return 1;
+}
+/*========== OmEnsNew ================*//** Function [99]                    */
+OmEns* OmEnsNew(OmCir** crs, OmInt ne) {
+    OmEns* en;                          /* new ensemble                      */
+    OmCir* cr;                          /* circuit of current lane           */
+    OmInt n, b, m, x, c, nx, L, P;      /* sizes, OMENS_LN, number of packs  */
+    OmInt i, p, l, e, btyp;             /* used in for-loop, branch type     */
+    OmInt *pmv, *odd;                   /* pivot orders of lanes, odd lanes  */
+    OmInt r, nr, mr;                    /* reference lane, matches, best     */
+    OmFlt *ws, *w1, *pa, *pb;           /* lane scratch, scalar scratch      */
+    OmFlt *ctp, *dtp;                   /* Ctp / Dtp slices of scratch       */
+    OmInt k;                            /* index of lane in [P,b,LN]         */
+    /*======== Step 0: Check topology and allocate ensemble =================*/
+    if (crs == NULL || ne < 1) return NULL;
+    for (e=1; e < ne; ++e) if (!OmEnsTop(crs[0], crs[e])) return NULL;
+    if (crs[0]->matC != NULL) return NULL;
+    for (e=0; e < ne; ++e) {            /* no BDF2 history, no tuning in lane*/
+        for (i=0; i < crs[0]->numB; ++i) {
+            if (crs[e]->vecBd[i] || crs[e]->vecTa[i]) return NULL;
+        }
+    }
+    cr = crs[0];
+    n = cr->numN;
+    b = cr->numB;
+    m = cr->numM;
+    x = cr->numX;
+    nx = n + x;
+    L = OMENS_LN;
+    P = (ne + L - 1) / L;
+    c = 0;
+    en = (OmEns*)OMMALLOC(sizeof(OmEns));
+    en->vecBtm = (OmInt*)OMMALLOC((b + 1) * sizeof(OmInt));
+    en->vecLut = (OmInt*)OMMALLOC((b + 1) * sizeof(OmInt));
+    for (i=0; i < b; ++i) {             /* kept rows, like OmStamp() step 3  */
+        en->vecBtm[i] = cr->vecBtm[i];
+        btyp = OMABS(cr->vecBtm[i]);
+        en->vecLut[i] = (btyp == OMTYP_X0 || btyp == OMTYP_Y0) ? -1 : c++;
+    }
+    en->numE = ne;
+    en->numP = P;
+    en->numB = b;
+    en->numM = m;
+    en->numC = c;
+    en->numF = 0;
+    en->vecW1c = (OmFlt*)OMMALLOC((P * b * L + 1) * sizeof(OmFlt));
+    en->vecW2c = (OmFlt*)OMMALLOC((P * b * L + 1) * sizeof(OmFlt));
+    en->vecW1o = (OmFlt*)OMMALLOC((P * b * L + 1) * sizeof(OmFlt));
+    en->vecW2o = (OmFlt*)OMMALLOC((P * b * L + 1) * sizeof(OmFlt));
+    en->vecQa0 = (OmFlt*)OMMALLOC((P * b * L + 1) * sizeof(OmFlt));
+    en->vecQs0 = (OmFlt*)OMMALLOC((P * b * L + 1) * sizeof(OmFlt));
+    en->matC   = (OmFlt*)OMMALLOC((P * c * c * L + 1) * sizeof(OmFlt));
+    en->matD   = (OmFlt*)OMMALLOC((P * m * c * L + 1) * sizeof(OmFlt));
+    en->vecW1m = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    en->vecW2m = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    en->vecW1s = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    en->vecW2s = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    en->vecQa  = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    en->vecQs  = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    en->vecQtp = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    en->vecXm  = (OmFlt*)OMMALLOC((P * m * L + 1) * sizeof(OmFlt));
+    en->vecXc  = (OmFlt*)OMMALLOC((P * c * L + 1) * sizeof(OmFlt));
+    ws  = (OmFlt*)OMMALLOC((OmStampSz(cr) * L) * sizeof(OmFlt));
+    w1  = (OmFlt*)OMMALLOC(OmStampSz(cr) * sizeof(OmFlt));
+    pa  = (OmFlt*)OMMALLOC((b * b * L + 1) * sizeof(OmFlt));
+    pb  = (OmFlt*)OMMALLOC((b * b * L + 1) * sizeof(OmFlt));
+    pmv = (OmInt*)OMMALLOC((nx * L + 1) * sizeof(OmInt));
+    odd = (OmInt*)OMMALLOC(L * sizeof(OmInt));
+    ctp = ws + (2 * nx * nx + nx + nx * b + 2 * b * b) * L;
+    dtp = ctp + b * b * L;
+    for (p=0; p < P; ++p) {
+        /*======== Step 1: Assemble Pn of every lane, check pivot order =====*/
+        for (l=0; l < L; ++l) {
+            e = (p * L + l < ne) ? p * L + l : ne - 1;
+            cr = crs[e];
+            OmStmPn(cr, cr->vecLut, w1);
+            OmMatPiv(nx, w1, pmv + l * nx);
+            for (i=0; i < nx * nx; ++i) ws[i*L+l] = w1[i];
+            for (i=0; i < b * b; ++i) {
+                pa[i*L+l] = cr->matPa[i];
+                pb[i*L+l] = cr->matPb[i];
+            }
+        }
+        /*======== Step 2: Invert and multiply across lanes =================*/
+        r = 0;
+        mr = -1;
+        for (l=0; l < L; ++l) {         /* order shared by most lanes        */
+            nr = 0;
+            for (k=0; k < L; ++k) {
+                for (i=0; i < nx && pmv[l*nx+i] == pmv[k*nx+i]; ++i);
+                nr += (i == nx);
+            }
+            if (nr > mr) {
+                mr = nr;
+                r = l;
+            }
+        }
+        for (l=0; l < L; ++l) {
+            for (i=0; i < nx && pmv[l*nx+i] == pmv[r*nx+i]; ++i);
+            odd[l] = (i < nx);
+        }
+        OmEnsLu(nx, ws, ws + nx * nx * L, pmv + r * nx);
+        OmEnsTp(crs[0], crs[0]->vecLut, ws, pa, pb);
+        for (l=0; l < L; ++l) OmEnsCut(en, p, l, ctp + l, dtp + l, L);
+        /*======== Step 3: Stamp lanes with other pivot order alone =========*/
+        for (l=0; l < L; ++l) {
+            if (!odd[l]) continue;
+            e = (p * L + l < ne) ? p * L + l : ne - 1;
+            cr = crs[e];
+            OmStmPn(cr, cr->vecLut, w1);
+            OmMatInvWs(nx, w1, w1 + nx * nx);
+            OmStmTp(cr, cr->vecLut, w1);
+            OmEnsCut(en, p, l, w1 + (ctp - ws) / L, w1 + (dtp - ws) / L, 1);
+            if (p * L + l < ne) en->numF += 1;
+        }
+        /*======== Step 4: Interleave reset information =====================*/
+        for (l=0; l < L; ++l) {
+            e = (p * L + l < ne) ? p * L + l : ne - 1;
+            cr = crs[e];
+            for (i=0; i < b; ++i) {
+                k = (p * b + i) * L + l;
+                en->vecW1c[k] = cr->vecW1c[i];
+                en->vecW2c[k] = cr->vecW2c[i];
+                en->vecW1o[k] = cr->vecW1o[i];
+                en->vecW2o[k] = cr->vecW2o[i];
+                en->vecQa0[k] = cr->vecQa0[i];
+                en->vecQs0[k] = cr->vecQs0[i];
+            }
+        }
+    }
+    OMFREE(ws);
+    OMFREE(w1);
+    OMFREE(pa);
+    OMFREE(pb);
+    OMFREE(pmv);
+    OMFREE(odd);
+    OmEnsReset(en);
+    return en;
+}
+/*========== OmEnsDel ================*//** Function [100]                   */
+void OmEnsDel(OmEns* en) {
+    if (en == NULL) return;
+    OMFREE(en->vecBtm);
+    OMFREE(en->vecLut);
+    OMFREE(en->vecW1c);
+    OMFREE(en->vecW2c);
+    OMFREE(en->vecW1o);
+    OMFREE(en->vecW2o);
+    OMFREE(en->vecQa0);
+    OMFREE(en->vecQs0);
+    OMFREE(en->matC  );
+    OMFREE(en->matD  );
+    OMFREE(en->vecW1m);
+    OMFREE(en->vecW2m);
+    OMFREE(en->vecW1s);
+    OMFREE(en->vecW2s);
+    OMFREE(en->vecQa );
+    OMFREE(en->vecQs );
+    OMFREE(en->vecQtp);
+    OMFREE(en->vecXm );
+    OMFREE(en->vecXc );
+    OMFREE(en);
+}
+/*========== OmEnsReset ==============*//** Function [101]                   */
+void OmEnsReset(OmEns* en) {
+    OmInt b, c, L;                      /* numB, numC, OMENS_LN              */
+    OmInt p, i, l, ilut, sw;            /* used in for-loop, lut, is SW      */
+    OmInt r, k;                         /* lane index in [P,c] and [P,b]     */
+    b = en->numB;
+    c = en->numC;
+    L = OMENS_LN;
+    for (p=0; p < en->numP; ++p) {
+        for (i=0; i < b; ++i) {
+            ilut = en->vecLut[i];
+            if (ilut < 0) continue;     /* cut branch                        */
+            sw = (OMABS(en->vecBtm[i]) == OMTYP_SW);
+            for (l=0; l < L; ++l) {
+                r = (p * c + ilut) * L + l;
+                k = (p * b + i) * L + l;
+                en->vecW1m[r] = en->vecW1o[k];
+                en->vecW2m[r] = en->vecW2o[k];
+                en->vecQa [r] = en->vecQa0[k];
+                en->vecQs [r] = en->vecQs0[k];
+                en->vecW1s[r] = sw ? en->vecW1o[k] : 0.0;
+                en->vecW2s[r] = sw ? en->vecW2o[k] : 1.0;
+                en->vecQtp[r] = en->vecQa[r] + en->vecQs[r];
+            }
+        }
+    }
+}
+/*========== OmEnsSetQs ==============*//** Function [102]                   */
+void OmEnsSetQs(OmEns* en, OmInt e, OmInt br, OmFlt x) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = en->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    en->vecQs[(((e-1) / OMENS_LN) * en->numC + ilut) * OMENS_LN
+              + (e-1) % OMENS_LN] = x;
+}
+/*========== OmEnsSetSw ==============*//** Function [103]                   */
+void OmEnsSetSw(OmEns* en, OmInt e, OmInt br, OmInt s) {
+    OmInt ilut, p, l, r, k;             /* lut, pack, lane, indices          */
+    ilut = en->vecLut[br-1];
+    if (ilut < 0) return;               /* cut branch                        */
+    p = (e-1) / OMENS_LN;
+    l = (e-1) % OMENS_LN;
+    r = (p * en->numC + ilut) * OMENS_LN + l;
+    k = (p * en->numB + br - 1) * OMENS_LN + l;
+    en->vecW1m[r] = (s == 0) ? en->vecW1o[k] : en->vecW1c[k];
+    en->vecW2m[r] = (s == 0) ? en->vecW2o[k] : en->vecW2c[k];
+    en->vecW1s[r] = en->vecW1m[r];
+    en->vecW2s[r] = en->vecW2m[r];
+}
+/*========== OmEnsMv =================*//** Helper of Function [104]         */
+static void OmEnsMv(OmInt m, OmInt c, OmFlt* y, OmFlt* a, OmFlt* x) {
+    OmInt i, l;                         /* used in for-loop, lane            */
+    OmFlt sum[OMENS_LN];                /* sums of lanes, OmVecMul() order   */
+    for (i=0; i < m; ++i) {
+        for (l=0; l < OMENS_LN; ++l) sum[l] = 0.0;
+        OmEnsDot(sum, a + i * c * OMENS_LN, OMENS_LN, x, OMENS_LN, c, 0);
+        for (l=0; l < OMENS_LN; ++l) y[i*OMENS_LN+l] = sum[l];
+    }
+}
+/*========== OmEnsStep ===============*//** Helper of Function [104]         */
+static void OmEnsStep(OmEns* en, OmFlt* w1, OmFlt* w2) {
+    OmInt c, n, p;                      /* numC, lanes of a pack, pack       */
+    c = en->numC;
+    n = c * OMENS_LN;
+    for (p=0; p < en->numP; ++p) {
+        OmVecAdd(n, en->vecQtp + p*n, en->vecQa + p*n, en->vecQs + p*n);
+        OmEnsMv(c, c, en->vecXc + p*n, en->matC + p*c*n, en->vecQtp + p*n);
+        OmVecFma(n, en->vecQa + p*n, w1 + p*n, en->vecXc + p*n, w2 + p*n);
+    }
+}
+/*========== OmEnsUpdSw ==============*//** Function [104]                   */
+void OmEnsUpdSw(OmEns* en) {
+    OmEnsStep(en, en->vecW1s, en->vecW2s);
+}
+/*========== OmEnsUpdCr ==============*//** Function [105]                   */
+void OmEnsUpdCr(OmEns* en) {
+    OmEnsStep(en, en->vecW1m, en->vecW2m);
+}
+/*========== OmEnsUpdMt ==============*//** Function [106]                   */
+void OmEnsUpdMt(OmEns* en) {
+    OmInt m, c, p;                      /* numM, numC, pack                  */
+    m = en->numM;
+    c = en->numC;
+    for (p=0; p < en->numP; ++p) {
+        OmEnsMv(m, c, en->vecXm + p * m * OMENS_LN,
+                en->matD + p * m * c * OMENS_LN,
+                en->vecQtp + p * c * OMENS_LN);
+    }
+}
+/*========== OmEnsGetMt ==============*//** Function [107]                   */
+OmFlt OmEnsGetMt(OmEns* en, OmInt e, OmInt mt) {
+    return en->vecXm[(((e-1) / OMENS_LN) * en->numM + mt - 1) * OMENS_LN
+                     + (e-1) % OMENS_LN];
+}
+/*========== OmEnsGetXc ==============*//** Function [108]                   */
+OmFlt OmEnsGetXc(OmEns* en, OmInt e, OmInt br) {
+    OmInt ilut;                         /* lookup table value                */
+    ilut = en->vecLut[br-1];
+    if (ilut < 0) return 0.0;           /* cut branch                        */
+    return en->vecXc[(((e-1) / OMENS_LN) * en->numC + ilut) * OMENS_LN
+                     + (e-1) % OMENS_LN];
+}
+/*========== OmAdvKey ================*//** Helper of Function [109]         */
+static OmInt OmAdvKey(OmCir* cr) {
+    OmInt c, i;                         /* numC, used in for-loop            */
+    c = cr->numC;
+    for (i=0; i < c; ++i) {             /* G depends on W1m, W2m and Qs      */
+        if (cr->vecPk[0*c+i] != cr->vecW1m[i]) return 0;
+        if (cr->vecPk[1*c+i] != cr->vecW2m[i]) return 0;
+        if (cr->vecPk[2*c+i] != cr->vecQs[i] ) return 0;
+    }
+    return 1;
+}
+/*========== OmAdvOp =================*//** Helper of Function [109]         */
+static void OmAdvOp(OmCir* cr, OmFlt* gm) {
+    OmInt c, g;                         /* numC, size of G (c+1)             */
+    OmInt i, j;                         /* used in for-loop                  */
+    OmFlt sum;                          /* row i of C @ Qs                   */
+    c = cr->numC;
+    g = c + 1;
+    if (cr->vecPk == NULL) {
+        cr->vecPk = (OmFlt*)OMMALLOC((3 * c + 1) * sizeof(OmFlt));
+    }
+    for (i=0; i < c; ++i) {             /* Qa' = W1m*C@(Qa+Qs) + W2m*Qa      */
+        sum = 0.0;
+        for (j=0; j < c; ++j) {
+            gm[i*g+j] = cr->vecW1m[i] * cr->matC[i*c+j];
+            sum += cr->matC[i*c+j] * cr->vecQs[j];
+        }
+        gm[i*g+i] += cr->vecW2m[i];
+        gm[i*g+c]  = cr->vecW1m[i] * sum;
+        gm[c*g+i]  = 0.0;
+        cr->vecPk[0*c+i] = cr->vecW1m[i];
+        cr->vecPk[1*c+i] = cr->vecW2m[i];
+        cr->vecPk[2*c+i] = cr->vecQs[i];
+    }
+    gm[c*g+c] = 1.0;                    /* constant 1 carries Qs term        */
+}
+/*========== OmAdvance ===============*//** Function [109]                   */
+OmInt OmAdvance(OmCir* cr, OmInt ns) {
+    OmInt c, g;                         /* numC, size of G (c+1)             */
+    OmInt i, k;                         /* used in for-loop                  */
+    OmInt np, nk;                       /* steps by powers, powers needed    */
+    OmFlt* pw;                          /* G^(2^k), k = 0...nk-1   [nk,g,g]  */
+    OmFlt* y;                           /* [Qa, 1] and product       [2g]    */
+    if (ns < 1) return 0;
+    c  = cr->numC;
+    g  = c + 1;
+    np = ns - 1;                        /* last step is a normal OmUpdCr()   */
+    nk = 0;
+    while ((np >> nk) > 0) nk += 1;     /* number of bits of np              */
+    /*======== Step 1: Check cached powers ==================================*/
+    if (cr->numP > 0 && !OmAdvKey(cr)) cr->numP = 0;
+    if (nk == 0 || cr->vecQb != NULL || (nk > cr->numP && ns <= c)) {
+        for (k=0; k < ns; ++k) OmUpdCr(cr);
+        return 0;                       /* short span, stepping is cheaper   */
+    }
+    /*======== Step 2: Extend cache by repeated squaring ====================*/
+    if (nk > cr->numP) {
+        pw = (OmFlt*)OMMALLOC(nk * g * g * sizeof(OmFlt));
+        for (i=0; i < cr->numP * g * g; ++i) pw[i] = cr->matP[i];
+        OMFREE(cr->matP);
+        cr->matP = pw;
+        if (cr->numP == 0) {            /* G^1 from current W1m, W2m, Qs     */
+            OmAdvOp(cr, pw);
+            cr->numP = 1;
+        }
+        for (k=cr->numP; k < nk; ++k) {
+            OmMatMul(g, pw + k*g*g, pw + (k-1)*g*g, pw + (k-1)*g*g);
+        }
+        cr->numP = nk;
+    }
+    /*======== Step 3: Qa after np steps, one power per set bit =============*/
+    y = (OmFlt*)OMMALLOC(2 * g * sizeof(OmFlt));
+    for (i=0; i < c; ++i) y[i] = cr->vecQa[i];
+    y[c] = 1.0;
+    for (k=0; k < nk; ++k) {
+        if (((np >> k) & 1) == 0) continue;
+        OmVecMul(g, g, y + g, cr->matP + k*g*g, y);
+        for (i=0; i < g; ++i) y[i] = y[g+i];
+    }
+    for (i=0; i < c; ++i) cr->vecQa[i] = y[i];
+    OMFREE(y);
+    /*======== Step 4: Last step sets Qtp, Xc and Qa ========================*/
+    OmUpdCr(cr);
+    return 1;
+}
+/*========== OmSsx ===================*//** Function [110]                   */
+OmInt OmSsx(OmCir* cr, OmInt nu, OmInt* vu) {
+    OmInt b, m, c, d, k;                /* numB, numM, numC, numS, numU      */
+    OmInt i, j, r, ilut;                /* used in for-loop, lookup value    */
+    OmInt* tag;                         /* 0: other, 1: input, 2: state [c]  */
+    b = cr->numB;
+    m = cr->numM;
+    c = cr->numC;
+    /*======== Step 0: Release previous state-space form ====================*/
+    cr->numS = 0;
+    cr->numU = 0;
+    OMFREE(cr->vecSr); cr->vecSr = NULL;
+    OMFREE(cr->vecSx); cr->vecSx = NULL;
+    OMFREE(cr->matSc); cr->matSc = NULL;
+    OMFREE(cr->matSd); cr->matSd = NULL;
+    if (nu < 0) return 0;               /* back to full runtime form         */
+    /*======== Step 1: Tag dynamic states and inputs ========================*/
+    tag = (OmInt*)OMMALLOC((c + 1) * sizeof(OmInt));
+    for (i=0; i < c; ++i) tag[i] = (nu == 0 && cr->vecQs[i] != 0.0);
+    for (i=0; i < nu; ++i) {
+        ilut = cr->vecLut[vu[i]-1];
+        if (ilut >= 0) tag[ilut] = 1;
+    }
+    for (i=0; i < b; ++i) {             /* Qa of row may become nonzero      */
+        ilut = cr->vecLut[i];
+        if (ilut < 0) continue;         /* cut branch                        */
+        if (cr->vecW1c[i] != 0.0 || cr->vecW2c[i] != 0.0 ||
+            cr->vecW1o[i] != 0.0 || cr->vecW2o[i] != 0.0 ||
+            cr->vecQa0[i] != 0.0 || cr->vecQa[ilut] != 0.0) tag[ilut] = 2;
+    }
+    d = 0;
+    k = 0;
+    for (i=0; i < c; ++i) {
+        d += (tag[i] == 2);
+        k += (tag[i] != 0);
+    }
+    /*======== Step 2: Gather rows and columns of matC / matD ===============*/
+    cr->vecSr = (OmInt*)OMMALLOC((k + 1) * sizeof(OmInt));
+    cr->vecSx = (OmInt*)OMMALLOC((d + 1) * sizeof(OmInt));
+    cr->matSc = (OmFlt*)OMMALLOC((d * k + 1) * sizeof(OmFlt));
+    cr->matSd = (OmFlt*)OMMALLOC((m * k + 1) * sizeof(OmFlt));
+    d = 0;
+    k = 0;
+    for (i=0; i < c; ++i) {             /* columns keep ascending row order  */
+        if (tag[i] == 0) continue;
+        if (tag[i] == 2) {
+            cr->vecSx[d] = k;
+            d += 1;
+        }
+        cr->vecSr[k] = i;
+        k += 1;
+    }
+    for (i=0; i < d; ++i) {
+        r = cr->vecSr[cr->vecSx[i]];
+        for (j=0; j < k; ++j) cr->matSc[i*k+j] = cr->matC[r*c+cr->vecSr[j]];
+    }
+    for (i=0; i < m; ++i) {
+        for (j=0; j < k; ++j) cr->matSd[i*k+j] = cr->matD[i*c+cr->vecSr[j]];
+    }
+    cr->numS = d;
+    cr->numU = k;
+    OmVecAdd(c, cr->vecQtp, cr->vecQa, cr->vecQs);
+    OMFREE(tag);
+    return d;
+}
+/*========== OmGetSs =================*//** Function [111]                   */
+OmInt OmGetSs(OmCir* cr, OmFlt* a, OmFlt* b, OmFlt* cm, OmFlt* dm,
+              OmInt* bx, OmInt* bu) {
+    OmInt m, d, k;                      /* numM, numS, numU                  */
+    OmInt i, j, r;                      /* used in for-loop, row             */
+    OmFlt w1;                           /* W1m of state                      */
+    if (cr->vecSr == NULL || cr->vecQb != NULL) return -1;
+    m = cr->numM;
+    d = cr->numS;
+    k = cr->numU;
+    for (i=0; i < d; ++i) {             /* W1m / W2m of current switches     */
+        r  = cr->vecSr[cr->vecSx[i]];
+        w1 = cr->vecW1m[r];
+        if (a != NULL) {
+            for (j=0; j < d; ++j) a[i*d+j] = w1 * cr->matSc[i*k+cr->vecSx[j]];
+            a[i*d+i] += cr->vecW2m[r];
+        }
+        if (b != NULL) {
+            for (j=0; j < k; ++j) b[i*k+j] = w1 * cr->matSc[i*k+j];
+        }
+    }
+    for (i=0; i < m; ++i) {
+        if (cm != NULL) {
+            for (j=0; j < d; ++j) cm[i*d+j] = cr->matSd[i*k+cr->vecSx[j]];
+        }
+        if (dm != NULL) {
+            for (j=0; j < k; ++j) dm[i*k+j] = cr->matSd[i*k+j];
+        }
+    }
+    for (i=0; i < cr->numB; ++i) {      /* branch of state / column          */
+        r = cr->vecLut[i];
+        if (r < 0) continue;            /* cut branch                        */
+        for (j=0; j < k; ++j) {
+            if (cr->vecSr[j] != r) continue;
+            if (bu != NULL) bu[j] = i + 1;
+        }
+        for (j=0; j < d; ++j) {
+            if (cr->vecSr[cr->vecSx[j]] != r) continue;
+            if (bx != NULL) bx[j] = i + 1;
+        }
+    }
+    return d;
+}
+/*========== OmSwErr =================*//** Function [112]                   */
+OmFlt OmSwErr(OmCir* cr, OmInt bs) {
+    return cr->vecTe[bs-1];
+}
+/*========== OmEvtNew ================*//** Function [113]                   */
+OmEvt* OmEvtNew(OmCir* cr, OmInt nw) {
+    OmEvt* ev;                          /* new event detector engine         */
+    if (cr == NULL || cr->matC == NULL || nw < 1) return NULL;
+    ev = (OmEvt*)OMMALLOC(sizeof(OmEvt));
+    if (ev == NULL) return NULL;
+    ev->cir   = cr;
+    ev->numW  = nw;
+    ev->numU  = 0;
+    ev->numS  = 0;
+    ev->numF  = 0;
+    ev->vecDk = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    ev->vecDi = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    ev->vecDm = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    ev->vecDs = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    ev->vecDq = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    ev->vecDl = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    ev->vecDh = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    ev->vecDr = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    ev->vecDv = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    ev->vecFd = (OmInt*)OMMALLOC(2 * nw * sizeof(OmInt));
+    ev->vecFt = (OmInt*)OMMALLOC(2 * nw * sizeof(OmInt));
+    ev->vecFa = (OmFlt*)OMMALLOC(2 * nw * sizeof(OmFlt));
+    ev->vecX  = (OmFlt*)OMMALLOC(nw * sizeof(OmFlt));
+    ev->vecG  = (OmInt*)OMMALLOC(nw * sizeof(OmInt));
+    if (ev->vecDk == NULL || ev->vecDi == NULL || ev->vecDm == NULL
+        || ev->vecDs == NULL || ev->vecDq == NULL || ev->vecDl == NULL
+        || ev->vecDh == NULL || ev->vecDr == NULL || ev->vecDv == NULL
+        || ev->vecFd == NULL || ev->vecFt == NULL || ev->vecFa == NULL
+        || ev->vecX == NULL || ev->vecG == NULL) {
+        OmEvtDel(ev);
+        return NULL;
+    }
+    return ev;
+}
+/*========== OmEvtDel ================*//** Function [114]                   */
+void OmEvtDel(OmEvt* ev) {
+    if (ev == NULL) return;
+    OMFREE(ev->vecDk);
+    OMFREE(ev->vecDi);
+    OMFREE(ev->vecDm);
+    OMFREE(ev->vecDs);
+    OMFREE(ev->vecDq);
+    OMFREE(ev->vecDl);
+    OMFREE(ev->vecDh);
+    OMFREE(ev->vecDr);
+    OMFREE(ev->vecDv);
+    OMFREE(ev->vecFd);
+    OMFREE(ev->vecFt);
+    OMFREE(ev->vecFa);
+    OMFREE(ev->vecX);
+    OMFREE(ev->vecG);
+    OMFREE(ev);
+}
+/*========== OmEvtAdd ================*//** Function [115]                   */
+OmInt OmEvtAdd(OmEvt* ev, OmInt src, OmInt id, OmFlt lv, OmFlt hy,
+               OmInt msk, OmFlt dvl) {
+    OmCir* cr;                          /* watched circuit                   */
+    OmFlt x;                            /* value now                         */
+    OmInt j;                            /* index of new detector             */
+    cr = ev->cir;
+    if (ev->numU >= ev->numW || hy < 0.0 || dvl < 0.0) return -1;
+    if (src == OMEVT_XC) {
+        if (id < 1 || id > cr->numB || cr->vecLut[id-1] < 0) return -1;
+        x = cr->vecXc[cr->vecLut[id-1]];
+    } else if (src == OMEVT_XM) {
+        if (id < 1 || id > cr->numM) return -1;
+        x = cr->vecXm[id-1];
+    } else {
+        return -1;
+    }
+    j = ev->numU++;
+    ev->vecDk[j] = src;
+    ev->vecDi[j] = id - 1;
+    ev->vecDm[j] = msk & (OMEVT_UP | OMEVT_DN | OMEVT_DV);
+    ev->vecDs[j] = x >= lv;
+    ev->vecDq[j] = 0;
+    ev->vecDl[j] = lv;
+    ev->vecDh[j] = hy;
+    ev->vecDr[j] = dvl;
+    ev->vecDv[j] = x;
+    return j + 1;
+}
+/*========== OmEvtRun ================*//** Function [116]                   */
+OmInt OmEvtRun(OmEvt* ev) {
+    OmCir* cr;                          /* watched circuit                   */
+    OmFlt* x;                           /* values of this pass               */
+    OmInt* g;                           /* events of this pass               */
+    OmFlt lv, a, ts, dr;                /* level, fraction, time, dv limit   */
+    OmInt up, dn, ov;                   /* rising, falling, over dv/dt       */
+    OmInt i, t, k, n, u;                /* used in for-loop, number of used  */
+    cr = ev->cir;
+    x  = ev->vecX;
+    g  = ev->vecG;
+    u  = ev->numU;
+    /*======== Step 1: Gather watched values ================================*/
+    for (i=0; i < u; ++i) {
+        k = ev->vecDi[i];
+        x[i] = ev->vecDk[i] == OMEVT_XM ? cr->vecXm[k]
+             : cr->vecXc[cr->vecLut[k]];
+    }
+    /*======== Step 2: Compare all detectors ================================*/
+    for (i=0; i < u; ++i) {
+        dr = ev->vecDr[i] * cr->timStp;
+        up = (ev->vecDs[i] == 0) & (x[i] >= ev->vecDl[i]);
+        dn = (ev->vecDs[i] == 1) & (x[i] <= ev->vecDl[i] - ev->vecDh[i]);
+        ov = (dr > 0.0) & (OMABS(x[i] - ev->vecDv[i]) > dr);
+        g[i] = (up * OMEVT_UP | dn * OMEVT_DN | (ov & !ev->vecDq[i])
+             * OMEVT_DV) & ev->vecDm[i];
+        ev->vecDs[i] ^= up | dn;
+        ev->vecDq[i]  = ov;
+    }
+    /*======== Step 3: Compact fired events in order of time ================*/
+    n = 0;
+    for (i=0; i < u; ++i) {
+        if (g[i] == 0) continue;
+        for (t=OMEVT_UP; t <= OMEVT_DV; t <<= 1) {
+            if (!(g[i] & t)) continue;
+            lv = ev->vecDl[i] - (t == OMEVT_DN ? ev->vecDh[i] : 0.0);
+            a  = 1.0;
+            if (t != OMEVT_DV && x[i] != ev->vecDv[i])
+                a = (lv - ev->vecDv[i]) / (x[i] - ev->vecDv[i]);
+            a  = a < 0.0 ? 0.0 : a > 1.0 ? 1.0 : a;
+            ts = (ev->numS + a) * cr->timStp;
+            for (k=n; k > 0 && ev->vecFa[k-1] > ts; --k) {
+                ev->vecFd[k] = ev->vecFd[k-1];
+                ev->vecFt[k] = ev->vecFt[k-1];
+                ev->vecFa[k] = ev->vecFa[k-1];
+            }
+            ev->vecFd[k] = i + 1;
+            ev->vecFt[k] = t;
+            ev->vecFa[k] = ts;
+            ++n;
+        }
+    }
+    for (i=0; i < u; ++i) ev->vecDv[i] = x[i];
+    ev->numS += 1;
+    ev->numF  = n;
+    return n;
+}
+/*========== OmSetBk =================*//** Function [117]                   */
+void OmSetBk(OmBk* bk) {
+    omBk = bk;
+}
+typedef struct OmPrj {                  /** Shared Parareal job              */
+#ifdef LIBOHM_PTHREAD
+    pthread_mutex_t mtx;                /** Protects gen, run and end        */
+    pthread_cond_t cv;                  /** Signals new iteration and done   */
+#endif
+    OmInt  gen, run, end;               /** Iteration, busy threads, quit    */
+    OmCir** crs;                        /** Fine instances             [nt]  */
+    OmInt  nt, np, ns, it;              /** Threads, slices, steps, first    */
+    OmStpFn fn;                         /** Schedule callback                */
+    void*  usr;                         /** User pointer                     */
+    OmFlt* u;                           /** Qa at slice starts     [np+1,c]  */
+    OmFlt* f;                           /** Qa at fine slice ends    [np,c]  */
+} OmPrj;
+typedef struct OmPrt {                  /** Fine slices of a Parareal thread */
+#ifdef LIBOHM_PTHREAD
+    pthread_t thd;                      /** Thread handle                    */
+#endif
+    OmInt  id     ;                     /** Thread index, runs on crs[id]    */
+    OmInt  ok     ;                     /** Thread was created               */
+    OmPrj* job    ;                     /** Shared Parareal job              */
+} OmPrt;
+/*========== OmParFn =================*//** Helper of Function [118]         */
+static void OmParFn(OmPrj* jb, OmCir* cr, OmInt j) {
+    OmInt c;                            /* numC                              */
+    OmInt i, k;                         /* used in for-loop                  */
+    c = cr->numC;
+    for (i=0; i < c; ++i) cr->vecQa[i] = jb->u[j*c+i];
+    for (k=0; k < jb->ns; ++k) {
+        jb->fn(cr, j * jb->ns + k, jb->usr);
+        OmUpdCr(cr);
+    }
+    for (i=0; i < c; ++i) jb->f[j*c+i] = cr->vecQa[i];
+}
+/*========== OmParTh =================*//** Helper of Function [118]         */
+static void OmParTh(OmPrt* t) {
+    OmInt j;                            /* slice index                       */
+    for (j=t->job->it + t->id; j < t->job->np; j += t->job->nt) {
+        OmParFn(t->job, t->job->crs[t->id], j);
+    }
+}
+#ifdef LIBOHM_PTHREAD
+/*========== OmParWk =================*//** Helper of Function [118]         */
+static void* OmParWk(void* arg) {
+    OmPrt* t;                           /* own thread                        */
+    OmPrj* jb;                          /* shared Parareal job               */
+    OmInt gen, end;                     /* last iteration run, quit flag     */
+    t = (OmPrt*)arg;
+    jb = t->job;
+    gen = 0;
+    for (;;) {                          /* one pass per iteration            */
+        pthread_mutex_lock(&jb->mtx);
+        while (jb->gen == gen && !jb->end) {
+            pthread_cond_wait(&jb->cv, &jb->mtx);
+        }
+        gen = jb->gen;
+        end = jb->end;
+        pthread_mutex_unlock(&jb->mtx);
+        if (end) return NULL;
+        OmParTh(t);
+        pthread_mutex_lock(&jb->mtx);
+        jb->run -= 1;
+        pthread_cond_broadcast(&jb->cv);
+        pthread_mutex_unlock(&jb->mtx);
+    }
+}
+#endif
+/*========== OmParOp =================*//** Helper of Function [118]         */
+static void OmParOp(OmCir* cr, OmInt ns, OmFlt* p, OmFlt* w) {
+    OmInt c, cc;                        /* numC, c * c                       */
+    OmInt i, k;                         /* used in for-loop                  */
+    OmFlt* sp;                          /* S = A^0 + ... + A^(ns-1)  [c,c]   */
+    OmFlt* a;                           /* A^(2^k)                   [c,c]   */
+    OmFlt* sa;                          /* A^0 + ... + A^(2^k-1)     [c,c]   */
+    OmFlt* t;                           /* product                   [c,c]   */
+    c  = cr->numC;
+    cc = c * c;
+    sp = p + cc;
+    a  = w;
+    sa = w + cc;
+    t  = w + 2 * cc;
+    for (i=0; i < cc; ++i) {            /* A = W1 * C + W2, as OmAdvance()   */
+        a[i]  = cr->vecW1m[i/c] * cr->matC[i];
+        a[i] += (i % (c + 1) == 0) ? cr->vecW2m[i/c] : 0.0;
+        sa[i] = (i % (c + 1) == 0) ? 1.0 : 0.0;
+        p[i]  = sa[i];
+        sp[i] = 0.0;
+    }
+    for (k=ns; k > 0; k >>= 1) {        /* P = A^ns, one block per set bit   */
+        if (k & 1) {                    /* powers of A commute               */
+            OmMatMul(c, t, p, sa);
+            for (i=0; i < cc; ++i) sp[i] += t[i];
+            OmMatMul(c, t, p, a);
+            for (i=0; i < cc; ++i) p[i] = t[i];
+        }
+        if (k > 1) {
+            OmMatMul(c, t, a, sa);
+            for (i=0; i < cc; ++i) sa[i] += t[i];
+            OmMatMul(c, t, a, a);
+            for (i=0; i < cc; ++i) a[i] = t[i];
+        }
+    }
+}
+/*========== OmParareal ==============*//** Function [118]                   */
+OmInt OmParareal(OmCir** crs, OmInt nt, OmInt np, OmInt ns, OmStpFn fn,
+                 void* usr, OmFlt tol, OmInt itm, OmFlt* u) {
+    OmPrj jb;                           /* shared Parareal job               */
+    OmPrt* th;                          /* threads                     [nt]  */
+    OmCir* cr;                          /* crs[0], coarse sweeps             */
+    OmInt c, cc, nm;                    /* numC, c * c, switch states built  */
+    OmInt i, j, k, l, it;               /* used in for-loop, iteration       */
+    OmFlt r, qm, s;                     /* change, |Qa| max, summation       */
+    OmFlt* pp;                          /* A^ns and S of states  [np,2,c,c]  */
+    OmInt* pi;                          /* switch state of slice       [np]  */
+    OmFlt* pk;                          /* W1 / W2 of switch states  [np,2c] */
+    OmFlt* a;                           /* A^ns of slice j, S follows        */
+    OmFlt* d;                           /* change at slice start, next [2c]  */
+    cr = crs[0];
+    c  = cr->numC;
+    cc = c * c;
+#ifndef LIBOHM_PTHREAD
+    nt = 1;                             /* no threads without pthread        */
+#endif
+    if (nt > np) nt = np;
+    if (nt < 1) nt = 1;
+    if (np < 1 || ns < 1) return -1;
+    for (i=0; i < nt; ++i) {            /* Qb would need a second history    */
+        if (crs[i]->numC != c || crs[i]->vecQb != NULL) return -1;
+    }
+    jb.crs = crs; jb.nt = nt; jb.np = np; jb.ns = ns;
+    jb.fn  = fn;  jb.usr = usr;
+    jb.gen = 0;   jb.run = 0; jb.end = 0;
+    jb.u = (OmFlt*)OMMALLOC(((np+1)*c+1) * sizeof(OmFlt));
+    jb.f = (OmFlt*)OMMALLOC((np*c+1) * sizeof(OmFlt));
+    pp = (OmFlt*)OMMALLOC(((2*np+3)*cc+1) * sizeof(OmFlt));
+    pi = (OmInt*)OMMALLOC(np * sizeof(OmInt));
+    pk = (OmFlt*)OMMALLOC((2*np*c+1) * sizeof(OmFlt));
+    d  = (OmFlt*)OMMALLOC((2*c+1) * sizeof(OmFlt));
+    th = (OmPrt*)OMMALLOC(nt * sizeof(OmPrt));
+    if (jb.u == NULL || jb.f == NULL || pp == NULL || pi == NULL
+        || pk == NULL || d == NULL || th == NULL) {
+        OMFREE(jb.u); OMFREE(jb.f); OMFREE(pp); OMFREE(pi); OMFREE(pk);
+        OMFREE(d); OMFREE(th);
+        return -1;
+    }
+    /*======== Step 1: Coarse operators and first coarse sweep ==============*/
+    for (i=0; i < c; ++i) jb.u[i] = cr->vecQa[i];
+    nm = 0;
+    for (j=0; j < np; ++j) {
+        fn(cr, j * ns, usr);            /* hold of slice j                   */
+        for (k=0; k < nm; ++k) {        /* look up switch state              */
+            for (i=0; i < c; ++i) {
+                if (pk[k*2*c+i]   != cr->vecW1m[i]) break;
+                if (pk[k*2*c+c+i] != cr->vecW2m[i]) break;
+            }
+            if (i == c) break;
+        }
+        if (k == nm) {                  /* new state, build A^ns and S       */
+            OmParOp(cr, ns, pp + k * 2 * cc, pp + np * 2 * cc);
+            for (i=0; i < c; ++i) {
+                pk[k*2*c+i]   = cr->vecW1m[i];
+                pk[k*2*c+c+i] = cr->vecW2m[i];
+            }
+            nm += 1;
+        }
+        pi[j] = k;
+        a = pp + k * 2 * cc;
+        for (i=0; i < c; ++i) {         /* b = W1 * (C @ Qs), sources held   */
+            s = 0.0;
+            for (l=0; l < c; ++l) s += cr->matC[i*c+l] * cr->vecQs[l];
+            d[i] = cr->vecW1m[i] * s;
+        }
+        for (i=0; i < c; ++i) {         /* U[j+1] = A^ns @ U[j] + S @ b      */
+            s = 0.0;
+            for (l=0; l < c; ++l) {
+                s += a[i*c+l] * jb.u[j*c+l] + a[cc+i*c+l] * d[l];
+            }
+            jb.u[(j+1)*c+i] = s;
+        }
+    }
+    /*======== Step 2: Fine slices in parallel, correct slice starts ========*/
+    for (i=0; i < nt; ++i) {
+        th[i].id  = i;
+        th[i].ok  = 0;
+        th[i].job = &jb;
+    }
+#ifdef LIBOHM_PTHREAD
+    pthread_mutex_init(&jb.mtx, NULL);
+    pthread_cond_init(&jb.cv, NULL);
+    for (i=1; i < nt; ++i) {            /* workers live for all iterations   */
+        th[i].ok = pthread_create(&th[i].thd, NULL, OmParWk, th + i) == 0;
+        jb.run += th[i].ok;
+    }
+    l = jb.run;                         /* number of created workers         */
+#endif
+    r = 1.0;
+    qm = 0.0;
+    for (it=0; it < itm && r > tol * qm; ++it) {
+        jb.it = it;                     /* slices before it are exact        */
+#ifdef LIBOHM_PTHREAD
+        pthread_mutex_lock(&jb.mtx);    /* start workers on iteration it     */
+        jb.run = l;
+        jb.gen += 1;
+        pthread_cond_broadcast(&jb.cv);
+        pthread_mutex_unlock(&jb.mtx);
+#endif
+        OmParTh(th);                    /* thread 0 is the calling thread    */
+        for (i=1; i < nt; ++i) {        /* slices of failed threads run here */
+            if (!th[i].ok) OmParTh(th + i);
+        }
+#ifdef LIBOHM_PTHREAD
+        pthread_mutex_lock(&jb.mtx);
+        while (jb.run > 0) pthread_cond_wait(&jb.cv, &jb.mtx);
+        pthread_mutex_unlock(&jb.mtx);
+#endif
+        r  = 0.0;
+        qm = 1.0;
+        for (i=0; i < c; ++i) d[i] = 0.0;
+        for (j=it; j < np; ++j) {       /* U' = F(U) + A^ns @ (U' - U)       */
+            a = pp + pi[j] * 2 * cc;
+            for (i=0; i < c; ++i) {
+                s = jb.f[j*c+i];
+                for (k=0; k < c; ++k) s += a[i*c+k] * d[k];
+                d[c+i] = s - jb.u[(j+1)*c+i];
+                jb.u[(j+1)*c+i] = s;
+                if (OMABS(d[c+i]) > r) r = OMABS(d[c+i]);
+                if (OMABS(s) > qm) qm = OMABS(s);
+            }
+            for (i=0; i < c; ++i) d[i] = d[c+i];
+        }
+        if (it >= np - 2) r = 0.0;      /* start of last slice is exact      */
+    }
+#ifdef LIBOHM_PTHREAD
+    pthread_mutex_lock(&jb.mtx);        /* stop workers                      */
+    jb.end = 1;
+    pthread_cond_broadcast(&jb.cv);
+    pthread_mutex_unlock(&jb.mtx);
+    for (i=1; i < nt; ++i) {
+        if (th[i].ok) pthread_join(th[i].thd, NULL);
+    }
+    pthread_cond_destroy(&jb.cv);
+    pthread_mutex_destroy(&jb.mtx);
+#endif
+    /*======== Step 3: Leave crs[0] at end of last slice ====================*/
+    jb.it = np - 1;
+    OmParFn(&jb, cr, np - 1);
+    for (i=0; i < c; ++i) jb.u[np*c+i] = cr->vecQa[i];
+    if (u != NULL) {
+        for (i=0; i < (np+1)*c; ++i) u[i] = jb.u[i];
+    }
+    k = (r <= tol * qm) ? it : -1;
+    OMFREE(jb.u); OMFREE(jb.f); OMFREE(pp); OMFREE(pi); OMFREE(pk);
+    OMFREE(d); OMFREE(th);
+    return k;
+}
+#ifdef LIBOHM_MATH                      /*| step advisor, libm (opt-in)     |*/
+/*========== OmStepAdv ===============*//** Function [119]                   */
+OmInt OmStepAdv(OmCir* cr, OmInt sw, OmFlt tol, OmFlt wb, OmFlt* hs,
+                OmFlt* wr, OmFlt* wi, OmInt* fl) {
+    OmInt b, c, d;                      /* numB, numC, number of modes       */
+    OmInt i, j, k, r;                   /* used in for-loop, row             */
+    OmInt tr, be;                       /* has TR, BE L / C branches         */
+    OmInt* sx;                          /* row of mode state           [c]   */
+    OmFlt* w;                           /* W1, W2 of rows              [2c]  */
+    OmFlt* a;                           /* W1 * C + W2 on states       [d,d] */
+    OmFlt* zr;                          /* real part of z              [c]   */
+    OmFlt* zi;                          /* imaginary part of z         [c]   */
+    OmFlt h, m2;                        /* timStp, |z|^2                     */
+    OmFlt xr, xi, lr, li;               /* s * h, ln(z)                      */
+    OmFlt er, ei;                       /* ln(z) / (s * h) - 1               */
+    OmFlt sa, hk;                       /* |s|, step limit of mode           */
+    b = cr->numB;
+    c = cr->numC;
+    h = cr->timStp;
+    if (cr->vecQb != NULL) return -1;   /* recurrence also involves Qb       */
+    sx = (OmInt*)OMMALLOC((c+1) * sizeof(OmInt));
+    w  = (OmFlt*)OMMALLOC((2*c+1) * sizeof(OmFlt));
+    a  = (OmFlt*)OMMALLOC((c*c+1) * sizeof(OmFlt));
+    zr = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    zi = (OmFlt*)OMMALLOC((c+1) * sizeof(OmFlt));
+    if (sx == NULL || w == NULL || a == NULL || zr == NULL || zi == NULL) {
+        OMFREE(sx); OMFREE(w); OMFREE(a); OMFREE(zr); OMFREE(zi);
+        return -1;
+    }
+    /*======== Step 1: Weights of switch states and rule of L / C ===========*/
+    tr = 0;
+    be = 0;
+    for (i=0; i < c; ++i) {
+        w[i]   = cr->vecW1m[i];
+        w[c+i] = cr->vecW2m[i];
+    }
+    for (i=0; i < b; ++i) {
+        k = OMABS(cr->vecBtm[i]);
+        j = k == OMTYP_X2 || k == OMTYP_X3 || k == OMTYP_Y2 || k == OMTYP_Y3;
+        tr |= j && cr->vecBtm[i] > 0;
+        be |= j && cr->vecBtm[i] < 0;
+        r = cr->vecLut[i];
+        if (r < 0 || sw < 0) continue;
+        w[r]   = (sw && k == OMTYP_SW) ? cr->vecW1c[i] : cr->vecW1o[i];
+        w[c+r] = (sw && k == OMTYP_SW) ? cr->vecW2c[i] : cr->vecW2o[i];
+    }
+    /*======== Step 2: Eigenvalues of step operator on states ===============*/
+    for (i=0, d=0; i < c; ++i) {
+        if (w[i] != 0.0 || w[c+i] != 0.0) sx[d++] = i;
+    }
+    for (i=0; i < d; ++i) {
+        for (j=0; j < d; ++j) {
+            a[i*d+j] = w[sx[i]] * cr->matC[sx[i]*c+sx[j]];
+        }
+        a[i*d+i] += w[c+sx[i]];
+    }
+    if (d > 0 && OmMatEig(d, a, zr, zi) != 0) d = -1;
+    /*======== Step 3: Map modes to poles and rate them =====================*/
+    if (hs != NULL) *hs = (tr && be) ? -1.0 : 0.0;
+    for (k=0; k < d; ++k) {
+        m2 = zr[k] * zr[k] + zi[k] * zi[k];
+        if (fl != NULL) {
+            fl[k] = (m2 > 1.0 + 1e-12) * OMADV_UNS
+                  | (zr[k] < 0.0) * OMADV_OSC;
+        }
+        if (tr && be) {                 /* no single rule, output z itself   */
+            if (wr != NULL) wr[k] = zr[k];
+            if (wi != NULL) wi[k] = zi[k];
+            continue;
+        }
+        if (!tr && m2 < 1e-300) {       /* BE static mode, s is infinite     */
+            if (wr != NULL) wr[k] = -HUGE_VAL;
+            if (wi != NULL) wi[k] = 0.0;
+            continue;
+        }
+        if (tr) {                       /* x = 2 (z - 1) / (z + 1)           */
+            er = (zr[k] + 1.0) * (zr[k] + 1.0) + zi[k] * zi[k];
+            if (er < 1e-300) er = 1e-300;
+            xr = 2.0 * (m2 - 1.0) / er;
+            xi = 4.0 * zi[k] / er;
+        } else {                        /* x = 1 - 1 / z                     */
+            xr = 1.0 - zr[k] / m2;
+            xi = zi[k] / m2;
+        }
+        if (wr != NULL) wr[k] = xr / h;
+        if (wi != NULL) wi[k] = xi / h;
+        sa = sqrt(xr * xr + xi * xi);
+        if (sa == 0.0) continue;        /* DC mode is exact                  */
+        lr = 0.5 * log(m2);
+        li = atan2(zi[k], zr[k]);
+        er = (lr * xr + li * xi) / (sa * sa) - 1.0;
+        ei = (li * xr - lr * xi) / (sa * sa);
+        if (fl != NULL && sqrt(er * er + ei * ei) > tol) fl[k] |= OMADV_ERR;
+        sa /= h;
+        if (wb > 0.0 && sa > wb) continue;
+        hk = tr ? sqrt(12.0 * tol) / sa : 2.0 * tol / sa;
+        if (hs != NULL && (*hs == 0.0 || hk < *hs)) *hs = hk;
+    }
+    OMFREE(sx); OMFREE(w); OMFREE(a); OMFREE(zr); OMFREE(zi);
+    return d;
+}
+#endif                                  /*| #ifdef LIBOHM_MATH              |*/
+
+/*===========================================================================*/
+#endif                                  /*| #ifdef LIBOHM_C                 |*/
+/*===========================================================================*/
+
+#ifdef __cplusplus                      /*| extern "C"                      |*/
+}
+#endif
+
+/*====================== Part 6. Undefine Macro =============================*/
+
+#define OMFLG_NC
+#define OMFLG_RI
+#define OMFLG_RH
+#define OMFLG_CB
+#define OMFLG_CT
+#define OMFLG_LB
+#define OMFLG_LT
+#define OMFLG_SW
+#define OMFLG_KB
+#define OMFLG_KT
+
+/*===========================================================================*/
+#endif                                  /*| #ifndef LIBOHM_H                |*/
 /*===========================================================================*/
\ No newline at end of file
@@ -0,0 +1,242 @@
+/*
+ * LibOhm: A Header-Only Ciruit Simulation Library
+ * Copyright (C) 2026 H.J.Xie
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+* @file
+* @brief        LibOhm C++ Fixed-size Front-end.
+* @details      OmFixed<C, M, B> holds a stamped runtime in std::array with
+*               compile-time numC, numM and max numB, so that the step is
+*               unrolled.
+* @author       H.J.Xie
+* @date         2026/01/15
+* @version      v1.0
+*/
+
+/*===========================================================================*/
+#ifndef LIBOHM_HPP                      /*| Include Guards allow including  |*/
+#define LIBOHM_HPP                      /*| this header file multiple times.|*/
+/*===========================================================================*/
+
+/*====================== Part 1. Dependency =================================*/
+
+#include <array>                        /** Class Used: std::array           */
+#include "libohm.h"                     /** Type Used: OmInt, OmFlt, OmCir   */
+
+/*====================== Part 2. Macro Defination ===========================*/
+
+#if __cplusplus >= 201703L              /*| std::array is constexpr (C++17) |*/
+#define OMCXP constexpr                 /** Kernel can run at compile time   */
+#else
+#define OMCXP inline                    /** Kernel is inline only            */
+#endif
+
+/*====================== Part 3. Type Defination ============================*/
+
+template <OmInt C, OmInt M, OmInt B = C>
+struct OmFixed {                        /** Fixed-size Runtime Structure     */
+    /*======== Group 0: Runtime Information =================================*/
+    std::array<OmFlt, C * C> matC   {}; /** Matrix to calculate Xc    [c,c]  */
+    std::array<OmFlt, M * C> matD   {}; /** Matrix to calculate Xm    [m,c]  */
+    std::array<OmFlt, C>     vecW1m {}; /** Weight of Xc in UpdCr()    [c]   */
+    std::array<OmFlt, C>     vecW2m {}; /** Weight of Qa in UpdCr()    [c]   */
+    std::array<OmFlt, C>     vecW1s {}; /** Weight of Xc in UpdSw()    [c]   */
+    std::array<OmFlt, C>     vecW2s {}; /** Weight of Qa in UpdSw()    [c]   */
+    std::array<OmFlt, C>     vecQa  {}; /** Associated source vector   [c]   */
+    std::array<OmFlt, C>     vecQs  {}; /** Independent source vector  [c]   */
+    std::array<OmFlt, C>     vecQtp {}; /** Vector Qtp = Qs + Qa       [c]   */
+    std::array<OmFlt, M>     vecXm  {}; /** Meter reading vector       [m]   */
+    std::array<OmFlt, C>     vecXc  {}; /** Source update vector       [c]   */
+    /*======== Group 1: Row Information =====================================*/
+    std::array<OmInt, C>     vecRb  {}; /** Branch of row (0-based)    [c]   */
+    std::array<OmInt, C>     vecRs  {}; /** Row is SW-type branch      [c]   */
+    std::array<OmInt, B>     vecBr  {}; /** Row of branch, -1 if cut   [b]   */
+    std::array<OmFlt, C>     vecW1c {}; /** Weight of Xc   (closed)    [c]   */
+    std::array<OmFlt, C>     vecW2c {}; /** Weight of Qa   (closed)    [c]   */
+    std::array<OmFlt, C>     vecW1o {}; /** Weight of Xc   (open)      [c]   */
+    std::array<OmFlt, C>     vecW2o {}; /** Weight of Qa   (open)      [c]   */
+    std::array<OmFlt, C>     vecQa0 {}; /** Initial value of Qa        [c]   */
+    std::array<OmFlt, C>     vecQs0 {}; /** Initial value of Qs        [c]   */
+
+    /*====================== Part 4. Function Declaration ===================*/
+
+    /**
+     * @brief       [0] Copy stamped circuit into this runtime
+     * @param       cr input stamped OmCir pointer (cannot be NULL)
+     * @retval      return true if succeed, false if numC/numM differ,
+     *              numB > B or the circuit has BDF2 branches
+     * @note        copies the current state as well, dense or sparse
+     */
+    bool Load(const OmCir* cr);
+    /**
+     * @brief       [1] Row of branch
+     * @param       br branch index (1-based index, range: 1 to numB)
+     * @retval      return row (0-based), -1 if cut
+     * @note        looked up in table vecBr built by Load()
+     */
+    OMCXP OmInt Row(OmInt br) const;
+    /**
+     * @brief       [2] Reset runtime to initial state, like OmReset()
+     */
+    OMCXP void Reset();
+    /** @brief      [3] Update switch state, like OmUpdSw()              */
+    OMCXP void UpdSw();
+    /** @brief      [4] Update circuit state, like OmUpdCr()             */
+    OMCXP void UpdCr();
+    /** @brief      [5] Update meter reading, like OmUpdMt()             */
+    OMCXP void UpdMt();
+    /** @brief      [6] Get meter reading, like OmGetMt()                */
+    OMCXP OmFlt GetMt(OmInt mt) const;
+    /** @brief      [7] Get Xc of branch, like OmGetXc()                 */
+    OMCXP OmFlt GetXc(OmInt br) const;
+    /** @brief      [8] Set independent source, like OmSetQs()           */
+    OMCXP void SetQs(OmInt br, OmFlt x);
+    /** @brief      [9] Set switch state, like OmSetSw()                 */
+    OMCXP void SetSw(OmInt br, OmInt s);
+};
+
+/*====================== Part 5. Function Implementation ====================*/
+
+/*========== Load ====================*//** Function [0]                     */
+template <OmInt C, OmInt M, OmInt B>
+bool OmFixed<C, M, B>::Load(const OmCir* cr) {
+    OmInt i, j, ilut;                   /* used in for-loop, lookup value    */
+    if (cr->matC == NULL || cr->numC != C || cr->numM != M) return false;
+    if (cr->numB > B) return false;     /* no room in branch table           */
+    if (cr->vecQb != NULL) return false; /* BDF2 history is not held         */
+    for (i=0; i < C * C; ++i) matC[i] = cr->matC[i];
+    for (i=0; i < M * C; ++i) matD[i] = cr->matD[i];
+    for (i=0; i < C; ++i) {
+        vecW1m[i] = cr->vecW1m[i];
+        vecW2m[i] = cr->vecW2m[i];
+        vecW1s[i] = cr->vecW1s[i];
+        vecW2s[i] = cr->vecW2s[i];
+        vecQa[i]  = cr->vecQa[i];
+        vecQs[i]  = cr->vecQs[i];
+        vecQtp[i] = cr->vecQtp[i];
+        vecXc[i]  = cr->vecXc[i];
+    }
+    for (i=0; i < M; ++i) vecXm[i] = cr->vecXm[i];
+    for (j=0; j < B; ++j) vecBr[j] = -1;
+    for (j=0; j < cr->numB; ++j) {      /* branch data of kept rows          */
+        ilut = cr->vecLut[j];
+        if (ilut < 0) continue;         /* cut branch                        */
+        vecBr[j]     = ilut;
+        vecRb[ilut]  = j;
+        vecRs[ilut]  = OMABS(cr->vecBtm[j]) == OMTYP_SW;
+        vecW1c[ilut] = cr->vecW1c[j];
+        vecW2c[ilut] = cr->vecW2c[j];
+        vecW1o[ilut] = cr->vecW1o[j];
+        vecW2o[ilut] = cr->vecW2o[j];
+        vecQa0[ilut] = cr->vecQa0[j];
+        vecQs0[ilut] = cr->vecQs0[j];
+    }
+    return true;
+}
+/*========== Row =====================*//** Function [1]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP OmInt OmFixed<C, M, B>::Row(OmInt br) const {
+    return (br >= 1 && br <= B) ? vecBr[br-1] : -1;
+}
+/*========== Reset ===================*//** Function [2]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP void OmFixed<C, M, B>::Reset() {
+    for (OmInt i=0; i < C; ++i) {
+        vecW1m[i] = vecW1o[i];
+        vecW2m[i] = vecW2o[i];
+        vecQa[i]  = vecQa0[i];
+        vecQs[i]  = vecQs0[i];
+        vecW1s[i] = vecRs[i] ? vecW1o[i] : 0.0;
+        vecW2s[i] = vecRs[i] ? vecW2o[i] : 1.0;
+        vecQtp[i] = vecQa[i] + vecQs[i];
+    }
+}
+/*========== UpdSw ===================*//** Function [3]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP void OmFixed<C, M, B>::UpdSw() {
+    for (OmInt i=0; i < C; ++i) vecQtp[i] = vecQa[i] + vecQs[i];
+    for (OmInt i=0; i < C; ++i) {
+        OmFlt sum = 0.0;                /* same order as OmVecMul()          */
+        for (OmInt j=0; j < C; ++j) sum += matC[i*C+j] * vecQtp[j];
+        vecXc[i] = sum;
+    }
+    for (OmInt i=0; i < C; ++i) {
+        vecQa[i] = vecW1s[i] * vecXc[i] + vecW2s[i] * vecQa[i];
+    }
+}
+/*========== UpdCr ===================*//** Function [4]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP void OmFixed<C, M, B>::UpdCr() {
+    for (OmInt i=0; i < C; ++i) vecQtp[i] = vecQa[i] + vecQs[i];
+    for (OmInt i=0; i < C; ++i) {
+        OmFlt sum = 0.0;                /* same order as OmVecMul()          */
+        for (OmInt j=0; j < C; ++j) sum += matC[i*C+j] * vecQtp[j];
+        vecXc[i] = sum;
+    }
+    for (OmInt i=0; i < C; ++i) {
+        vecQa[i] = vecW1m[i] * vecXc[i] + vecW2m[i] * vecQa[i];
+    }
+}
+/*========== UpdMt ===================*//** Function [5]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP void OmFixed<C, M, B>::UpdMt() {
+    for (OmInt i=0; i < M; ++i) {
+        OmFlt sum = 0.0;                /* same order as OmVecMul()          */
+        for (OmInt j=0; j < C; ++j) sum += matD[i*C+j] * vecQtp[j];
+        vecXm[i] = sum;
+    }
+}
+/*========== GetMt ===================*//** Function [6]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP OmFlt OmFixed<C, M, B>::GetMt(OmInt mt) const {
+    return vecXm[mt-1];
+}
+/*========== GetXc ===================*//** Function [7]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP OmFlt OmFixed<C, M, B>::GetXc(OmInt br) const {
+    OmInt i = Row(br);                  /* row of branch                     */
+    return i < 0 ? 0.0 : vecXc[i];
+}
+/*========== SetQs ===================*//** Function [8]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP void OmFixed<C, M, B>::SetQs(OmInt br, OmFlt x) {
+    OmInt i = Row(br);                  /* row of branch                     */
+    if (i >= 0) vecQs[i] = x;
+}
+/*========== SetSw ===================*//** Function [9]                     */
+template <OmInt C, OmInt M, OmInt B>
+OMCXP void OmFixed<C, M, B>::SetSw(OmInt br, OmInt s) {
+    OmInt i = Row(br);                  /* row of branch                     */
+    if (i < 0) return;                  /* cut branch                        */
+    vecW1m[i] = (s == 0) ? vecW1o[i] : vecW1c[i];
+    vecW2m[i] = (s == 0) ? vecW2o[i] : vecW2c[i];
+    vecW1s[i] = vecW1m[i];
+    vecW2s[i] = vecW2m[i];
+}
+
+/*====================== Part 6. Undefine Macro =============================*/
+
+#undef OMCXP
+
+/*===========================================================================*/
+#endif                                  /*| #ifndef LIBOHM_HPP              |*/
+/*===========================================================================*/
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 10 - Load switch pulse circuit of test 7 from text and binary netlist */
+
+static const char* NET =
+    "* switch pulse circuit, same as test 7\n"
+    ".BR 1 1 0 X1\n"
+    "V1 1 100\n"
+    "X1 1 1k             ; source resistance\n"
+    ".BR 2 1 2 SW\n"
+    "S2 2 1.0 0.6569 0.2929m 0\n"
+    ".BR 3 2 0 -Y2       ; back Euler capacitor\n"
+    "C3 3 1uF\n"
+    ".BR 4 2 0 Y0\n"
+    "Y4 4 1m\n"
+    ".MV 1 2 0\n"
+    ".END\n";
+
+static void Run(OmCir* cr) {
+    int i;
+    OmStamp(cr);
+    for (i=0; i < 4000; ++i) {
+        OmSetSw(cr, 2, (i / 500) % 2 == 0);
+        OmUpdSw(cr);
+        OmUpdCr(cr);
+        OmUpdMt(cr);
+        if (i % 500 == 499) printf("%lf ", OmGetMt(cr, 1));
+    }
+    printf("\n");
+    OmDelete(cr);
+}
+
+int main() {
+    FILE* ft = tmpfile();
+    FILE* fb = tmpfile();
+    OmCir* cr;
+    OmInt nr, ln;
+    fputs(NET, ft);
+    rewind(ft);
+    cr = OmLoad(ft, 1e-6, &ln);
+    printf("text: n=%d, b=%d, m=%d, error line %d\n",
+        (int)cr->numN, (int)cr->numB, (int)cr->numM, (int)ln);
+    Run(cr);
+    rewind(ft);
+    nr = OmNetBin(ft, fb, &ln);
+    rewind(fb);
+    cr = OmLoad(fb, 1e-6, &ln);
+    printf("binary: %d records, error %d\n", (int)nr, (int)ln);
+    Run(cr);
+    fclose(ft);
+    fclose(fb);
+    ft = tmpfile();
+    fputs(".BR 1 1 0 X1\nV1 1 100\nC1 1 1u\n", ft);
+    rewind(ft);
+    cr = OmLoad(ft, 1e-6, &ln);
+    printf("C on X-type branch: %s, error line %d\n",
+        cr == NULL ? "rejected" : "accepted", (int)ln);
+    fclose(ft);
+    return 0;
+}
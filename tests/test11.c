@@ -0,0 +1,66 @@
+#include <stdio.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 11 - Reduce resistive network around RC load before stamping */
+
+static OmCir* Build(void) {
+    OmCir* cr = OmCreate(8, 13, 2, 1e-4);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with resistance */
+    OmAddV(cr, 1, 10);
+    OmAddX(cr, 1, 1);
+    OmBran(cr, 2, 1, 2, OMTYP_Y0);          /* ladder */
+    OmAddY(cr, 2, 1);
+    OmBran(cr, 3, 2, 0, OMTYP_Y0);          /* parallel pair */
+    OmAddY(cr, 3, 0.5);
+    OmBran(cr, 4, 0, 2, OMTYP_Y0);
+    OmAddY(cr, 4, 0.5);
+    OmBran(cr, 5, 2, 3, OMTYP_X0);          /* series pair */
+    OmAddX(cr, 5, 2);
+    OmBran(cr, 6, 3, 4, OMTYP_X0);
+    OmAddX(cr, 6, 3);
+    OmBran(cr, 7, 4, 0, OMTYP_Y2);          /* RC load */
+    OmAddC(cr, 7, 0.05, 0);
+    OmAddY(cr, 7, 0.1);
+    OmBran(cr, 8, 4, 5, OMTYP_Y0);          /* star around node 5 */
+    OmAddY(cr, 8, 1);
+    OmBran(cr, 9, 5, 0, OMTYP_Y0);
+    OmAddY(cr, 9, 1);
+    OmBran(cr, 10, 5, 6, OMTYP_X0);
+    OmAddX(cr, 10, 1);
+    OmBran(cr, 11, 6, 7, OMTYP_Y0);         /* dangling */
+    OmAddY(cr, 11, 2);
+    OmBran(cr, 12, 4, 8, OMTYP_X0);         /* short to node 8 */
+    OmBran(cr, 13, 8, 0, OMTYP_Y0);
+    OmAddY(cr, 13, 0.25);
+    OmMetV(cr, 1, 4, 0);
+    OmMetA(cr, 2, 1);
+    return cr;
+}
+
+int main() {
+    OmCir* c1 = Build();
+    OmCir* c2 = Build();
+    OmInt i, nr;
+    OmFlt e = 0.0, d;
+    nr = OmReduce(c2);
+    printf("removed %d branches, nodes %d -> %d, X-type %d -> %d\n",
+        (int)nr, (int)c1->numN, (int)c2->numN,
+        (int)c1->numX, (int)c2->numX);
+    OmStamp(c1);
+    OmStamp(c2);
+    for (i=0; i < 2000; ++i) {
+        OmUpdCr(c1); OmUpdMt(c1);
+        OmUpdCr(c2); OmUpdMt(c2);
+        d = OMABS(OmGetMt(c1, 1) - OmGetMt(c2, 1))
+          + OMABS(OmGetMt(c1, 2) - OmGetMt(c2, 2));
+        if (d > e) e = d;
+        if (i % 400 == 399) {
+            printf("V=%lf, I=%lf\n", OmGetMt(c2, 1), OmGetMt(c2, 2));
+        }
+    }
+    printf("max difference %s 1e-12\n", e < 1e-12 ? "<" : ">=");
+    OmDelete(c1);
+    OmDelete(c2);
+    return 0;
+}
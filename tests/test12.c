@@ -0,0 +1,51 @@
+#include <stdio.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 12 - Krylov order reduction of RC ladder (cable model) */
+
+#define NS 200                              /* number of ladder sections */
+
+int main() {
+    OmCir* cr = OmCreate(NS + 1, 2 * NS + 2, 1, 1e-5);
+    OmCir* rd;
+    OmFlt pol[16], e = 0.0, d, pm = 0.0;
+    OmInt i, map[2 * NS + 2];
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 1);
+    for (i=0; i < NS; ++i) {
+        OmBran(cr, 2 * i + 2, i + 1, i + 2, OMTYP_X0);
+        OmAddX(cr, 2 * i + 2, 0.05);        /* series resistance */
+        OmBran(cr, 2 * i + 3, i + 2, 0, OMTYP_Y2);
+        OmAddC(cr, 2 * i + 3, 1e-6, 0);     /* shunt capacitance */
+    }
+    OmBran(cr, 2 * NS + 2, NS + 1, 0, OMTYP_Y0);
+    OmAddY(cr, 2 * NS + 2, 1.0 / 50);       /* load */
+    OmMetV(cr, 1, NS + 1, 0);
+    OmStamp(cr);
+    rd = OmMor(cr, NULL, 0, 8, 1e-10, map, pol);
+    printf("numC %d -> %d, source branch -> %d\n",
+        (int)cr->numC, (int)rd->numC, (int)map[0]);
+    for (i=0; i < rd->numC - 1; ++i) {
+        d = pol[2*i] * pol[2*i] + pol[2*i+1] * pol[2*i+1];
+        if (d > pm) pm = d;
+    }
+    printf("max pole magnitude %s 1\n", pm < 1.0 ? "<" : ">=");
+    for (i=0; i < 20000; ++i) {
+        OmSetQs(cr, 1, i < 10000 ? 100 : 0);
+        OmSetQs(rd, map[0], i < 10000 ? 100 : 0);
+        OmUpdCr(cr); OmUpdMt(cr);
+        OmUpdCr(rd); OmUpdMt(rd);
+        d = OMABS(OmGetMt(cr, 1) - OmGetMt(rd, 1));
+        if (d > e) e = d;
+        if (i % 10000 < 800 && i % 100 == 99) {
+            printf("t=%.4f V=%lf Vr=%lf\n",
+                (i + 1) * 1e-5, OmGetMt(cr, 1), OmGetMt(rd, 1));
+        }
+    }
+    printf("max error %.3e of 100 V\n", e);
+    OmDelete(cr);
+    OmDelete(rd);
+    return 0;
+}
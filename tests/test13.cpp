@@ -0,0 +1,59 @@
+#include <stdio.h>
+#define LIBOHM_C
+#include "libohm.hpp"
+
+/* Test 13 - Fixed-size C++ runtime of switch pulse circuit of test 7 */
+
+#if __cplusplus >= 201703L
+constexpr OmFlt RcStep(int n) {             /* RC low-pass at compile time */
+    OmFixed<1, 1> f{};
+    f.matC[0] = 1.0;
+    f.matD[0] = 1.0;
+    f.vecW1o[0] = 0.01;
+    f.vecW2o[0] = 0.98;
+    f.vecQs0[0] = 1.0;
+    f.Reset();
+    for (int i=0; i < n; ++i) f.UpdCr();
+    f.UpdMt();
+    return f.GetMt(1);
+}
+static_assert(RcStep(100) > 1.6 && RcStep(100) < 1.7, "constexpr step");
+#endif
+
+int main() {
+    const OmFlt VG = 100;                   /* input voltage */
+    const OmFlt R = 1000;                   /* load resistance */
+    OmCir* cr = OmCreate(2, 4, 1, 1e-6);
+    static OmFixed<3, 1, 4> fx;             /* no heap allocation */
+    int i, same = 1;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);
+    OmAddV(cr, 1, VG);
+    OmAddX(cr, 1, R);
+    OmBran(cr, 2, 1, 2, OMTYP_SW);
+    OmAddS(cr, 2, 1.0, 0.6569, 0.2929 / 1000, 0.0);
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);
+    OmAddC(cr, 3, 1e-6, 0.0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y0);
+    OmAddY(cr, 4, 1.0 / R);
+    OmMetV(cr, 1, 2, 0);
+    OmStamp(cr);
+    if (!fx.Load(cr)) {
+        printf("size mismatch, numC=%d\n", (int)cr->numC);
+        return 1;
+    }
+    for (i=0; i < 10000; ++i) {
+        OmSetSw(cr, 2, (i / 1000) % 2 == 0);
+        fx.SetSw(2, (i / 1000) % 2 == 0);
+        OmUpdSw(cr);
+        fx.UpdSw();
+        OmUpdCr(cr);
+        fx.UpdCr();
+        OmUpdMt(cr);
+        fx.UpdMt();
+        if (OmGetMt(cr, 1) != fx.GetMt(1)) same = 0;
+        if (i % 1000 == 999) printf("%lf\n", fx.GetMt(1));
+    }
+    printf("bitwise same as C runtime: %s\n", same ? "yes" : "no");
+    OmDelete(cr);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#define LIBOHM_C
+#define LIBOHM_PTHREAD
+#define LIBOHM_ATOMIC
+#include "libohm.h"
+
+/* Test 14 - Controller, simulation and monitor threads sharing one channel */
+
+#define NCMD 200                            /* commands sent by controller */
+
+static OmChn* ch;                           /* shared channel */
+static volatile int done;                   /* controller has sent all */
+static volatile int stop;                   /* simulation has finished */
+static int torn;                            /* inconsistent snapshots */
+
+static void* Controller(void* arg) {
+    int i;
+    (void)arg;
+    for (i=1; i <= NCMD; ++i) {             /* ramp source, 10 steps apart */
+        while (OmChnPut(ch, OMCMD_QS, 1, -1.0 * i, 10 * i) != 0);
+    }
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void* Monitor(void* arg) {
+    OmFlt xm[2];
+    (void)arg;
+    while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE)) {
+        if (OmChnGet(ch, xm, NULL) < 0) continue;
+        if (xm[0] - 2.0 * xm[1] > 1e-9 || 2.0 * xm[1] - xm[0] > 1e-9) {
+            torn += 1;                      /* divider ratio must hold */
+        }
+    }
+    return NULL;
+}
+
+int main() {
+    pthread_t tc, tm;
+    OmCir* cr = OmCreate(2, 3, 2, 1e-6);
+    OmFlt xm[2];
+    OmInt k, i;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with 1k resistance */
+    OmAddV(cr, 1, 0.0);
+    OmAddX(cr, 1, 1000);
+    OmBran(cr, 2, 1, 2, OMTYP_Y0);          /* upper divider resistor */
+    OmAddY(cr, 2, 1e-3);
+    OmBran(cr, 3, 2, 0, OMTYP_Y0);          /* lower divider resistor */
+    OmAddY(cr, 3, 1e-3);
+    OmMetV(cr, 1, 1, 0);
+    OmMetV(cr, 2, 2, 0);
+    OmStamp(cr);
+    ch = OmChnNew(cr, 4);                   /* single thread checks first */
+    for (i=1; i <= 5; ++i) printf("%d ", (int)OmChnPut(ch, OMCMD_QS, 1, 0, i));
+    printf("<- put into ring of 4\n");
+    printf("applied %d switch commands, ", (int)OmChnRun(ch, 2));
+    printf("next put %d, ", (int)OmChnPut(ch, OMCMD_QS, 1, 0, 9));
+    printf("snapshot step %d\n", (int)OmChnGet(ch, NULL, NULL));
+    OmChnDel(ch);
+    ch = OmChnNew(cr, 16);
+    pthread_create(&tc, NULL, Controller, NULL);
+    pthread_create(&tm, NULL, Monitor, NULL);
+    for (k=0; k < 10 * NCMD || !__atomic_load_n(&done, __ATOMIC_ACQUIRE)
+         || ch->idxH != __atomic_load_n(&ch->idxT, __ATOMIC_ACQUIRE); ++k) {
+        if (OmChnRun(ch, k) != 0) OmUpdSw(cr);
+        OmUpdCr(cr);
+        OmUpdMt(cr);
+        OmChnPub(ch, k);
+    }
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    pthread_join(tc, NULL);
+    pthread_join(tm, NULL);
+    OmChnGet(ch, xm, NULL);
+    printf("final: %lf %lf, torn snapshots %d\n", xm[0], xm[1], torn);
+    OmChnDel(ch);
+    OmDelete(cr);
+    return 0;
+}
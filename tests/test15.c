@@ -0,0 +1,149 @@
+#include <stdio.h>
+#define LIBOHM_C
+#include "libohm.h"
+#include <math.h>
+
+/* Test 15 - Three-phase inverter driven by built-in sine and PWM generators */
+
+static OmCir* Legs(OmInt n, OmFlt dt) {    /* n switched RC legs */
+    OmCir* cr = OmCreate(2 * n, 3 * n, n, dt);
+    OmInt k;
+    for (k=0; k < n; ++k) {
+        OmBran(cr, 3 * k + 1, 2 * k + 1, 0, OMTYP_X1);
+        OmAddV(cr, 3 * k + 1, 10);
+        OmAddX(cr, 3 * k + 1, 100);
+        OmBran(cr, 3 * k + 2, 2 * k + 1, 2 * k + 2, OMTYP_SW);
+        OmAddS(cr, 3 * k + 2, 1.0, 0.0, 0.0, 0.0);
+        OmBran(cr, 3 * k + 3, 2 * k + 2, 0, OMTYP_Y2);
+        OmAddC(cr, 3 * k + 3, 1e-5, 0);
+        OmAddY(cr, 3 * k + 3, 1e-3);
+        OmMetV(cr, k + 1, 2 * k + 2, 0);
+    }
+    OmStamp(cr);
+    return cr;
+}
+
+int main() {
+    const OmFlt VD = 200;                   /* half of dc bus voltage */
+    const OmFlt R = 10;                     /* load resistance */
+    const OmFlt L = 10e-3;                  /* load inductance */
+    const OmFlt F = 50;                     /* output frequency */
+    const OmFlt FC = 5e3;                   /* carrier frequency */
+    const OmFlt MI = 0.8;                   /* modulation index */
+    const OmFlt DT = 1e-6;                  /* time step */
+    const OmFlt K1 = 1.0;                   /* closed state coefficient */
+    const OmFlt K2 = 0.6569;                /* open state coefficient */
+    const OmFlt YS = 0.2929;                /* switch conductance */
+    OmFlt tp[3] = {0.0, 1e-3, 2e-3};        /* PWL points */
+    OmFlt vp[3] = {0.0, 1.0, 1.0};
+    OmFlt vt[4] = {1.0, 2.0, 3.0, 4.0};     /* table samples */
+    OmCir* cr = OmCreate(5, 11, 3, DT);
+    OmWav* wv;
+    OmFlt ip[3], er;
+    OmInt i, k, ns, g;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* upper half of dc bus */
+    OmAddV(cr, 1, -VD);
+    OmAddX(cr, 1, 1e-3);
+    OmBran(cr, 2, 0, 2, OMTYP_X1);          /* lower half of dc bus */
+    OmAddV(cr, 2, -VD);
+    OmAddX(cr, 2, 1e-3);
+    for (k=0; k < 3; ++k) {
+        OmBran(cr, 3 + 2 * k, 1, 3 + k, OMTYP_SW);
+        OmAddS(cr, 3 + 2 * k, K1, K2, YS, 0.0);
+        OmBran(cr, 4 + 2 * k, 3 + k, 2, OMTYP_SW);
+        OmAddS(cr, 4 + 2 * k, K1, K2, YS, 0.0);
+        OmBran(cr, 9 + k, 3 + k, 0, OMTYP_X2);
+        OmAddX(cr, 9 + k, R);
+        OmAddL(cr, 9 + k, L, 0.0);
+        OmMetA(cr, 1 + k, 9 + k);
+    }
+    OmStamp(cr);
+    wv = OmWavNew(cr, 9);
+    for (k=0; k < 3; ++k) {                 /* reference drives no branch */
+        g = OmWavSin(wv, 0, 1.0, F, -2.0 * 3.14159265358979 * k / 3, 0);
+        OmWavPwm(wv, 3 + 2 * k, FC, 0.0, g, MI, 0);
+        OmWavPwm(wv, 4 + 2 * k, FC, 0.0, g, MI, 1);
+    }
+    for (i=0; i < 10; ++i) OmUpdSw(cr);
+    ns = 0;
+    ip[0] = ip[1] = ip[2] = 0.0;
+    for (i=0; i < 100000; ++i) {            /* 5 periods, peak of last */
+        ns += OmWavRun(wv, 10);
+        OmUpdMt(cr);
+        for (k=0; i >= 80000 && k < 3; ++k) {
+            if (OmGetMt(cr, 1 + k) > ip[k]) ip[k] = OmGetMt(cr, 1 + k);
+        }
+    }
+    printf("switch changes %d, peak current %.1lf %.1lf %.1lf A\n",
+        (int)ns, ip[0], ip[1], ip[2]);
+    er = 2 * 3.14159265358979 * F * L;      /* load reactance */
+    printf("fundamental about %.1lf A\n", MI * VD / sqrt(R*R + er*er));
+    OmWavDel(wv);
+    OmDelete(cr);
+    /* sine recurrence against sin(), PWL and table on a resistor */
+    cr = OmCreate(1, 1, 1, DT);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);
+    OmAddV(cr, 1, 0.0);
+    OmAddX(cr, 1, 1.0);
+    OmMetV(cr, 1, 1, 0);
+    OmStamp(cr);
+    wv = OmWavNew(cr, 3);
+    g = OmWavSin(wv, 1, 1.0, F, 0.3, 0.0);
+    er = 0.0;
+    for (i=0; i < 1000000; ++i) {
+        OmFlt d = wv->vecWv[g-1] - sin(2 * 3.14159265358979323846 * F * DT
+                                       * i + 0.3);
+        if (OMABS(d) > er) er = OMABS(d);
+        OmWavRun(wv, 0);
+    }
+    printf("sine max error over 1e6 steps: %s\n", er < 1e-9 ? "< 1e-9" : "!!");
+    OmWavDel(wv);
+    wv = OmWavNew(cr, 2);
+    g = OmWavPwl(wv, 1, 3, tp, vp, 2e-3);
+    printf("pwl:");
+    for (i=0; i < 2600; ++i) {
+        if (i % 250 == 0) printf(" %.2lf", wv->vecWv[g-1]);
+        OmWavRun(wv, 0);
+    }
+    OmWavDel(wv);
+    wv = OmWavNew(cr, 2);
+    g = OmWavTab(wv, 1, 4, vt, 1);
+    printf("\ntab:");
+    for (i=0; i < 6; ++i) {
+        OmWavRun(wv, 0);
+        printf(" %.0lf", cr->vecQs[0]);
+    }
+    printf("\n");
+    OmWavDel(wv);
+    OmDelete(cr);
+    /* two comparators crossing in one step, against 100 times finer step */
+    {
+        OmCir* cf = Legs(2, 1e-7);
+        OmWav* wf;
+        OmFlt d[2] = {0.3, 0.31};
+        cr = Legs(2, 1e-5);
+        wv = OmWavNew(cr, 2);
+        wf = OmWavNew(cf, 2);
+        for (k=0; k < 2; ++k) {
+            OmWavPwm(wv, 3 * k + 2, 1e3, 0.0, 0, d[k], 0);
+            OmWavPwm(wf, 3 * k + 2, 1e3, 0.0, 0, d[k], 0);
+        }
+        ns = 0;
+        ip[0] = ip[1] = 0.0;
+        for (i=0; i < 5000; ++i) {          /* mean of leg 2 - leg 1 */
+            ns += OmWavRun(wv, 10) == 2;
+            for (k=0; k < 100; ++k) OmWavRun(wf, 10);
+            OmUpdMt(cr);
+            OmUpdMt(cf);
+            ip[0] += (OmGetMt(cr, 2) - OmGetMt(cr, 1)) / 5000;
+            ip[1] += (OmGetMt(cf, 2) - OmGetMt(cf, 1)) / 5000;
+        }
+        printf("steps with two crossings %d, duty offset %.4lf V "
+            "(fine step %.4lf V)\n", (int)ns, ip[0], ip[1]);
+        OmWavDel(wv);
+        OmWavDel(wf);
+        OmDelete(cr);
+        OmDelete(cf);
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdio.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 16 - Monte Carlo batch of RC ladder instances sharing one operator */
+
+#define NS 64                               /* number of ladder sections */
+#define NK 256                              /* number of instances */
+
+static OmCir* Ladder(void) {
+    OmCir* cr = OmCreate(NS + 1, 2 * NS + 3, 1, 1e-5);
+    OmInt i;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 1);
+    for (i=0; i < NS; ++i) {
+        OmBran(cr, 2 * i + 2, i + 1, i + 2, OMTYP_X0);
+        OmAddX(cr, 2 * i + 2, 0.05);        /* series resistance */
+        OmBran(cr, 2 * i + 3, i + 2, 0, OMTYP_Y2);
+        OmAddC(cr, 2 * i + 3, 1e-6, 0);     /* shunt capacitance */
+    }
+    OmBran(cr, 2 * NS + 2, NS + 1, 0, OMTYP_SW);
+    OmAddS(cr, 2 * NS + 2, 1.0, 0.6569, 0.2929 / 50, 0.0);
+    OmBran(cr, 2 * NS + 3, NS + 1, 0, OMTYP_Y0);
+    OmAddY(cr, 2 * NS + 3, 1.0 / 50);       /* load */
+    OmMetV(cr, 1, NS + 1, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static OmFlt Profile(OmInt k, OmInt i) {    /* source of instance k */
+    return (i < 3000 + 2 * k) ? 100 + 0.1 * k : 0;
+}
+
+int main() {
+    OmCir* cr = Ladder();
+    OmCir* one;
+    OmBat* bt = OmBatNew(cr, NK);
+    OmInt i, k, nd = 0, kc[3] = {1, 100, NK};
+    OmFlt v[3];
+    printf("numC %d, %d instances, extra references %d\n",
+        (int)cr->numC, NK, (int)cr->numR);
+    OmDelete(cr);                           /* batch keeps operator alive */
+    for (i=0; i < 3100; ++i) {
+        for (k=1; k <= NK; ++k) {
+            OmBatSetQs(bt, k, 1, Profile(k, i));
+            if (i == 2000) OmBatSetSw(bt, k, 2 * NS + 2, k % 2);
+        }
+        if (i == 2000) for (k=0; k < 10; ++k) OmBatUpdSw(bt);
+        OmBatUpdCr(bt);
+        OmBatUpdMt(bt);
+    }
+    for (i=0; i < 3; ++i) {                 /* replay instances one by one */
+        one = Ladder();
+        for (k=0; k < 3100; ++k) {
+            OmSetQs(one, 1, Profile(kc[i], k));
+            if (k == 2000) {
+                OmSetSw(one, 2 * NS + 2, kc[i] % 2);
+                for (nd=0; nd < 10; ++nd) OmUpdSw(one);
+            }
+            OmUpdCr(one);
+            OmUpdMt(one);
+        }
+        v[i] = OmGetMt(one, 1);
+        printf("instance %3d: batch %lf, single %lf, %s\n", (int)kc[i],
+            OmBatGetMt(bt, kc[i], 1), v[i],
+            OmBatGetMt(bt, kc[i], 1) == v[i] ? "bitwise equal" : "DIFFER");
+        OmDelete(one);
+    }
+    OmBatDel(bt);                           /* last reference frees cr */
+    return 0;
+}
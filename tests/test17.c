@@ -0,0 +1,71 @@
+#include <stdio.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 17 - Tolerance study of RLC filter stamped and run as SIMD ensemble */
+
+#define NE 1000                             /* number of variants */
+
+static unsigned long seed = 12345;
+
+static OmFlt Tol(OmFlt x, OmFlt t) {        /* x * (1 +- t), uniform */
+    seed = (seed * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return x * (1.0 + t * (2.0 * seed / 2147483647.0 - 1.0));
+}
+
+static OmCir* Filter(OmInt e) {
+    OmCir* cr = OmCreate(2, 4, 1, 1e-6);
+    seed = 12345 + 7919 * e;                /* same values on rebuild */
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 0.5);
+    OmBran(cr, 2, 1, 2, OMTYP_X2);          /* inductor with winding */
+    OmAddL(cr, 2, Tol(1e-3, 0.1), 0);
+    OmAddX(cr, 2, Tol(0.2, 0.1));
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);          /* capacitor */
+    OmAddC(cr, 3, Tol(10e-6, 0.1), 0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y0);          /* load */
+    OmAddY(cr, 4, 1.0 / Tol(10, 0.05));
+    OmMetV(cr, 1, 2, 0);
+    return cr;
+}
+
+int main() {
+    OmCir* crs[NE];
+    OmCir* one;
+    OmEns* en;
+    OmInt e, i, j, ke[3] = {1, 500, NE};
+    OmFlt vmin = 1e30, vmax = -1e30, v;
+    for (e=0; e < NE; ++e) crs[e] = Filter(e);
+    en = OmEnsNew(crs, NE);
+    for (e=0; e < NE; ++e) OmDelete(crs[e]);
+    printf("%d variants, %d packs of %d lanes, %d stamped alone\n",
+        (int)en->numE, (int)en->numP, OMENS_LN, (int)en->numF);
+    for (e=1; e <= NE; ++e) OmEnsSetQs(en, e, 1, 100);
+    for (i=0; i < 300; ++i) {               /* peak of step response */
+        OmEnsUpdCr(en);
+        OmEnsUpdMt(en);
+    }
+    for (e=1; e <= NE; ++e) {
+        v = OmEnsGetMt(en, e, 1);
+        if (v < vmin) vmin = v;
+        if (v > vmax) vmax = v;
+    }
+    printf("output at 0.3 ms: %.2lf V to %.2lf V\n", vmin, vmax);
+    for (j=0; j < 3; ++j) {                 /* replay variants one by one */
+        one = Filter(ke[j] - 1);
+        OmStamp(one);
+        OmSetQs(one, 1, 100);
+        for (i=0; i < 300; ++i) {
+            OmUpdCr(one);
+            OmUpdMt(one);
+        }
+        printf("variant %4d: ensemble %lf, single %lf, %s\n", (int)ke[j],
+            OmEnsGetMt(en, ke[j], 1), OmGetMt(one, 1),
+            OmEnsGetMt(en, ke[j], 1) == OmGetMt(one, 1) ?
+            "bitwise equal" : "DIFFER");
+        OmDelete(one);
+    }
+    OmEnsDel(en);
+    return 0;
+}
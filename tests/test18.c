@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 18 - Fast-forward RLC filter over long idle spans with OmAdvance() */
+
+static OmCir* Filter(void) {
+    OmCir* cr = OmCreate(2, 4, 1, 1e-6);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 0.5);
+    OmBran(cr, 2, 1, 2, OMTYP_X2);          /* inductor with winding */
+    OmAddL(cr, 2, 1e-3, 0);
+    OmAddX(cr, 2, 0.2);
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);          /* capacitor */
+    OmAddC(cr, 3, 10e-6, 0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y0);          /* load */
+    OmAddY(cr, 4, 0.1);
+    OmMetV(cr, 1, 2, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+int main() {
+    OmCir* fa = Filter();                   /* fast-forwarded */
+    OmCir* fs = Filter();                   /* stepped */
+    OmInt i, j, r, span[4] = {250, 100000, 12345, 2};
+    OmFlt vs[4] = {100, 100, 50, 80};
+    for (j=0; j < 4; ++j) {
+        OmSetQs(fa, 1, vs[j]);
+        OmSetQs(fs, 1, vs[j]);
+        r = OmAdvance(fa, span[j]);
+        for (i=0; i < span[j]; ++i) OmUpdCr(fs);
+        OmUpdMt(fa);
+        OmUpdMt(fs);
+        printf("%6d steps at %3.0lf V: %s, %d powers, %lf V vs %lf V, "
+            "error %s\n", (int)span[j], vs[j], r ? "squared" : "stepped",
+            (int)fa->numP, OmGetMt(fa, 1), OmGetMt(fs, 1),
+            fabs(OmGetMt(fa, 1) - OmGetMt(fs, 1)) < 1e-9 ? "< 1e-9" : "LARGE");
+    }
+    OmDelete(fa);
+    OmDelete(fs);
+    return 0;
+}
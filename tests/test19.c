@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 19 - Resistive ladder with LC load run on dynamic states only */
+
+#define NR 12                               /* resistive ladder sections */
+
+static OmCir* Ladder(void) {
+    OmCir* cr = OmCreate(NR + 3, 2 * NR + 5, 2, 1e-6);
+    OmInt i;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 0.5);
+    for (i=0; i < NR; ++i) {                /* series X1 and shunt Y1 */
+        OmBran(cr, 2*i+2, i+1, i+2, OMTYP_X1);
+        OmAddX(cr, 2*i+2, 0.1);
+        OmBran(cr, 2*i+3, i+2, 0, OMTYP_Y1);
+        OmAddY(cr, 2*i+3, 0.01);
+    }
+    OmBran(cr, 2*NR+2, NR+1, NR+2, OMTYP_X2);   /* inductor */
+    OmAddL(cr, 2*NR+2, 1e-3, 0);
+    OmAddX(cr, 2*NR+2, 0.2);
+    OmBran(cr, 2*NR+3, NR+2, 0, OMTYP_Y2);  /* capacitor */
+    OmAddC(cr, 2*NR+3, 10e-6, 0);
+    OmBran(cr, 2*NR+4, NR+2, NR+3, OMTYP_SW);   /* switched load */
+    OmAddS(cr, 2*NR+4, 1.0, 0.6569, 0.2929e-3, 0);
+    OmBran(cr, 2*NR+5, NR+3, 0, OMTYP_Y1);
+    OmAddY(cr, 2*NR+5, 0.1);
+    OmMetV(cr, 1, NR+2, 0);
+    OmMetA(cr, 2, 2*NR+2);
+    OmStamp(cr);
+    return cr;
+}
+
+int main() {
+    OmCir* cf = Ladder();                   /* full runtime form */
+    OmCir* cs = Ladder();                   /* state-space runtime form */
+    OmFlt a[16], b[32], cm[32], dm[64], x[4], u[8], y;
+    OmInt bx[4], bu[8], d, k, i, j, eq = 1;
+    OmFlt err = 0.0;
+    OmSetQs(cf, 1, 100);
+    OmSetQs(cs, 1, 100);
+    d = OmSsx(cs, 0, NULL);
+    k = cs->numU;
+    printf("c = %d rows, d = %d states, k = %d columns\n",
+        (int)cs->numC, (int)d, (int)k);
+    for (i=0; i < 4000; ++i) {
+        OmSetSw(cf, 2*NR+4, (i / 500) % 2);
+        OmSetSw(cs, 2*NR+4, (i / 500) % 2);
+        OmUpdSw(cf);
+        OmUpdSw(cs);
+        OmUpdCr(cf);
+        OmUpdCr(cs);
+        OmUpdMt(cf);
+        OmUpdMt(cs);
+        eq = eq && OmGetMt(cf, 1) == OmGetMt(cs, 1) &&
+             OmGetMt(cf, 2) == OmGetMt(cs, 2);
+        if (i % 1000 == 999) printf("%lf ", OmGetMt(cs, 1));
+    }
+    printf("\nstate-space vs full: %s\n", eq ? "bitwise equal" : "DIFFER");
+    OmGetSs(cs, a, b, cm, dm, bx, bu);
+    printf("states on branch");
+    for (i=0; i < d; ++i) printf(" %d", (int)bx[i]);
+    printf(", columns on branch");
+    for (j=0; j < k; ++j) printf(" %d", (int)bu[j]);
+    printf("\n");
+    for (i=0; i < d; ++i) x[i] = cs->vecQa[cs->vecLut[bx[i]-1]];
+    for (j=0; j < k; ++j) u[j] = cs->vecQs[cs->vecLut[bu[j]-1]];
+    OmUpdCr(cs);
+    OmUpdMt(cs);
+    for (i=0; i < d; ++i) {                 /* x' = A @ x + B @ u */
+        y = 0.0;
+        for (j=0; j < d; ++j) y += a[i*d+j] * x[j];
+        for (j=0; j < k; ++j) y += b[i*k+j] * u[j];
+        y = fabs(y - cs->vecQa[cs->vecLut[bx[i]-1]]);
+        if (y > err) err = y;
+    }
+    for (i=0; i < 2; ++i) {                 /* Xm = Cm @ x + Dm @ u */
+        y = 0.0;
+        for (j=0; j < d; ++j) y += cm[i*d+j] * x[j];
+        for (j=0; j < k; ++j) y += dm[i*k+j] * u[j];
+        y = fabs(y - OmGetMt(cs, i + 1));
+        if (y > err) err = y;
+    }
+    printf("exported (A, B, Cm, Dm) error %s\n",
+        err < 1e-9 ? "< 1e-9" : "LARGE");
+    OmDelete(cf);
+    OmDelete(cs);
+    return 0;
+}
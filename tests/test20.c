@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 20 - Compare back Euler, trapezoidal and BDF2 capacitor on RC circuit */
+
+static OmCir* Rc(OmInt tm, OmFlt cap, OmFlt stp) {
+    OmCir* cr = OmCreate(1, 2, 1, stp);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with 1k resistance */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 1e3);
+    OmBran(cr, 2, 1, 0, tm);                /* capacitor under test */
+    OmAddC(cr, 2, cap, 0);
+    OmMetV(cr, 1, 1, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+int main() {
+    const char* nm[3] = {"BE  ", "TR  ", "BDF2"};
+    OmInt tm[3] = {-OMTYP_Y2, OMTYP_Y2, OMTYP_Y2 + OMMTD_BD2};
+    OmFlt w = 2 * 3.14159265358979 * 200, tau = 1e-3, t, h, x, e[3];
+    OmInt i, j, k, n;
+    OmCir* cr;
+    printf("sine driven RC, error at 5ms for h = 100us, 50us, 25us\n");
+    for (k=0; k < 3; ++k) {
+        for (j=0; j < 3; ++j) {
+            h = 1e-4 / (1 << j);
+            n = (OmInt)(5e-3 / h + 0.5);
+            cr = Rc(tm[k], 1e-6, h);
+            for (i=0; i < n; ++i) {
+                OmSetQs(cr, 1, sin(w * (i + 1) * h));
+                OmUpdCr(cr);
+            }
+            OmUpdMt(cr);
+            t = n * h;
+            x = (sin(w * t) - w * tau * cos(w * t) + w * tau * exp(-t / tau))
+                / (1 + w * w * tau * tau);
+            e[j] = fabs(OmGetMt(cr, 1) - x);
+            OmDelete(cr);
+        }
+        printf("%s: %.3le %.3le %.3le, ratio %.1lf %.1lf\n", nm[k],
+            e[0], e[1], e[2], e[0] / e[1], e[1] / e[2]);
+    }
+    printf("stiff RC (tau = 1us, h = 100us), unit step response\n");
+    for (k=0; k < 3; ++k) {
+        cr = Rc(tm[k], 1e-9, 1e-4);
+        printf("%s:", nm[k]);
+        for (i=0; i < 6; ++i) {
+            OmSetQs(cr, 1, 1.0);
+            OmUpdCr(cr);
+            OmUpdMt(cr);
+            printf(" %8.5lf", OmGetMt(cr, 1));
+        }
+        printf("\n");
+        OmDelete(cr);
+    }
+    cr = OmCreate(1, 3, 1, 1e-4);           /* decoding of tm */
+    OmBran(cr, 1, 1, 0, -(OMTYP_Y2 + OMMTD_BD2));
+    OmBran(cr, 2, 1, 0, -OMTYP_X2 + OMMTD_BD2);
+    OmBran(cr, 3, 1, 0, OMTYP_Y2 + OMMTD_BD2);
+    OmBran(cr, 3, 1, 0, OMTYP_Y2);
+    printf("BE + BD2: tm %d, -X2 + BD2: tm %d, BD2 then TR: tm %d bdf2 %d\n",
+        (int)cr->vecBtm[0], (int)cr->vecBtm[1], (int)cr->vecBtm[2],
+        (int)cr->vecBd[2]);
+    OmDelete(cr);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 21 - Tune switch of pulse circuit at stamp time, check its error */
+
+static OmCir* Pulse(OmFlt k2, OmFlt ys) {
+    OmCir* cr = OmCreate(2, 4, 1, 1e-6);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with 1k resistance */
+    OmAddV(cr, 1, 100);
+    OmAddX(cr, 1, 1000);
+    OmBran(cr, 2, 1, 2, OMTYP_SW);          /* switch under test */
+    OmAddS(cr, 2, 1.0, k2, ys, 0.0);
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);          /* filter capacitor */
+    OmAddC(cr, 3, 1e-6, 0.0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y0);          /* load */
+    OmAddY(cr, 4, 1e-3);
+    OmMetV(cr, 1, 2, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static void Check(const char* nm, OmCir* cr) {
+    OmFlt sv[64], v[6], vf, e;
+    OmInt i, s;
+    for (s=1; s >= 0; --s) {                /* close, then open the switch */
+        OmSetSw(cr, 2, s);
+        for (i=0; i < 6; ++i) {             /* switch voltage per substep */
+            OmUpdSw(cr);
+            v[i] = OmGetXc(cr, 2);
+        }
+        OmSave(cr, sv);
+        for (i=0; i < 200; ++i) OmUpdSw(cr);
+        vf = OmGetXc(cr, 2);                /* settled switch voltage */
+        OmRestore(cr, sv);
+        e = fabs(v[5] - vf) / fabs(v[4] - vf);
+        printf("%s %s: ysw %.4le, error %.4lf, measured %.4lf\n", nm,
+            s ? "closed" : "open  ", cr->vecTg[1], OmSwErr(cr, 2), e);
+    }
+}
+
+int main() {
+    OmCir* ca = Pulse(0.6569, 0.2929 / 1000);   /* rule of thumb */
+    OmCir* cb = Pulse(0.0, 0.0);                /* tuned at stamp */
+    Check("rule ", ca);
+    Check("tuned", cb);
+    printf("OmUpdSw() for 1e-6: rule %d, tuned %d\n",
+        (int)ceil(log(1e-6) / log(OmSwErr(ca, 2))),
+        (int)ceil(log(1e-6) / log(OmSwErr(cb, 2))));
+    OmDelete(ca);
+    OmDelete(cb);
+    return 0;
+}
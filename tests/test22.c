@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 22 - Detect crossings and dv/dt of sine driven RC by event engine */
+
+int main() {
+    const char* nm[5] = {"", "UP", "DN", "", "DV"};
+    OmFlt w = 2 * 3.14159265358979 * 50, h = 1e-4, ph = 0.3, x, z, e = 0.0;
+    OmInt i, j, d;
+    OmCir* cr = OmCreate(2, 3, 2, h);
+    OmEvt* ev;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* stiff source */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 1e-6);
+    OmBran(cr, 2, 1, 2, OMTYP_Y0);          /* 1k resistor */
+    OmAddY(cr, 2, 1e-3);
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);          /* 1uF capacitor */
+    OmAddC(cr, 3, 1e-6, 0);
+    OmMetV(cr, 1, 1, 0);
+    OmMetV(cr, 2, 2, 0);
+    OmStamp(cr);
+    ev = OmEvtNew(cr, 4);
+    d = 1000 * OmEvtAdd(ev, OMEVT_XM, 1, 0.0, 0.0, OMEVT_UP | OMEVT_DN, 0.0);
+    d += 100 * OmEvtAdd(ev, OMEVT_XM, 2, 0.5, 0.6, OMEVT_UP | OMEVT_DN, 0.0);
+    d += 10 * OmEvtAdd(ev, OMEVT_XM, 1, 0.0, 0.0, OMEVT_DV, 1e3);
+    printf("add: %d, bad branch / hysteresis: %d %d\n", (int)d,
+        (int)OmEvtAdd(ev, OMEVT_XC, 4, 0.0, 0.0, OMEVT_UP, 0.0),
+        (int)OmEvtAdd(ev, OMEVT_XM, 1, 0.0, -1.0, OMEVT_UP, 0.0));
+    for (i=0; i < 400; ++i) {               /* Xm is 0.0 before step 1 */
+        x = sin(w * (i + 1) * h + ph);
+        OmSetQs(cr, 1, x + (i >= 250 && i < 280 ? 0.5 : 0.0));
+        OmUpdCr(cr);
+        OmUpdMt(cr);
+        OmEvtRun(ev);
+        for (j=0; j < ev->numF; ++j) {
+            d = ev->vecFd[j];
+            printf("t = %8.5lf ms  detector %d %s", ev->vecFa[j] * 1e3,
+                (int)d, nm[ev->vecFt[j]]);
+            if (d == 1 && (i < 250 || i >= 290)) {
+                z = floor((w * ev->vecFa[j] + ph) / 3.14159265358979 + 0.5);
+                z = (z * 3.14159265358979 - ph) / w;
+                printf("  error %.2le s", ev->vecFa[j] - z);
+                if (fabs(ev->vecFa[j] - z) > e) e = fabs(ev->vecFa[j] - z);
+            }
+            printf("\n");
+        }
+    }
+    printf("passes %d, max crossing error %.2le s (step %.0le s)\n",
+        (int)ev->numS, e, h);
+    OmEvtDel(ev);
+    OmDelete(cr);
+    return 0;
+}
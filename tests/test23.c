@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#define LIBOHM_BK MyBk                  /* registered at compile time */
+#include "libohm.h"
+
+/* Test 23 - Route stamping and stepping of RC ladder to a user backend */
+
+static int nLuf, nGmm, nGmv;
+
+static OmInt MyLuf(OmInt m, OmFlt* a, OmInt* pm) {
+    OmInt i, j, k, p;                       /* getrf: partial pivoting */
+    OmFlt t;
+    ++nLuf;
+    for (k=0; k < m; ++k) {
+        for (p=k, i=k+1; i < m; ++i)
+            if (fabs(a[i*m+k]) > fabs(a[p*m+k])) p = i;
+        pm[k] = p;
+        if (a[p*m+k] == 0.0) return 1;
+        for (j=0; j < m; ++j) {
+            t = a[k*m+j]; a[k*m+j] = a[p*m+j]; a[p*m+j] = t;
+        }
+        for (i=k+1; i < m; ++i) {
+            a[i*m+k] /= a[k*m+k];
+            for (j=k+1; j < m; ++j) a[i*m+j] -= a[i*m+k] * a[k*m+j];
+        }
+    }
+    return 0;
+}
+
+static void MyLus(OmInt m, OmInt n, OmFlt* lu, OmInt* pm, OmFlt* b) {
+    OmInt i, j, k;                          /* getrs: swap, L, U */
+    OmFlt t;
+    for (k=0; k < m; ++k) {
+        for (j=0; j < n; ++j) {
+            t = b[k*n+j]; b[k*n+j] = b[pm[k]*n+j]; b[pm[k]*n+j] = t;
+        }
+    }
+    for (i=1; i < m; ++i)
+        for (k=0; k < i; ++k)
+            for (j=0; j < n; ++j) b[i*n+j] -= lu[i*m+k] * b[k*n+j];
+    for (i=m-1; i >= 0; --i) {
+        for (k=i+1; k < m; ++k)
+            for (j=0; j < n; ++j) b[i*n+j] -= lu[i*m+k] * b[k*n+j];
+        for (j=0; j < n; ++j) b[i*n+j] /= lu[i*m+i];
+    }
+}
+
+static void MyGmm(OmInt m, OmInt n, OmInt k, OmFlt* c, OmFlt* a, OmFlt* b) {
+    OmInt i, j, l;
+    ++nGmm;
+    for (i=0; i < m; ++i) {
+        for (j=0; j < n; ++j) {
+            c[i*n+j] = 0.0;
+            for (l=0; l < k; ++l) c[i*n+j] += a[i*k+l] * b[l*n+j];
+        }
+    }
+}
+
+static void MyGmv(OmInt m, OmInt n, OmFlt* y, OmFlt* a, OmFlt* x) {
+    OmInt i, j;
+    ++nGmv;
+    for (i=0; i < m; ++i) {
+        y[i] = 0.0;
+        for (j=0; j < n; ++j) y[i] += a[i*n+j] * x[j];
+    }
+}
+
+OmBk MyBk = {8, MyLuf, MyLus, MyGmm, MyGmv};
+
+static OmCir* Ladder(OmInt ns) {
+    OmCir* cr = OmCreate(ns + 1, 2 * ns + 1, 1, 1e-5);
+    OmInt i;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with 10 ohm */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 10);
+    for (i=1; i <= ns; ++i) {
+        OmBran(cr, 2 * i, i, i + 1, OMTYP_Y0);
+        OmAddY(cr, 2 * i, 1e-2);
+        OmBran(cr, 2 * i + 1, i + 1, 0, OMTYP_Y2);
+        OmAddC(cr, 2 * i + 1, 1e-6, 0);
+    }
+    OmMetV(cr, 1, ns + 1, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static OmFlt Run(OmInt ns, OmFlt* xm) {
+    OmCir* cr = Ladder(ns);
+    OmFlt e = 0.0;
+    OmInt i;
+    for (i=0; i < 200; ++i) {
+        OmSetQs(cr, 1, 1.0);
+        OmUpdCr(cr);
+        OmUpdMt(cr);
+        if (xm[i] != 0.0 && fabs(OmGetMt(cr, 1) - xm[i]) > e)
+            e = fabs(OmGetMt(cr, 1) - xm[i]);
+        xm[i] = OmGetMt(cr, 1);
+    }
+    OmDelete(cr);
+    return e;
+}
+
+int main() {
+    OmFlt xm[200] = {0.0}, e;
+    Run(20, xm);
+    printf("compile time backend: luf %d, gemm %d, gemv %d, v = %.6lf\n",
+        nLuf, nGmm, nGmv, xm[199]);
+    OmSetBk(NULL);
+    nLuf = nGmm = nGmv = 0;
+    e = Run(20, xm);
+    printf("built-in: luf %d, gemm %d, gemv %d, max diff %.1le\n",
+        nLuf, nGmm, nGmv, e);
+    MyBk.minM = 1000;
+    OmSetBk(&MyBk);
+    e = Run(20, xm);
+    printf("minM = 1000: luf %d, gemm %d, gemv %d, max diff %.1le\n",
+        nLuf, nGmm, nGmv, e);
+    MyBk.minM = 8;                          /* matLuf without matLus */
+    MyBk.matLus = NULL;
+    nLuf = nGmm = nGmv = 0;
+    e = Run(20, xm);
+    printf("no matLus: luf %d, gemm %d, gemv %d, max diff %.1le\n",
+        nLuf, nGmm, nGmv, e);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#define LIBOHM_PTHREAD
+#include "libohm.h"
+
+/* Test 24 - Parareal on switched RC ladder against the serial run */
+
+#define NS 2000                             /* steps per slice */
+#define NP 8                                /* slices */
+#define NT 4                                /* threads */
+
+static OmCir* Ladder(void) {
+    OmCir* cr = OmCreate(5, 9, 1, 1e-5);
+    OmInt i;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with 10 ohm */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 10);
+    OmBran(cr, 2, 1, 2, OMTYP_SW);          /* switch into the ladder */
+    OmAddS(cr, 2, 1.0, 0.6569, 1.0, 0);
+    for (i=2; i <= 4; ++i) {
+        OmBran(cr, 2 * i - 1, i, i + 1, OMTYP_Y0);
+        OmAddY(cr, 2 * i - 1, 1e-2);
+        OmBran(cr, 2 * i, i + 1, 0, OMTYP_Y2);
+        OmAddC(cr, 2 * i, 1e-5, 0);
+    }
+    OmBran(cr, 9, 2, 0, OMTYP_Y2);
+    OmAddC(cr, 9, 1e-5, 0);
+    OmMetV(cr, 1, 5, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static void Sched(OmCir* cr, OmInt k, void* usr) {
+    OmSetQs(cr, 1, sin(2 * 3.14159265358979 * 50 * k * 1e-5));
+    OmSetSw(cr, 2, (k / 3000) % 2 == 0);    /* 30 ms on, 30 ms off */
+    (void)usr;
+}
+
+int main() {
+    OmCir* crs[NT];
+    OmCir* sr = Ladder();
+    OmFlt u[(NP + 1) * 16], e, x;
+    OmInt i, k, it, c = sr->numC;
+    for (k=0; k < NP * NS; ++k) {           /* serial reference */
+        Sched(sr, k, NULL);
+        OmUpdCr(sr);
+    }
+    OmUpdMt(sr);
+    printf("serial: %d slices of %d steps, c = %d, v = %.9lf\n",
+        NP, NS, (int)c, OmGetMt(sr, 1));
+    for (it=1; it <= 4; ++it) {
+        for (i=0; i < NT; ++i) crs[i] = Ladder();
+        k = OmParareal(crs, NT, NP, NS, Sched, NULL, 1e-12, it, u);
+        OmUpdMt(crs[0]);
+        e = 0.0;
+        for (i=0; i < c; ++i) {
+            x = fabs(u[NP * c + i] - sr->vecQa[i]);
+            if (x > e) e = x;
+        }
+        printf("itm %d: return %d, v = %.9lf, max |Qa - serial| %.1le\n",
+            (int)it, (int)k, OmGetMt(crs[0], 1), e);
+        for (i=0; i < NT; ++i) OmDelete(crs[i]);
+    }
+    for (i=0; i < NT; ++i) crs[i] = Ladder();
+    k = OmParareal(crs, NT, NP, NS, Sched, NULL, 0.0, NP, u);
+    e = 0.0;
+    for (i=0; i < c; ++i) {
+        x = fabs(u[NP * c + i] - sr->vecQa[i]);
+        if (x > e) e = x;
+    }
+    printf("tol 0: %d iterations (np - 1), max |Qa - serial| %.1le\n",
+        (int)k, e);
+    for (i=0; i < NT; ++i) OmDelete(crs[i]);
+    for (i=0; i < NT; ++i) crs[i] = Ladder();
+    k = OmParareal(crs, NT, NP, NS, Sched, NULL, 1e-9, 20, NULL);
+    OmUpdMt(crs[0]);
+    printf("tol 1e-9: %d iterations, v = %.9lf\n", (int)k,
+        OmGetMt(crs[0], 1));
+    for (i=0; i < NT; ++i) OmDelete(crs[i]);
+    OmDelete(sr);
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#define LIBOHM_MATH
+#include "libohm.h"
+
+/* Test 25 - Rate modes of RLC with parasitic and advise the time step */
+
+static OmCir* Rlc(OmFlt stp, OmInt tm, OmInt tc) {
+    OmCir* cr = OmCreate(2, 4, 1, stp);
+    OmBran(cr, 1, 1, 0, tm > 0 ? OMTYP_X2 : -OMTYP_X2);
+    OmAddV(cr, 1, 0);                       /* source, 10 ohm, 1 mH */
+    OmAddX(cr, 1, 10);
+    OmAddL(cr, 1, 1e-3, 0);
+    OmBran(cr, 2, 1, 0, tc > 0 ? OMTYP_Y2 : -OMTYP_Y2);
+    OmAddC(cr, 2, 1e-5, 0);                 /* 10 uF */
+    OmBran(cr, 3, 1, 2, OMTYP_X0);
+    OmAddX(cr, 3, 1);                       /* parasitic 1 ohm, 1 nF */
+    OmBran(cr, 4, 2, 0, tc > 0 ? OMTYP_Y2 : -OMTYP_Y2);
+    OmAddC(cr, 4, 1e-9, 0);
+    OmMetV(cr, 1, 1, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static void Show(OmCir* cr, OmFlt tol, OmFlt wb) {
+    OmFlt wr[8], wi[8], hs;
+    OmInt fl[8], i, d;
+    d = OmStepAdv(cr, -1, tol, wb, &hs, wr, wi, fl);
+    printf("h = %.3le, tol %.0le, band %.0le: %d modes, advised %.3le\n",
+        cr->timStp, tol, wb, (int)d, hs);
+    for (i=0; i < d; ++i) {
+        printf("  s = %11.4le %+11.4le j  %s%s%s\n", wr[i], wi[i],
+            fl[i] & OMADV_UNS ? "UNS " : "", fl[i] & OMADV_OSC ? "OSC " : "",
+            fl[i] & OMADV_ERR ? "ERR" : "");
+    }
+}
+
+int main() {
+    OmCir* cr;
+    OmFlt hs;
+    printf("RLC alone: s = -5.0000e+03 +/- 8.6603e+03 j, RC: -1e+09\n");
+    cr = Rlc(1e-5, 1, 1);
+    Show(cr, 1e-4, 1e6);
+    Show(cr, 1e-4, 0.0);
+    OmStepAdv(cr, -1, 1e-4, 1e6, &hs, NULL, NULL, NULL);
+    OmDelete(cr);
+    cr = Rlc(hs, 1, 1);
+    Show(cr, 1e-4, 1e6);
+    OmDelete(cr);
+    cr = Rlc(1e-5, -1, -1);
+    Show(cr, 1e-4, 1e6);
+    OmDelete(cr);
+    cr = Rlc(1e-5, 1, -1);                  /* TR inductor, BE capacitors */
+    printf("mixed TR / BE, z is given in place of s:\n");
+    Show(cr, 1e-4, 1e6);
+    OmDelete(cr);
+    return 0;
+}
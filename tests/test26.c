@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 26 - Run transformer and RC network dense, sparse and by blocks */
+
+static OmCir* Net(void) {
+    const OmFlt LP = 100, LS = 25;          /* inductances of test 5 */
+    OmCir* cr = OmCreate(3, 6, 3, 5e-6);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 0.1);
+    OmBran(cr, 2, 1, 0, OMTYP_X3);
+    OmAddL(cr, 2, LP, 0);
+    OmAddM(cr, 2, 3, sqrt(LP * LS), 0);
+    OmBran(cr, 3, 2, 0, OMTYP_X3);
+    OmAddL(cr, 3, LS, 0);
+    OmAddM(cr, 3, 2, sqrt(LP * LS), 0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y1);
+    OmAddY(cr, 4, 1e-3);
+    OmBran(cr, 5, 3, 0, OMTYP_X1);          /* separate RC block */
+    OmAddV(cr, 5, 0);
+    OmAddX(cr, 5, 1e3);
+    OmBran(cr, 6, 3, 0, OMTYP_Y2);
+    OmAddC(cr, 6, 1e-6, 0);
+    OmMetV(cr, 1, 1, 0);
+    OmMetA(cr, 2, 3);
+    OmMetV(cr, 3, 3, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static void Step(OmCir* cr, OmInt i, OmInt bk) {
+    OmInt k;
+    OmSetQs(cr, 1, 100 * sin(2 * 3.14159265358979 * 50 * i * 5e-6));
+    OmSetQs(cr, 5, (i / 1000) % 2 ? 1.0 : 0.0);
+    if (bk) {
+        for (k=1; k <= cr->numK; ++k) OmUpdBk(cr, k);
+    } else {
+        OmUpdCr(cr);
+    }
+    OmUpdMt(cr);
+}
+
+static OmFlt Diff(OmCir* a, OmCir* b) {    /* Qa by branch and meters */
+    OmFlt e = 0.0, x;
+    OmInt i;
+    for (i=0; i < a->numB; ++i) {
+        if (a->vecLut[i] < 0) continue;
+        x = fabs(a->vecQa[a->vecLut[i]] - b->vecQa[b->vecLut[i]]);
+        if (x > e) e = x;
+    }
+    for (i=1; i <= a->numM; ++i) {
+        x = fabs(OmGetMt(a, i) - OmGetMt(b, i));
+        if (x > e) e = x;
+    }
+    return e;
+}
+
+int main() {
+    OmCir* cd = Net();
+    OmCir* cs = Net();
+    OmCir* cb = Net();
+    OmFlt e1 = 0.0, e2 = 0.0, e3 = 0.0, x;
+    OmInt i;
+    OmSparse(cs, 0.0);
+    OmSparse(cb, 0.0);
+    printf("blocks %d, sparse %s\n", (int)cs->numK,
+        cs->vecCp != NULL ? "on" : "off");
+    for (i=0; i < 4000; ++i) {
+        Step(cd, i, 0);
+        Step(cs, i, 0);
+        Step(cb, i, 1);
+        if ((x = Diff(cd, cs)) > e1) e1 = x;
+        if ((x = Diff(cd, cb)) > e2) e2 = x;
+    }
+    OmSparse(cs, -1.0);                     /* back to dense matC / matD */
+    printf("dropped sparse %s\n", cs->vecCp == NULL ? "yes" : "no");
+    for (; i < 8000; ++i) {
+        Step(cd, i, 0);
+        Step(cs, i, 0);
+        if ((x = Diff(cd, cs)) > e3) e3 = x;
+    }
+    printf("max diff: sparse %.1le, blocks %.1le, dense again %.1le\n",
+        e1, e2, e3);
+    printf("%s\n", e1 < 1e-9 && e2 < 1e-9 && e3 < 1e-9 ? "pass" : "FAIL");
+    OmDelete(cd);
+    OmDelete(cs);
+    OmDelete(cb);
+    return 0;
+}
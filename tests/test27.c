@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <string.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 27 - Re-stamp LC filter over a parameter sweep with cached analysis */
+
+static OmCir* Top(void) {
+    OmCir* cr = OmCreate(3, 6, 2, 1e-5);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source */
+    OmBran(cr, 2, 1, 2, OMTYP_X3);          /* first inductor */
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);          /* capacitor */
+    OmBran(cr, 4, 2, 3, OMTYP_X3);          /* second inductor */
+    OmBran(cr, 5, 3, 0, OMTYP_Y1);          /* load */
+    OmBran(cr, 6, 3, 0, OMTYP_Y1);          /* bleeder */
+    OmMetV(cr, 1, 3, 0);
+    OmMetA(cr, 2, 4);
+    return cr;
+}
+
+static void Val(OmCir* cr, OmFlt p, OmFlt g, OmInt mc) {
+    OmAddV(cr, 1, 10);
+    OmAddX(cr, 1, 0.1 * p);
+    OmAddL(cr, 2, 1e-3 * p, 0);
+    OmAddX(cr, 2, 0.05);
+    OmAddC(cr, 3, 1e-5 / p, 0);
+    OmAddL(cr, 4, 5e-4, 0);
+    OmAddY(cr, 5, 0.1 * p);
+    OmAddY(cr, 6, g);
+    if (mc) {                               /* new coupling, new nonzeros */
+        OmAddM(cr, 2, 4, 2e-4, 0);
+        OmAddM(cr, 4, 2, 2e-4, 0);
+    }
+}
+
+static OmInt Same(OmCir* a, OmCir* b) {     /* bitwise, matrices and run */
+    OmInt c = a->numC, m = a->numM, i, s;
+    s = a->numC == b->numC
+     && !memcmp(a->matC, b->matC, c * c * sizeof(OmFlt))
+     && !memcmp(a->matD, b->matD, m * c * sizeof(OmFlt))
+     && !memcmp(a->vecW1c, b->vecW1c, c * sizeof(OmFlt))
+     && !memcmp(a->vecW2c, b->vecW2c, c * sizeof(OmFlt));
+    for (i=0; s && i < 300; ++i) {
+        OmUpdCr(a); OmUpdMt(a);
+        OmUpdCr(b); OmUpdMt(b);
+        s = !memcmp(a->vecXm, b->vecXm, m * sizeof(OmFlt));
+    }
+    return s;
+}
+
+static OmInt Cmp(OmSym* sy, OmFlt p, OmFlt g, OmInt mc, OmInt* fb) {
+    OmCir* fr = Top();
+    OmInt s;
+    OmClear(sy->cir);
+    Val(sy->cir, p, g, mc);
+    *fb = OmRestamp(sy);
+    Val(fr, p, g, mc);
+    OmStamp(fr);
+    s = Same(sy->cir, fr);
+    OmDelete(fr);
+    return s;
+}
+
+int main() {
+    OmCir* cr = Top();
+    OmSym* sy;
+    OmInt k, s, fb, ns = 0, nf = 0;
+    Val(cr, 1.0, 1e-3, 0);
+    sy = OmSymNew(cr);
+    for (k=0; k < 20; ++k) {                /* sweep, pattern unchanged */
+        s = Cmp(sy, 0.5 + 0.1 * k, 1e-3, 0, &fb);
+        ns += s;
+        nf += fb;
+    }
+    printf("sweep: %d of 20 equal, %d fallbacks\n", (int)ns, (int)nf);
+    s = Cmp(sy, 1.0, 1e-3, 1, &fb);
+    printf("new coupling: fallback %d, equal %d\n", (int)fb, (int)s);
+    s = Cmp(sy, 1.0, 1e-3, 0, &fb);
+    printf("coupling removed: fallback %d, equal %d\n", (int)fb, (int)s);
+    s = Cmp(sy, 1.0, 1e+9, 0, &fb);
+    printf("stiff bleeder: fallback %d, equal %d\n", (int)fb, (int)s);
+    printf("total fallbacks %d\n", (int)sy->numF);
+    OmSymDel(sy);
+    OmDelete(cr);
+    return 0;
+}
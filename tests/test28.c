@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 28 - Periodic steady state of square-wave driven RL and RC */
+
+#define NP 200                              /* steps per period */
+
+static OmCir* Build(void) {
+    OmCir* cr = OmCreate(3, 5, 2, 1e-5);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* square-wave source */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 1);
+    OmBran(cr, 2, 1, 2, OMTYP_X2);          /* RL */
+    OmAddL(cr, 2, 0.1, 0);
+    OmAddX(cr, 2, 1);
+    OmBran(cr, 3, 2, 0, OMTYP_Y1);          /* load, memoryless row */
+    OmAddY(cr, 3, 0.1);
+    OmBran(cr, 4, 2, 3, OMTYP_X1);          /* RC */
+    OmAddX(cr, 4, 20);
+    OmBran(cr, 5, 3, 0, OMTYP_Y2);
+    OmAddC(cr, 5, 5e-4, 0);
+    OmMetA(cr, 1, 2);
+    OmMetV(cr, 2, 3, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static void Sq(OmCir* cr, OmInt k, void* usr) {
+    OmSetQs(cr, 1, k < NP / 4 ? 10.0 : -2.0);
+    (void)usr;
+}
+
+int main() {
+    OmCir* st = Build();
+    OmCir* bf = Build();
+    OmInt i, k, ns = 0, it, ok;
+    OmFlt e = 0.0, x;
+    it = OmSteady(st, NP, Sq, NULL, 1e-12, 5);
+    for (i=0; i < st->numC; ++i) {
+        ns += st->vecW1m[i] != 0.0 || st->vecW2m[i] != 0.0;
+    }
+    printf("Newton iterations %d, state rows %d of %d\n",
+        (int)it, (int)ns, (int)st->numC);
+    for (i=0; i < 400 * NP; ++i) {          /* brute force, 400 periods */
+        Sq(bf, i % NP, NULL);
+        OmUpdCr(bf);
+    }
+    for (i=0; i < st->numC; ++i) {
+        x = fabs(st->vecQa[i] - bf->vecQa[i]);
+        if (x > e) e = x;
+    }
+    printf("period start Qa: max diff %.1le\n", e);
+    ok = e < 1e-9;
+    e = 0.0;
+    for (k=0; k < NP; ++k) {                /* one more period, meters */
+        Sq(st, k, NULL); OmUpdCr(st); OmUpdMt(st);
+        Sq(bf, k, NULL); OmUpdCr(bf); OmUpdMt(bf);
+        x = fabs(OmGetMt(st, 1) - OmGetMt(bf, 1))
+          + fabs(OmGetMt(st, 2) - OmGetMt(bf, 2));
+        if (x > e) e = x;
+        if (k % 50 == 0) {
+            printf("I=%lf, V=%lf\n", OmGetMt(st, 1), OmGetMt(st, 2));
+        }
+    }
+    printf("meters over one period: max diff %.1le\n", e);
+    printf("%s\n", it >= 0 && ok && e < 1e-9 ? "pass" : "FAIL");
+    OmDelete(st);
+    OmDelete(bf);
+    return 0;
+}
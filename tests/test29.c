@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 29 - DC initialization of RLC network and of a singular one */
+
+int main() {
+    OmCir* ok = OmCreate(2, 4, 2, 1e-5);
+    OmCir* sg = OmCreate(2, 3, 1, 1e-5);
+    OmFlt sv[3][8], d = 0.0;
+    OmInt i, r, c;
+    /* Good one: 12 V behind 2 ohm, RL to node 2, RC and load at node 2 */
+    OmBran(ok, 1, 1, 0, OMTYP_X1);
+    OmAddV(ok, 1, 12);
+    OmAddX(ok, 1, 2);
+    OmBran(ok, 2, 1, 2, OMTYP_X2);
+    OmAddL(ok, 2, 1e-2, 0);
+    OmAddX(ok, 2, 1);
+    OmBran(ok, 3, 2, 0, OMTYP_Y2);
+    OmAddC(ok, 3, 1e-4, 0);
+    OmBran(ok, 4, 2, 0, OMTYP_Y1);
+    OmAddY(ok, 4, 1.0 / 3);
+    OmMetV(ok, 1, 2, 0);
+    OmMetA(ok, 2, 2);
+    OmStamp(ok);
+    r = OmInitDC(ok);
+    for (i=0; i < 1000; ++i) {              /* must stay at equilibrium */
+        OmUpdCr(ok);
+        OmUpdMt(ok);
+        d += fabs(OmGetMt(ok, 1) - 6.0) + fabs(OmGetMt(ok, 2) - 2.0);
+    }
+    printf("good: OmInitDC %d, V=%lf, I=%lf, drift %.1le\n", (int)r,
+        OmGetMt(ok, 1), OmGetMt(ok, 2), d / 1000);
+    /* Singular one: current source charges C, L-R branch to second C */
+    OmBran(sg, 1, 1, 0, OMTYP_Y2);
+    OmAddC(sg, 1, 1e-4, 0);
+    OmAddI(sg, 1, 1);
+    OmBran(sg, 2, 1, 2, OMTYP_X2);
+    OmAddL(sg, 2, 1e-2, 0);
+    OmAddX(sg, 2, 1);
+    OmBran(sg, 3, 2, 0, OMTYP_Y2);
+    OmAddC(sg, 3, 1e-4, 0);
+    OmMetV(sg, 1, 2, 0);
+    OmStamp(sg);
+    for (i=0; i < 10; ++i) OmUpdCr(sg);    /* some non-zero state */
+    c = sg->numC;
+    memcpy(sv[0], sg->vecQa, c * sizeof(OmFlt));
+    memcpy(sv[1], sg->vecQtp, c * sizeof(OmFlt));
+    memcpy(sv[2], sg->vecXc, c * sizeof(OmFlt));
+    r = OmInitDC(sg);
+    printf("singular: OmInitDC %d, state %s\n", (int)r,
+        !memcmp(sv[0], sg->vecQa, c * sizeof(OmFlt))
+        && !memcmp(sv[1], sg->vecQtp, c * sizeof(OmFlt))
+        && !memcmp(sv[2], sg->vecXc, c * sizeof(OmFlt))
+        ? "unchanged" : "CHANGED");
+    OmDelete(ok);
+    OmDelete(sg);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 30 - Save, restore and switch inside the step on RC charger */
+
+#define TAU 1e-3                            /* R = 1k, C = 1u */
+
+static OmCir* Rc(OmInt bd) {
+    OmCir* cr = OmCreate(2, 3, 1, 1e-6);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with 1k resistance */
+    OmAddV(cr, 1, 10);
+    OmAddX(cr, 1, 1000);
+    OmBran(cr, 2, 1, 2, OMTYP_SW);          /* switch, tuned at stamp */
+    OmAddS(cr, 2, 1.0, 0.0, 0.0, 0.0);
+    OmBran(cr, 3, 2, 0, bd ? OMTYP_Y2 + OMMTD_BD2 : OMTYP_Y2);
+    OmAddC(cr, 3, 1e-6, 0.0);
+    OmMetV(cr, 1, 2, 0);
+    OmStamp(cr);
+    return cr;
+}
+
+static void Run(OmCir* cr, OmInt n, OmFlt* xm, OmFlt* ws) {
+    OmInt i;
+    for (i=0; i < n; ++i) {                 /* open/close inside steps */
+        if (i % 40 == 13) {
+            OmUpdEv(cr, 2, (i / 40) % 2 == 0, 0.25, 8, ws);
+        } else {
+            OmUpdCr(cr);
+        }
+        OmUpdMt(cr);
+        xm[i] = OmGetMt(cr, 1);
+    }
+}
+
+static void Replay(const char* nm, OmInt bd) {
+    OmCir* cr = Rc(bd);
+    OmFlt sv[64], ws[64], x1[400], x2[400];
+    OmFlt* sn;
+    Run(cr, 100, x1, ws);
+    OmSave(cr, sv);
+    sn = cr->vecQb;
+    Run(cr, 400, x1, ws);
+    OmRestore(cr, sv);
+    Run(cr, 400, x2, ws);
+    printf("%s: snapshot %d, Qb %s, rerun %s\n", nm, (int)OmSnpSz(cr),
+        sn != NULL ? "saved" : "none",
+        memcmp(x1, x2, sizeof(x1)) ? "DIFFERENT" : "bitwise equal");
+    OmDelete(cr);
+}
+
+static OmFlt Place(OmFlt a) {               /* close at step 100 + a */
+    OmCir* cr = Rc(0);
+    OmFlt ws[64], v;
+    OmInt i;
+    for (i=0; i < 300; ++i) {
+        if (i == 100 && a > 0.0) {
+            OmUpdEv(cr, 2, 1, a, 8, ws);
+            continue;
+        }
+        if (i == 100) {                     /* at step boundary */
+            OmSetSw(cr, 2, 1);
+            OmUpdSw(cr); OmUpdSw(cr); OmUpdSw(cr); OmUpdSw(cr);
+            OmUpdSw(cr); OmUpdSw(cr); OmUpdSw(cr); OmUpdSw(cr);
+        }
+        OmUpdCr(cr);
+    }
+    OmUpdMt(cr);
+    v = OmGetMt(cr, 1);                     /* v = 10 (1 - exp(-t / TAU)) */
+    OmDelete(cr);
+    return 300 - TAU / 1e-6 * log(10 / (10 - v));
+}
+
+int main() {
+    OmFlt a, t0, e = 0.0;
+    Replay("trapezoidal", 0);
+    Replay("bdf2       ", 1);
+    t0 = Place(0.0);                        /* instant seen from the curve */
+    for (a=0.125; a < 1.0; a += 0.25) {
+        printf("event at +%.3lf step: seen at +%.4lf\n", a, Place(a) - t0);
+        if (fabs(Place(a) - t0 - a) > e) e = fabs(Place(a) - t0 - a);
+    }
+    printf("placement error %.1le step\n", e);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 31 - Half-wave diode and thyristor rectifiers with auto switches */
+
+#define NC 2000                             /* steps per 50 Hz cycle */
+
+static OmCir* Rect(OmInt th) {
+    OmCir* cr = OmCreate(2, 4, 2, 1e-5);
+    OmBran(cr, 1, 1, 0, OMTYP_X1);          /* source with 1 ohm */
+    OmAddV(cr, 1, 0);
+    OmAddX(cr, 1, 1);
+    OmBran(cr, 2, 1, 2, OMTYP_SW);          /* diode / thyristor */
+    OmAddS(cr, 2, 1.0, 0.0, 0.0, 0.0);     /* tuned at stamp */
+    if (th) OmAddT(cr, 2, 0.7, 1e-3);
+    else OmAddD(cr, 2, 0.7, 1e-3);
+    OmAddY(cr, 2, 1e-6);                    /* snubber, after the rule */
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);          /* filter capacitor */
+    OmAddC(cr, 3, th ? 1e-7 : 1e-3, 0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y1);          /* load */
+    OmAddY(cr, 4, 0.01);
+    OmMetV(cr, 1, 2, 0);
+    OmMetA(cr, 2, 4);
+    OmStamp(cr);
+    return cr;
+}
+
+static void Run(const char* nm, OmInt th) {
+    OmCir* cr = Rect(th);
+    OmFlt xc[8], d, dm = 0.0;
+    OmInt i, j, n, nt = 0, nl = 0;
+    for (i=0; i < 5 * NC; ++i) {
+        OmSetQs(cr, 1, 100 * sin(2 * 3.14159265358979 * i / NC));
+        if (th) OmSetGt(cr, 2, i % NC >= NC / 4 && i % NC < NC / 2);
+        OmUpdCr(cr);
+        n = OmUpdCm(cr, 8);
+        if (n > 0) {                        /* next update, rel. to 100 V */
+            memcpy(xc, cr->vecXc, cr->numC * sizeof(OmFlt));
+            OmUpdSw(cr);
+            for (j=0; j < cr->numC; ++j) {
+                d = fabs(cr->vecXc[j] - xc[j]) / 100;
+                if (d > dm) dm = d;
+            }
+        }
+        nt += n;
+        if (i >= 4 * NC) nl += n;
+        OmUpdMt(cr);
+    }
+    printf("%s: g %.6lf, changes %d (last cycle %d), settle %.1le, "
+        "V=%.3lf\n", nm, cr->vecAg[0], (int)nt, (int)nl, dm,
+        OmGetMt(cr, 1));
+    OmDelete(cr);
+}
+
+int main() {
+    Run("diode    ", 0);
+    Run("thyristor", 1);
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#define LIBOHM_C
+#include "libohm.h"
+
+/* Test 7 - Emit specialized C code of switch pulse circuit and check it */
+
+static const char* DRV =
+    "#include <stdio.h>\n"
+    "#include \"test7g.c\"\n"
+    "int main(void) {\n"
+    "    PulseState s;\n"
+    "    int i;\n"
+    "    PulseReset(&s);\n"
+    "    for (i=0; i < 4000; ++i) {\n"
+    "        PulseSetSw(&s, 2, (i / 500) % 2 == 0);\n"
+    "        PulseUpdSw(&s);\n"
+    "        PulseUpdCr(&s);\n"
+    "        PulseUpdMt(&s);\n"
+    "        if (i % 500 == 499) printf(\"%.17g\\n\", s.xm[0]);\n"
+    "    }\n"
+    "    return 0;\n"
+    "}\n";
+
+/* add "k*s->qt[j] + ..." terms of emitted row starting at q into r */
+static void Terms(const char* q, OmFlt* r) {
+    double k, sg;
+    char* e;
+    while (*q != ';') {
+        sg = 1.0;
+        while (*q == ' ' || *q == '\n' || *q == '+' || *q == '-') {
+            if (*q++ == '-') sg = -sg;
+        }
+        if (strncmp(q, "0.0;", 4) == 0) return;     /* empty row */
+        k = 1.0;
+        if (*q != 's') {
+            k = strtod(q, &e);
+            q = e + 1;                              /* skip '*' */
+        }
+        q += strlen("s->qt[");
+        r[strtol(q, &e, 10)] += sg * k;
+        q = strchr(q, ']') + 1;
+    }
+}
+
+/* max difference of emitted rows "s->nm[i] = ..." in fn to a [n, c] */
+static OmFlt Rows(const char* t, const char* fn, const char* nm,
+                  OmFlt* a, OmInt n, OmInt c) {
+    OmFlt r[8], e = 0.0;
+    char key[32];
+    int i, j;
+    t = strstr(t, fn);
+    for (i=0; i < n; ++i) {
+        for (j=0; j < c; ++j) r[j] = 0.0;
+        sprintf(key, "s->%s[%d] = ", nm, i);
+        Terms(strstr(t, key) + strlen(key), r);
+        for (j=0; j < c; ++j) {
+            if (fabs(r[j] - a[i*c+j]) > e) e = fabs(r[j] - a[i*c+j]);
+        }
+    }
+    return e;
+}
+
+int main() {
+    const OmFlt VG = 100;                   /* input voltage */
+    const OmFlt R = 1000;                   /* load resistance */
+    const OmFlt CF = 1e-6;                  /* filter capacitance */
+    const OmFlt K1 = 1.0;                   /* closed state coefficient */
+    const OmFlt K2 = 0.6569;                /* open state coefficient */
+    const OmFlt YS = 0.2929 / 1000;         /* switch conductance */
+    FILE* p = fopen("test7g.c", "w");
+    OmCir* cr = OmCreate(2, 4, 1, 1e-6);
+    OmFlt xm[8], x, e = 0.0;
+    OmFlt w[4];
+    char ln[64];
+    char* t = (char*)malloc(65536);
+    const char* q;
+    int i, n = 0;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);
+    OmAddV(cr, 1, VG);
+    OmAddX(cr, 1, R);
+    OmBran(cr, 2, 1, 2, OMTYP_SW);
+    OmAddS(cr, 2, K1, K2, YS, 0.0);
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);
+    OmAddC(cr, 3, CF, 0.0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y0);
+    OmAddY(cr, 4, 1.0/R);
+    OmMetV(cr, 1, 2, 0);
+    OmStamp(cr);
+    OmEmitC(cr, p, "Pulse");
+    fclose(p);
+    printf("numC=%d, generated test7g.c\n", (int)cr->numC);
+    p = fopen("test7g.c", "r");             /* check emitted tables */
+    t[fread(t, 1, 65535, p)] = '\0';
+    fclose(p);
+    printf("matC vs UpdCr: %.1le, matD vs UpdMt: %.1le\n",
+        Rows(t, "void PulseUpdCr(", "xc", cr->matC, cr->numC, cr->numC),
+        Rows(t, "void PulseUpdMt(", "xm", cr->matD, cr->numM, cr->numC));
+    w[0] = cr->vecW1c[1]; w[1] = cr->vecW2c[1];
+    w[2] = cr->vecW1o[1]; w[3] = cr->vecW2o[1];
+    q = strstr(t, "PulseW1c[1] = {");
+    for (i=0, e=0.0; i < 4; ++i) {
+        q = strchr(q, '{') + 1;
+        if (fabs(strtod(q, NULL) - w[i]) > e) e = fabs(strtod(q, NULL) - w[i]);
+    }
+    printf("switch tables vs W1c/W2c/W1o/W2o: %.1le\n", e);
+    e = 0.0;
+    for (i=0; i < 4000; ++i) {              /* reference run */
+        OmSetSw(cr, 2, (i / 500) % 2 == 0);
+        OmUpdSw(cr);
+        OmUpdCr(cr);
+        OmUpdMt(cr);
+        if (i % 500 == 499) xm[i / 500] = OmGetMt(cr, 1);
+    }
+    p = fopen("test7d.c", "w");
+    fputs(DRV, p);
+    fclose(p);
+    if (system("cc -std=c89 -pedantic -o test7g test7d.c"
+               " && ./test7g > test7g.txt") != 0) {
+        printf("generated code not checked (no C compiler)\n");
+    } else {
+        p = fopen("test7g.txt", "r");
+        while (n < 8 && fscanf(p, "%lf", &x) == 1) {
+            if (fabs(x - xm[n]) > e) e = fabs(x - xm[n]);
+            ++n;
+        }
+        fclose(p);
+        printf("generated code: %d readings, max diff to OmUpdCr() %.1le\n",
+            n, e);
+    }
+    p = fopen("test7n.c", "w");
+    cr->matC[0] = HUGE_VAL;                 /* non-finite coefficient */
+    OmEmitC(cr, p, "Bad");
+    fclose(p);
+    p = fopen("test7n.c", "r");
+    printf("non-finite: %s", fgets(ln, sizeof(ln), p));
+    fclose(p);
+    OmDelete(cr);
+    free(t);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+#define LIBOHM_C
+#define LIBOHM_FIX
+#include "libohm.h"
+
+/* Test 8 - Fixed-point runtime of switch pulse circuit vs double runtime */
+
+int main() {
+    const OmFlt VG = 100;                   /* input voltage */
+    const OmFlt R = 1000;                   /* load resistance */
+    const OmFlt CF = 1e-6;                  /* filter capacitance */
+    const OmFlt K1 = 1.0;                   /* closed state coefficient */
+    const OmFlt K2 = 0.6569;                /* open state coefficient */
+    const OmFlt YS = 0.2929 / 1000;         /* switch conductance */
+    const OmInt N = 20000;                  /* number of steps */
+    const OmInt P = 100;                    /* switching period in steps */
+    OmInt i, s, pass;
+    OmCir* cr = OmCreate(2, 4, 1, 1e-6);
+    OmFxp* fx;
+    OmBran(cr, 1, 1, 0, OMTYP_X1);
+    OmAddV(cr, 1, VG);
+    OmAddX(cr, 1, R);
+    OmBran(cr, 2, 1, 2, OMTYP_SW);
+    OmAddS(cr, 2, K1, K2, YS, 0.0);
+    OmBran(cr, 3, 2, 0, OMTYP_Y2);
+    OmAddC(cr, 3, CF, 0.0);
+    OmBran(cr, 4, 2, 0, OMTYP_Y0);
+    OmAddY(cr, 4, 1.0/R);
+    OmMetV(cr, 1, 2, 0);
+    OmStamp(cr);
+    fx = OmFxpNew(cr);
+    for (pass = 0; pass < 2; ++pass) {      /* pass 0: bound, pass 1: calibrated */
+        OmReset(cr);
+        for (i = 0; i < N; ++i) {
+            s = (i % P) < P / 2;
+            OmSetSw(cr, 2, s);
+            OmFxpSetSw(fx, 2, s);
+            OmUpdSw(cr);
+            OmFxpUpdSw(fx);
+            OmUpdCr(cr);
+            OmFxpUpdCr(fx);
+            OmUpdMt(cr);
+            OmFxpUpdMt(fx);
+            OmFxpCal(fx);
+            OmFxpCmp(fx);
+        }
+        printf("pass %d: Vout=%.6f (double %.6f), errXm=%.3e, sat=%d\n",
+            (int)pass, OmFxpGetMt(fx, 1), OmGetMt(cr, 1),
+            fx->errXm, (int)fx->numSat);
+        OmFxpBld(fx);
+    }
+    OmFxpDel(fx);
+    OmDelete(cr);
+    return 0;
+}
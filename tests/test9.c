@@ -0,0 +1,37 @@
+#include <stdio.h>
+#define LIBOHM_C
+#define LIBOHM_PTHREAD
+#include "libohm.h"
+
+/* Test 9 - Boost circuit equivalent model, parallel sweep of test 4 */
+
+static OmCir* Boost(OmInt pt, OmFlt* par, void* usr) {
+    const OmFlt RL = 1;                     /* inductor winding resistance */
+    const OmFlt R = 100;                    /* load resistance */
+    const OmFlt VG = 100;                   /* input voltage */
+    OmFlt D = par[0];                       /* duty cycle */
+    OmCir* cr = OmCreate(1, 2, 1, 5e-6);
+    (void)pt;
+    (void)usr;
+    OmBran(cr, 1, 0, 0, OMTYP_X1);
+    OmAddV(cr, 1, -VG);
+    OmAddX(cr, 1, RL);
+    OmAddE(cr, 1, 2, 1-D);
+    OmBran(cr, 2, 1, 0, OMTYP_Y0);
+    OmAddF(cr, 2, 1, D-1);
+    OmAddY(cr, 2, 1.0/R);
+    OmMetV(cr, 1, 1, 0);
+    return cr;                              /* stamped by OmSweep() */
+}
+
+int main() {
+    OmFlt par[101], res[101];
+    int i, nf;
+    for (i=0; i <= 100; ++i) par[i] = 0.01 * i;
+    nf = OmSweep(101, 1, par, 1, res, Boost, NULL, NULL, 4);
+    for (i=0; i <= 100; ++i) {
+        printf("D=%lf, V/Vg=%lf\n", par[i], res[i]/100);
+    }
+    printf("failed points: %d\n", nf);
+    return 0;
+}